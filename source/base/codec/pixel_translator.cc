@@ -19,10 +19,17 @@
 #include "base/codec/pixel_translator.h"
 
 #include "base/macros_magic.h"
+#include "base/codec/pixel_translator_avx2.h"
+#include "base/codec/pixel_translator_neon.h"
+#include "base/codec/pixel_translator_sse2.h"
 #include "build/build_config.h"
 
 #include <limits>
 
+#if defined(ARCH_CPU_X86_FAMILY)
+#include <libyuv/cpu_id.h>
+#endif // defined(ARCH_CPU_X86_FAMILY)
+
 namespace base {
 
 namespace {
@@ -212,12 +219,133 @@ private:
     DISALLOW_COPY_AND_ASSIGN(PixelTranslatorFrom8_16bppT);
 };
 
+using TranslateFunc = int (*)(const PixelFormat& source_format,
+                              const PixelFormat& target_format,
+                              const uint8_t* src, int src_stride,
+                              uint8_t* dst, int dst_stride,
+                              int width, int height);
+
+// Translates the pixels with vector instructions. The pixels at the end of the rows that do not
+// fill a whole block are translated by the generic translator.
+template<typename TargetT>
+class PixelTranslatorVectorT final : public PixelTranslator
+{
+public:
+    PixelTranslatorVectorT(const PixelFormat& source_format,
+                           const PixelFormat& target_format,
+                           TranslateFunc translate_func)
+        : source_format_(source_format),
+          target_format_(target_format),
+          translate_func_(translate_func),
+          partial_translator_(source_format, target_format)
+    {
+        // Nothing
+    }
+
+    ~PixelTranslatorVectorT() final = default;
+
+    void translate(const uint8_t* src, int src_stride,
+                   uint8_t* dst, int dst_stride,
+                   int width, int height) final
+    {
+        const int block_width = translate_func_(
+            source_format_, target_format_, src, src_stride, dst, dst_stride, width, height);
+
+        if (block_width < width)
+        {
+            partial_translator_.translate(src + block_width * sizeof(uint32_t), src_stride,
+                                          dst + block_width * sizeof(TargetT), dst_stride,
+                                          width - block_width, height);
+        }
+    }
+
+private:
+    PixelFormat source_format_;
+    PixelFormat target_format_;
+    TranslateFunc translate_func_;
+    PixelTranslatorT<uint32_t, TargetT> partial_translator_;
+
+    DISALLOW_COPY_AND_ASSIGN(PixelTranslatorVectorT);
+};
+
+//--------------------------------------------------------------------------------------------------
+// The vector translators support 32bpp sources with 8 bits per channel (ARGB, ABGR, etc) and
+// 16bpp or 8bpp targets.
+bool isVectorTranslationSupported(const PixelFormat& source_format,
+                                  const PixelFormat& target_format)
+{
+    if (source_format.bytesPerPixel() != 4)
+        return false;
+
+    if (source_format.redMax() != 255 || source_format.greenMax() != 255 ||
+        source_format.blueMax() != 255)
+    {
+        return false;
+    }
+
+    for (int shift : { source_format.redShift(), source_format.greenShift(),
+                       source_format.blueShift() })
+    {
+        if (shift % 8 != 0 || shift > 24)
+            return false;
+    }
+
+    return target_format.bytesPerPixel() == 2 || target_format.bytesPerPixel() == 1;
+}
+
+//--------------------------------------------------------------------------------------------------
+TranslateFunc translateFunction(int target_bytes_per_pixel)
+{
+#if defined(ARCH_CPU_X86_FAMILY)
+    if (libyuv::TestCpuFlag(libyuv::kCpuHasAVX2))
+    {
+        return (target_bytes_per_pixel == 2) ?
+            translate_32bpp_16bpp_AVX2 : translate_32bpp_8bpp_AVX2;
+    }
+
+    if (libyuv::TestCpuFlag(libyuv::kCpuHasSSE2))
+    {
+        return (target_bytes_per_pixel == 2) ?
+            translate_32bpp_16bpp_SSE2 : translate_32bpp_8bpp_SSE2;
+    }
+#elif defined(ARCH_CPU_ARM64)
+    return (target_bytes_per_pixel == 2) ?
+        translate_32bpp_16bpp_NEON : translate_32bpp_8bpp_NEON;
+#endif // defined(ARCH_CPU_*)
+
+    return nullptr;
+}
+
 } // namespace
 
 //--------------------------------------------------------------------------------------------------
 // static
 std::unique_ptr<PixelTranslator> PixelTranslator::create(
     const PixelFormat& source_format, const PixelFormat& target_format)
+{
+    if (isVectorTranslationSupported(source_format, target_format))
+    {
+        TranslateFunc translate_func = translateFunction(target_format.bytesPerPixel());
+        if (translate_func)
+        {
+            if (target_format.bytesPerPixel() == 2)
+            {
+                return std::make_unique<PixelTranslatorVectorT<uint16_t>>(
+                    source_format, target_format, translate_func);
+            }
+
+            return std::make_unique<PixelTranslatorVectorT<uint8_t>>(
+                source_format, target_format, translate_func);
+        }
+    }
+
+    return createGeneric(source_format, target_format);
+}
+
+//--------------------------------------------------------------------------------------------------
+// static
+std::unique_ptr<PixelTranslator> PixelTranslator::createGeneric(
+    const PixelFormat& source_format, const PixelFormat& target_format)
 {
     switch (target_format.bytesPerPixel())
     {
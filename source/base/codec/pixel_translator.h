@@ -30,9 +30,15 @@ class PixelTranslator
 public:
     virtual ~PixelTranslator() = default;
 
+    // Creates a translator that uses vector instructions when the CPU and the pair of formats
+    // support it.
     static std::unique_ptr<PixelTranslator> create(const PixelFormat& source_format,
                                                    const PixelFormat& target_format);
 
+    // Creates a translator without vector instructions.
+    static std::unique_ptr<PixelTranslator> createGeneric(const PixelFormat& source_format,
+                                                          const PixelFormat& target_format);
+
     virtual void translate(const uint8_t* src,
                            int src_stride,
                            uint8_t* dst,
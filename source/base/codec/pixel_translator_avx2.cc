@@ -0,0 +1,153 @@
+//
+// Aspia Project
+// Copyright (C) 2016-2025 Dmitry Chapyshev <dmitry@aspia.ru>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "base/codec/pixel_translator_avx2.h"
+
+#include "base/desktop/pixel_format.h"
+
+#if defined(ARCH_CPU_X86_FAMILY)
+#if defined(CC_MSVC)
+#include <intrin.h>
+#else
+#include <immintrin.h>
+#endif // defined(CC_*)
+#endif // defined(ARCH_CPU_X86_FAMILY)
+
+namespace base {
+
+#if defined(ARCH_CPU_X86_FAMILY)
+
+namespace {
+
+struct Channel
+{
+    Channel(int source_shift, int target_max, int target_shift)
+        : source_shift(_mm_cvtsi32_si128(source_shift)),
+          target_max(_mm256_set1_epi16(static_cast<int16_t>(target_max))),
+          target_shift(_mm_cvtsi32_si128(target_shift))
+    {
+        // Nothing
+    }
+
+    const __m128i source_shift;
+    const __m256i target_max;
+    const __m128i target_shift;
+};
+
+//--------------------------------------------------------------------------------------------------
+// Translates one channel of 16 pixels to 16-bit values in the target format.
+inline __m256i translateChannel(__m256i pixels_lo, __m256i pixels_hi, const Channel& channel)
+{
+    const __m256i mask = _mm256_set1_epi32(0xFF);
+
+    // The pack works inside 128-bit lanes, the permutation restores the order of the pixels.
+    __m256i value = _mm256_packs_epi32(
+        _mm256_and_si256(_mm256_srl_epi32(pixels_lo, channel.source_shift), mask),
+        _mm256_and_si256(_mm256_srl_epi32(pixels_hi, channel.source_shift), mask));
+    value = _mm256_permute4x64_epi64(value, 0xD8);
+
+    // (value * target_max + 127) / 255, the same rounding as in the generic translator. The
+    // division by 255 is replaced by (x * 0x8081) >> 23, which is exact for 16-bit values.
+    value = _mm256_add_epi16(_mm256_mullo_epi16(value, channel.target_max),
+                             _mm256_set1_epi16(127));
+    value = _mm256_srli_epi16(
+        _mm256_mulhi_epu16(value, _mm256_set1_epi16(static_cast<int16_t>(0x8081))), 7);
+
+    return _mm256_sll_epi16(value, channel.target_shift);
+}
+
+//--------------------------------------------------------------------------------------------------
+inline __m256i translate16Pixels(const uint8_t* src, const Channel& red, const Channel& green,
+                                 const Channel& blue)
+{
+    const __m256i pixels_lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+    const __m256i pixels_hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 32));
+
+    return _mm256_or_si256(_mm256_or_si256(translateChannel(pixels_lo, pixels_hi, red),
+                                           translateChannel(pixels_lo, pixels_hi, green)),
+                           translateChannel(pixels_lo, pixels_hi, blue));
+}
+
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+int translate_32bpp_16bpp_AVX2(const PixelFormat& source_format,
+                               const PixelFormat& target_format,
+                               const uint8_t* src, int src_stride,
+                               uint8_t* dst, int dst_stride,
+                               int width, int height)
+{
+    const int block_width = width & ~15;
+
+    const Channel red(source_format.redShift(), target_format.redMax(), target_format.redShift());
+    const Channel green(
+        source_format.greenShift(), target_format.greenMax(), target_format.greenShift());
+    const Channel blue(
+        source_format.blueShift(), target_format.blueMax(), target_format.blueShift());
+
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < block_width; x += 16)
+        {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x * 2),
+                                translate16Pixels(src + x * 4, red, green, blue));
+        }
+
+        src += src_stride;
+        dst += dst_stride;
+    }
+
+    return block_width;
+}
+
+//--------------------------------------------------------------------------------------------------
+int translate_32bpp_8bpp_AVX2(const PixelFormat& source_format,
+                              const PixelFormat& target_format,
+                              const uint8_t* src, int src_stride,
+                              uint8_t* dst, int dst_stride,
+                              int width, int height)
+{
+    const int block_width = width & ~31;
+
+    const Channel red(source_format.redShift(), target_format.redMax(), target_format.redShift());
+    const Channel green(
+        source_format.greenShift(), target_format.greenMax(), target_format.greenShift());
+    const Channel blue(
+        source_format.blueShift(), target_format.blueMax(), target_format.blueShift());
+
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < block_width; x += 32)
+        {
+            const __m256i lo = translate16Pixels(src + x * 4, red, green, blue);
+            const __m256i hi = translate16Pixels(src + x * 4 + 64, red, green, blue);
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x),
+                                _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), 0xD8));
+        }
+
+        src += src_stride;
+        dst += dst_stride;
+    }
+
+    return block_width;
+}
+
+#endif // defined(ARCH_CPU_X86_FAMILY)
+
+} // namespace base
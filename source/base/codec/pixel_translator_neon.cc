@@ -0,0 +1,151 @@
+//
+// Aspia Project
+// Copyright (C) 2016-2025 Dmitry Chapyshev <dmitry@aspia.ru>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "base/codec/pixel_translator_neon.h"
+
+#include "base/desktop/pixel_format.h"
+
+#if defined(ARCH_CPU_ARM64)
+#include <arm_neon.h>
+#endif // defined(ARCH_CPU_ARM64)
+
+namespace base {
+
+#if defined(ARCH_CPU_ARM64)
+
+namespace {
+
+struct Channel
+{
+    Channel(int source_shift, int target_max, int target_shift)
+        : index(source_shift / 8),
+          target_max(vdup_n_u8(static_cast<uint8_t>(target_max))),
+          target_shift(vdupq_n_s16(static_cast<int16_t>(target_shift)))
+    {
+        // Nothing
+    }
+
+    // Index of the byte of the channel in the source pixel.
+    const int index;
+    const uint8x8_t target_max;
+    const int16x8_t target_shift;
+};
+
+//--------------------------------------------------------------------------------------------------
+// Translates one channel of 8 pixels to 16-bit values in the target format.
+inline uint16x8_t translateChannel(uint8x8_t value, const Channel& channel)
+{
+    // (value * target_max + 127) / 255, the same rounding as in the generic translator. The
+    // division by 255 is replaced by (x + 1 + (x >> 8)) >> 8, which is exact for 16-bit values.
+    uint16x8_t result = vmlal_u8(vdupq_n_u16(127), value, channel.target_max);
+    result = vshrq_n_u16(vaddq_u16(vaddq_u16(result, vshrq_n_u16(result, 8)), vdupq_n_u16(1)), 8);
+
+    return vshlq_u16(result, channel.target_shift);
+}
+
+//--------------------------------------------------------------------------------------------------
+inline void translate16Pixels(const uint8_t* src, const Channel& red, const Channel& green,
+                              const Channel& blue, uint16x8_t* lo, uint16x8_t* hi)
+{
+    // Splits the pixels into planes of bytes.
+    const uint8x16x4_t pixels = vld4q_u8(src);
+
+    const uint8x16_t red_plane = pixels.val[red.index];
+    const uint8x16_t green_plane = pixels.val[green.index];
+    const uint8x16_t blue_plane = pixels.val[blue.index];
+
+    *lo = vorrq_u16(vorrq_u16(translateChannel(vget_low_u8(red_plane), red),
+                              translateChannel(vget_low_u8(green_plane), green)),
+                    translateChannel(vget_low_u8(blue_plane), blue));
+    *hi = vorrq_u16(vorrq_u16(translateChannel(vget_high_u8(red_plane), red),
+                              translateChannel(vget_high_u8(green_plane), green)),
+                    translateChannel(vget_high_u8(blue_plane), blue));
+}
+
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+int translate_32bpp_16bpp_NEON(const PixelFormat& source_format,
+                               const PixelFormat& target_format,
+                               const uint8_t* src, int src_stride,
+                               uint8_t* dst, int dst_stride,
+                               int width, int height)
+{
+    const int block_width = width & ~15;
+
+    const Channel red(source_format.redShift(), target_format.redMax(), target_format.redShift());
+    const Channel green(
+        source_format.greenShift(), target_format.greenMax(), target_format.greenShift());
+    const Channel blue(
+        source_format.blueShift(), target_format.blueMax(), target_format.blueShift());
+
+    for (int y = 0; y < height; ++y)
+    {
+        uint16_t* dst_ptr = reinterpret_cast<uint16_t*>(dst);
+
+        for (int x = 0; x < block_width; x += 16)
+        {
+            uint16x8_t lo, hi;
+            translate16Pixels(src + x * 4, red, green, blue, &lo, &hi);
+
+            vst1q_u16(dst_ptr + x, lo);
+            vst1q_u16(dst_ptr + x + 8, hi);
+        }
+
+        src += src_stride;
+        dst += dst_stride;
+    }
+
+    return block_width;
+}
+
+//--------------------------------------------------------------------------------------------------
+int translate_32bpp_8bpp_NEON(const PixelFormat& source_format,
+                              const PixelFormat& target_format,
+                              const uint8_t* src, int src_stride,
+                              uint8_t* dst, int dst_stride,
+                              int width, int height)
+{
+    const int block_width = width & ~15;
+
+    const Channel red(source_format.redShift(), target_format.redMax(), target_format.redShift());
+    const Channel green(
+        source_format.greenShift(), target_format.greenMax(), target_format.greenShift());
+    const Channel blue(
+        source_format.blueShift(), target_format.blueMax(), target_format.blueShift());
+
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < block_width; x += 16)
+        {
+            uint16x8_t lo, hi;
+            translate16Pixels(src + x * 4, red, green, blue, &lo, &hi);
+
+            vst1q_u8(dst + x, vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)));
+        }
+
+        src += src_stride;
+        dst += dst_stride;
+    }
+
+    return block_width;
+}
+
+#endif // defined(ARCH_CPU_ARM64)
+
+} // namespace base
@@ -0,0 +1,51 @@
+//
+// Aspia Project
+// Copyright (C) 2016-2025 Dmitry Chapyshev <dmitry@aspia.ru>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef BASE_CODEC_PIXEL_TRANSLATOR_NEON_H
+#define BASE_CODEC_PIXEL_TRANSLATOR_NEON_H
+
+#include "build/build_config.h"
+
+#include <cstdint>
+
+namespace base {
+
+class PixelFormat;
+
+#if defined(ARCH_CPU_ARM64)
+
+// Translate the pixels of a 32bpp source with 8 bits per channel to 16bpp and 8bpp formats. Only
+// the leading part of each row that fills whole 16 pixel blocks is translated. Return the number
+// of translated pixels in each row.
+int translate_32bpp_16bpp_NEON(const PixelFormat& source_format,
+                               const PixelFormat& target_format,
+                               const uint8_t* src, int src_stride,
+                               uint8_t* dst, int dst_stride,
+                               int width, int height);
+
+int translate_32bpp_8bpp_NEON(const PixelFormat& source_format,
+                              const PixelFormat& target_format,
+                              const uint8_t* src, int src_stride,
+                              uint8_t* dst, int dst_stride,
+                              int width, int height);
+
+#endif // defined(ARCH_CPU_ARM64)
+
+} // namespace base
+
+#endif // BASE_CODEC_PIXEL_TRANSLATOR_NEON_H
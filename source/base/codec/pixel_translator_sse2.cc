@@ -0,0 +1,148 @@
+//
+// Aspia Project
+// Copyright (C) 2016-2025 Dmitry Chapyshev <dmitry@aspia.ru>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "base/codec/pixel_translator_sse2.h"
+
+#include "base/desktop/pixel_format.h"
+
+#if defined(ARCH_CPU_X86_FAMILY)
+#if defined(CC_MSVC)
+#include <intrin.h>
+#else
+#include <emmintrin.h>
+#endif // defined(CC_*)
+#endif // defined(ARCH_CPU_X86_FAMILY)
+
+namespace base {
+
+#if defined(ARCH_CPU_X86_FAMILY)
+
+namespace {
+
+struct Channel
+{
+    Channel(int source_shift, int target_max, int target_shift)
+        : source_shift(_mm_cvtsi32_si128(source_shift)),
+          target_max(_mm_set1_epi16(static_cast<int16_t>(target_max))),
+          target_shift(_mm_cvtsi32_si128(target_shift))
+    {
+        // Nothing
+    }
+
+    const __m128i source_shift;
+    const __m128i target_max;
+    const __m128i target_shift;
+};
+
+//--------------------------------------------------------------------------------------------------
+// Translates one channel of 8 pixels to 16-bit values in the target format.
+inline __m128i translateChannel(__m128i pixels_lo, __m128i pixels_hi, const Channel& channel)
+{
+    const __m128i mask = _mm_set1_epi32(0xFF);
+
+    __m128i value = _mm_packs_epi32(
+        _mm_and_si128(_mm_srl_epi32(pixels_lo, channel.source_shift), mask),
+        _mm_and_si128(_mm_srl_epi32(pixels_hi, channel.source_shift), mask));
+
+    // (value * target_max + 127) / 255, the same rounding as in the generic translator. The
+    // division by 255 is replaced by (x * 0x8081) >> 23, which is exact for 16-bit values.
+    value = _mm_add_epi16(_mm_mullo_epi16(value, channel.target_max), _mm_set1_epi16(127));
+    value = _mm_srli_epi16(_mm_mulhi_epu16(value, _mm_set1_epi16(static_cast<int16_t>(0x8081))), 7);
+
+    return _mm_sll_epi16(value, channel.target_shift);
+}
+
+//--------------------------------------------------------------------------------------------------
+inline __m128i translate8Pixels(const uint8_t* src, const Channel& red, const Channel& green,
+                                const Channel& blue)
+{
+    const __m128i pixels_lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    const __m128i pixels_hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+
+    return _mm_or_si128(_mm_or_si128(translateChannel(pixels_lo, pixels_hi, red),
+                                     translateChannel(pixels_lo, pixels_hi, green)),
+                        translateChannel(pixels_lo, pixels_hi, blue));
+}
+
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+int translate_32bpp_16bpp_SSE2(const PixelFormat& source_format,
+                               const PixelFormat& target_format,
+                               const uint8_t* src, int src_stride,
+                               uint8_t* dst, int dst_stride,
+                               int width, int height)
+{
+    const int block_width = width & ~7;
+
+    const Channel red(source_format.redShift(), target_format.redMax(), target_format.redShift());
+    const Channel green(
+        source_format.greenShift(), target_format.greenMax(), target_format.greenShift());
+    const Channel blue(
+        source_format.blueShift(), target_format.blueMax(), target_format.blueShift());
+
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < block_width; x += 8)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 2),
+                             translate8Pixels(src + x * 4, red, green, blue));
+        }
+
+        src += src_stride;
+        dst += dst_stride;
+    }
+
+    return block_width;
+}
+
+//--------------------------------------------------------------------------------------------------
+int translate_32bpp_8bpp_SSE2(const PixelFormat& source_format,
+                              const PixelFormat& target_format,
+                              const uint8_t* src, int src_stride,
+                              uint8_t* dst, int dst_stride,
+                              int width, int height)
+{
+    const int block_width = width & ~15;
+
+    const Channel red(source_format.redShift(), target_format.redMax(), target_format.redShift());
+    const Channel green(
+        source_format.greenShift(), target_format.greenMax(), target_format.greenShift());
+    const Channel blue(
+        source_format.blueShift(), target_format.blueMax(), target_format.blueShift());
+
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < block_width; x += 16)
+        {
+            const __m128i lo = translate8Pixels(src + x * 4, red, green, blue);
+            const __m128i hi = translate8Pixels(src + x * 4 + 32, red, green, blue);
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), _mm_packus_epi16(lo, hi));
+        }
+
+        src += src_stride;
+        dst += dst_stride;
+    }
+
+    return block_width;
+}
+
+#endif // defined(ARCH_CPU_X86_FAMILY)
+
+} // namespace base
@@ -0,0 +1,241 @@
+//
+// Aspia Project
+// Copyright (C) 2016-2025 Dmitry Chapyshev <dmitry@aspia.ru>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "base/codec/pixel_translator.h"
+#include "base/codec/pixel_translator_avx2.h"
+#include "base/codec/pixel_translator_neon.h"
+#include "base/codec/pixel_translator_sse2.h"
+
+#include <gtest/gtest.h>
+#include <libyuv/cpu_id.h>
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace base {
+
+namespace {
+
+using TranslateFunc = int (*)(const PixelFormat& source_format,
+                              const PixelFormat& target_format,
+                              const uint8_t* src, int src_stride,
+                              uint8_t* dst, int dst_stride,
+                              int width, int height);
+
+struct Kernel
+{
+    const char* name;
+    bool supported;
+    TranslateFunc translate_16bpp;
+    TranslateFunc translate_8bpp;
+};
+
+const int kHeight = 3;
+const int kStridePadding = 5;
+
+std::vector<Kernel> kernels()
+{
+    std::vector<Kernel> result;
+
+#if defined(ARCH_CPU_X86_FAMILY)
+    result.push_back({ "SSE2", libyuv::TestCpuFlag(libyuv::kCpuHasSSE2) != 0,
+                       translate_32bpp_16bpp_SSE2, translate_32bpp_8bpp_SSE2 });
+    result.push_back({ "AVX2", libyuv::TestCpuFlag(libyuv::kCpuHasAVX2) != 0,
+                       translate_32bpp_16bpp_AVX2, translate_32bpp_8bpp_AVX2 });
+#elif defined(ARCH_CPU_ARM64)
+    result.push_back({ "NEON", true, translate_32bpp_16bpp_NEON, translate_32bpp_8bpp_NEON });
+#endif // defined(ARCH_CPU_*)
+
+    return result;
+}
+
+std::vector<PixelFormat> sourceFormats()
+{
+    return { PixelFormat::ARGB(), PixelFormat(32, 255, 255, 255, 0, 8, 16) };
+}
+
+std::vector<PixelFormat> targetFormats()
+{
+    return { PixelFormat::RGB565(),
+             PixelFormat(16, 31, 31, 31, 10, 5, 0), // RGB555
+             PixelFormat::RGB332(),
+             PixelFormat::RGB222(),
+             PixelFormat::RGB111() };
+}
+
+std::vector<uint8_t> generateImage(int width, int height, int stride)
+{
+    std::vector<uint8_t> image(static_cast<size_t>(stride * height));
+    std::mt19937 engine(static_cast<std::mt19937::result_type>(width));
+
+    for (size_t i = 0; i < image.size(); ++i)
+        image[i] = static_cast<uint8_t>(engine());
+
+    return image;
+}
+
+std::vector<uint8_t> translateGeneric(const PixelFormat& source_format,
+                                      const PixelFormat& target_format,
+                                      const std::vector<uint8_t>& src, int src_stride,
+                                      int dst_stride, int width)
+{
+    std::vector<uint8_t> dst(static_cast<size_t>(dst_stride * kHeight));
+
+    PixelTranslator::createGeneric(source_format, target_format)->translate(
+        src.data(), src_stride, dst.data(), dst_stride, width, kHeight);
+
+    return dst;
+}
+
+} // namespace
+
+TEST(pixel_translator_test, vector_translator)
+{
+    for (const auto& source_format : sourceFormats())
+    {
+        for (const auto& target_format : targetFormats())
+        {
+            for (int width : { 1, 7, 8, 9, 15, 16, 17, 31, 32, 33, 63, 64, 65, 100, 1919 })
+            {
+                const int src_stride = width * source_format.bytesPerPixel() + kStridePadding;
+                const int dst_stride = width * target_format.bytesPerPixel() + kStridePadding;
+
+                std::vector<uint8_t> src = generateImage(width, kHeight, src_stride);
+                std::vector<uint8_t> expected = translateGeneric(
+                    source_format, target_format, src, src_stride, dst_stride, width);
+
+                std::vector<uint8_t> dst(expected.size());
+                PixelTranslator::create(source_format, target_format)->translate(
+                    src.data(), src_stride, dst.data(), dst_stride, width, kHeight);
+
+                EXPECT_EQ(expected, dst) << "width: " << width;
+            }
+        }
+    }
+}
+
+TEST(pixel_translator_test, kernels)
+{
+    for (const auto& kernel : kernels())
+    {
+        if (!kernel.supported)
+            continue;
+
+        for (const auto& source_format : sourceFormats())
+        {
+            for (const auto& target_format : targetFormats())
+            {
+                TranslateFunc translate_func = (target_format.bytesPerPixel() == 2) ?
+                    kernel.translate_16bpp : kernel.translate_8bpp;
+
+                for (int width : { 0, 15, 16, 32, 33, 96, 1920 })
+                {
+                    const int src_stride = width * source_format.bytesPerPixel() + kStridePadding;
+                    const int dst_stride = width * target_format.bytesPerPixel() + kStridePadding;
+
+                    std::vector<uint8_t> src = generateImage(width, kHeight, src_stride);
+                    std::vector<uint8_t> expected = translateGeneric(
+                        source_format, target_format, src, src_stride, dst_stride, width);
+
+                    std::vector<uint8_t> dst(expected.size());
+                    const int block_width = translate_func(source_format, target_format,
+                        src.data(), src_stride, dst.data(), dst_stride, width, kHeight);
+
+                    ASSERT_LE(block_width, width) << kernel.name;
+                    EXPECT_GT(block_width, width - 32) << kernel.name;
+
+                    // Only the translated part of the rows is compared.
+                    const size_t row_size =
+                        static_cast<size_t>(block_width * target_format.bytesPerPixel());
+
+                    for (int y = 0; y < kHeight; ++y)
+                    {
+                        const size_t offset = static_cast<size_t>(y * dst_stride);
+
+                        EXPECT_EQ(0, memcmp(expected.data() + offset, dst.data() + offset,
+                                            row_size))
+                            << kernel.name << " width: " << width << " row: " << y;
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(pixel_translator_test, DISABLED_benchmark)
+{
+    const int kWidth = 1920;
+    const int kFrameHeight = 1080;
+    const int kIterationCount = 100;
+
+    const PixelFormat source_format = PixelFormat::ARGB();
+    const int src_stride = kWidth * source_format.bytesPerPixel();
+
+    std::vector<uint8_t> src = generateImage(kWidth, kFrameHeight, src_stride);
+    std::vector<uint8_t> dst(static_cast<size_t>(kWidth * kFrameHeight * 2));
+
+    for (const auto& target_format : { PixelFormat::RGB565(), PixelFormat::RGB332() })
+    {
+        const int dst_stride = kWidth * target_format.bytesPerPixel();
+
+        std::unique_ptr<PixelTranslator> translator =
+            PixelTranslator::createGeneric(source_format, target_format);
+
+        auto start_time = std::chrono::steady_clock::now();
+
+        for (int i = 0; i < kIterationCount; ++i)
+        {
+            translator->translate(
+                src.data(), src_stride, dst.data(), dst_stride, kWidth, kFrameHeight);
+        }
+
+        auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start_time);
+
+        std::cout << static_cast<int>(target_format.bitsPerPixel()) << "bpp generic: "
+                  << duration.count() / kIterationCount << " ns/frame" << std::endl;
+
+        for (const auto& kernel : kernels())
+        {
+            if (!kernel.supported)
+                continue;
+
+            TranslateFunc translate_func = (target_format.bytesPerPixel() == 2) ?
+                kernel.translate_16bpp : kernel.translate_8bpp;
+
+            start_time = std::chrono::steady_clock::now();
+
+            for (int i = 0; i < kIterationCount; ++i)
+            {
+                translate_func(source_format, target_format,
+                               src.data(), src_stride, dst.data(), dst_stride,
+                               kWidth, kFrameHeight);
+            }
+
+            duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start_time);
+
+            std::cout << static_cast<int>(target_format.bitsPerPixel()) << "bpp " << kernel.name
+                      << ": " << duration.count() / kIterationCount << " ns/frame" << std::endl;
+        }
+    }
+}
+
+} // namespace base
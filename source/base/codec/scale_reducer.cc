@@ -19,7 +19,6 @@
 #include "base/codec/scale_reducer.h"
 
 #include "base/logging.h"
-#include "base/desktop/frame_simple.h"
 
 #include <libyuv/scale_argb.h>
 
@@ -75,7 +74,7 @@ const Frame* ScaleReducer::scaleFrame(const Frame* source_frame, const Size& tar
 
     if (!target_frame_)
     {
-        target_frame_ = FrameSimple::create(target_size, PixelFormat::ARGB());
+        target_frame_ = frame_pool_.create(target_size, PixelFormat::ARGB());
         if (!target_frame_)
         {
             LOG(LS_ERROR) << "Unable to create target frame";
@@ -20,14 +20,13 @@
 #define BASE_CODEC_SCALE_REDUCER_H
 
 #include "base/macros_magic.h"
+#include "base/desktop/frame_pool.h"
 #include "base/desktop/geometry.h"
 
 #include <memory>
 
 namespace base {
 
-class Frame;
-
 class ScaleReducer
 {
 public:
@@ -42,6 +41,8 @@ public:
 private:
     Rect scaledRect(const Rect& source_rect);
 
+    // When the target size changes, the memory of the previous target frame is reused.
+    FramePool frame_pool_;
     std::unique_ptr<Frame> target_frame_;
     Size source_size_;
     Size target_size_;
@@ -89,14 +89,59 @@ bool VideoDecoderZstd::decode(const proto::VideoPacket& packet, Frame* target_fr
         return false;
     }
 
-    size_t ret = ZSTD_initDStream(stream_.get());
+    size_t ret = ZSTD_DCtx_reset(stream_.get(), ZSTD_reset_session_only);
     if (ZSTD_isError(ret))
     {
-        LOG(LS_ERROR) << "ZSTD_initDStream failed: " << ZSTD_getErrorName(ret);
+        LOG(LS_ERROR) << "ZSTD_DCtx_reset failed: " << ZSTD_getErrorName(ret);
         return false;
     }
 
     Rect frame_rect = Rect::makeSize(source_frame_->size());
+
+    if (packet.video_features() & proto::VIDEO_FEATURE_ZSTD_REFERENCE)
+    {
+        // The encoder used the previous content of the dirty rectangles as a prefix. Build the same
+        // prefix before the content is overwritten.
+        const int bytes_per_pixel = source_frame_->format().bytesPerPixel();
+        size_t prefix_size = 0;
+
+        for (int i = 0; i < packet.dirty_rect_size(); ++i)
+        {
+            Rect rect = parseRect(packet.dirty_rect(i));
+
+            if (!frame_rect.containsRect(rect))
+            {
+                LOG(LS_ERROR) << "The rectangle is outside the screen area";
+                return false;
+            }
+
+            prefix_size += static_cast<size_t>(rect.width() * rect.height() * bytes_per_pixel);
+        }
+
+        prefix_buffer_.resize(prefix_size);
+        uint8_t* prefix_pos = prefix_buffer_.data();
+
+        for (int i = 0; i < packet.dirty_rect_size(); ++i)
+        {
+            Rect rect = parseRect(packet.dirty_rect(i));
+            const size_t row_size = static_cast<size_t>(rect.width() * bytes_per_pixel);
+            const uint8_t* row = source_frame_->frameDataAtPos(rect.topLeft());
+
+            for (int y = 0; y < rect.height(); ++y)
+            {
+                memcpy(prefix_pos, row, row_size);
+                prefix_pos += row_size;
+                row += source_frame_->stride();
+            }
+        }
+
+        ret = ZSTD_DCtx_refPrefix(stream_.get(), prefix_buffer_.data(), prefix_buffer_.size());
+        if (ZSTD_isError(ret))
+        {
+            LOG(LS_ERROR) << "ZSTD_DCtx_refPrefix failed: " << ZSTD_getErrorName(ret);
+            return false;
+        }
+    }
     ZSTD_inBuffer input = { packet.data().data(), packet.data().size(), 0 };
 
     for (int i = 0; i < packet.dirty_rect_size(); ++i)
@@ -22,6 +22,7 @@
 #include "base/macros_magic.h"
 #include "base/codec/scoped_zstd_stream.h"
 #include "base/codec/video_decoder.h"
+#include "base/memory/byte_array.h"
 
 namespace base {
 
@@ -42,6 +43,7 @@ private:
     ScopedZstdDStream stream_;
     std::unique_ptr<PixelTranslator> translator_;
     std::unique_ptr<Frame> source_frame_;
+    ByteArray prefix_buffer_;
 
     DISALLOW_COPY_AND_ASSIGN(VideoDecoderZstd);
 };
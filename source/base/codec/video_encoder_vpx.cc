@@ -32,6 +32,8 @@ namespace {
 
 const std::chrono::milliseconds kTargetFrameInterval{ 80 };
 
+const uint32_t kDefaultTargetBitrate = 1000;
+
 // Defines the dimension of a macro block. This is used to compute the active map for the encoder.
 const int kMacroBlockSize = 16;
 
@@ -107,16 +109,14 @@ void createImage(const Size& size,
     const int y_rows = ((image->h - 1) & ~(kMacroBlockSize - 1)) + kMacroBlockSize;
     const int uv_rows = y_rows >> image->y_chroma_shift;
 
-    ByteArray image_buffer;
-
-    // Allocate a YUV buffer large enough for the aligned data & padding.
-    image_buffer.resize(static_cast<size_t>(y_stride * y_rows + (2 * uv_stride) * uv_rows));
-
-    // Reset image value to 128 so we just need to fill in the y plane.
-    memset(image_buffer.data(), 128, image_buffer.size());
+    // Allocate a YUV buffer large enough for the aligned data & padding and reset image value to
+    // 128 so we just need to fill in the y plane. The memory of the previous buffer is reused and
+    // filled only once.
+    out_image_buffer->assign(
+        static_cast<size_t>(y_stride * y_rows + (2 * uv_stride) * uv_rows), 128);
 
     // Fill in the information.
-    image->planes[0] = image_buffer.data();
+    image->planes[0] = out_image_buffer->data();
     image->planes[1] = image->planes[0] + y_stride * y_rows;
     image->planes[2] = image->planes[1] + uv_stride * uv_rows;
 
@@ -124,7 +124,6 @@ void createImage(const Size& size,
     image->stride[1] = image->stride[2] = uv_stride;
 
     *out_image = std::move(image);
-    *out_image_buffer = std::move(image_buffer);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -146,6 +145,11 @@ Rect alignRect(const Rect& rect)
 
 } // namespace
 
+// static
+const uint32_t VideoEncoderVPX::kMinTargetBitrate = 100;
+// static
+const uint32_t VideoEncoderVPX::kMaxTargetBitrate = 100000;
+
 //--------------------------------------------------------------------------------------------------
 // static
 std::unique_ptr<VideoEncoderVPX> VideoEncoderVPX::createVP8()
@@ -162,7 +166,8 @@ std::unique_ptr<VideoEncoderVPX> VideoEncoderVPX::createVP9()
 
 //--------------------------------------------------------------------------------------------------
 VideoEncoderVPX::VideoEncoderVPX(proto::VideoEncoding encoding)
-    : VideoEncoder(encoding)
+    : VideoEncoder(encoding),
+      target_bitrate_(kDefaultTargetBitrate)
 {
     memset(&config_, 0, sizeof(config_));
     memset(&active_map_, 0, sizeof(active_map_));
@@ -286,28 +291,18 @@ bool VideoEncoderVPX::setMinQuantizer(uint32_t min_quantizer)
         return false;
     }
 
-    if (config_.rc_min_quantizer == min_quantizer)
-    {
-        LOG(LS_INFO) << "Quantizer value not changed";
+    if (min_quantizer_ == min_quantizer)
         return true;
-    }
 
+    min_quantizer_ = min_quantizer;
     config_.rc_min_quantizer = min_quantizer;
-
-    vpx_codec_err_t ret = vpx_codec_enc_config_set(codec_.get(), &config_);
-    if (ret != VPX_CODEC_OK)
-    {
-        LOG(LS_ERROR) << "vpx_codec_enc_config_set failed: " << ret;
-        return false;
-    }
-
-    return true;
+    return applyConfig();
 }
 
 //--------------------------------------------------------------------------------------------------
 uint32_t VideoEncoderVPX::minQuantizer() const
 {
-    return config_.rc_min_quantizer;
+    return min_quantizer_;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -319,28 +314,58 @@ bool VideoEncoderVPX::setMaxQuantizer(uint32_t max_quantizer)
         return false;
     }
 
-    if (config_.rc_max_quantizer == max_quantizer)
-    {
-        LOG(LS_INFO) << "Quantizer value not changed";
+    if (max_quantizer_ == max_quantizer)
         return true;
-    }
 
+    max_quantizer_ = max_quantizer;
     config_.rc_max_quantizer = max_quantizer;
+    return applyConfig();
+}
 
-    vpx_codec_err_t ret = vpx_codec_enc_config_set(codec_.get(), &config_);
-    if (ret != VPX_CODEC_OK)
+//--------------------------------------------------------------------------------------------------
+uint32_t VideoEncoderVPX::maxQuantizer() const
+{
+    return max_quantizer_;
+}
+
+//--------------------------------------------------------------------------------------------------
+bool VideoEncoderVPX::setTargetBitrate(uint32_t target_bitrate)
+{
+    if (target_bitrate < kMinTargetBitrate || target_bitrate > kMaxTargetBitrate)
     {
-        LOG(LS_ERROR) << "vpx_codec_enc_config_set failed: " << ret;
+        LOG(LS_ERROR) << "Invalid target bitrate: " << target_bitrate;
         return false;
     }
 
-    return true;
+    if (target_bitrate_ == target_bitrate)
+        return true;
+
+    target_bitrate_ = target_bitrate;
+    config_.rc_target_bitrate = target_bitrate;
+    return applyConfig();
 }
 
 //--------------------------------------------------------------------------------------------------
-uint32_t VideoEncoderVPX::maxQuantizer() const
+uint32_t VideoEncoderVPX::targetBitrate() const
+{
+    return target_bitrate_;
+}
+
+//--------------------------------------------------------------------------------------------------
+bool VideoEncoderVPX::applyConfig()
 {
-    return config_.rc_max_quantizer;
+    // If the codec is not created yet, the values will be applied when it is created.
+    if (!codec_)
+        return true;
+
+    vpx_codec_err_t ret = vpx_codec_enc_config_set(codec_.get(), &config_);
+    if (ret != VPX_CODEC_OK)
+    {
+        LOG(LS_ERROR) << "vpx_codec_enc_config_set failed: " << ret;
+        return false;
+    }
+
+    return true;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -380,12 +405,12 @@ bool VideoEncoderVPX::createVp8Codec(const Size& size)
 
     // To enable remoting to be highly interactive and allow the target bitrate to be met, we relax
     // the max quantizer. The quality will get topped-off in subsequent frames.
-    config_.rc_min_quantizer = 10;
-    config_.rc_max_quantizer = 30;
+    config_.rc_min_quantizer = min_quantizer_;
+    config_.rc_max_quantizer = max_quantizer_;
 
-    // In the absence of a good bandwidth estimator set the target bitrate to a
-    // conservative default.
-    config_.rc_target_bitrate = 1000;
+    // The target bitrate is set by the owner from the bandwidth estimate. Until then a
+    // conservative default is used.
+    config_.rc_target_bitrate = target_bitrate_;
 
     ret = vpx_codec_enc_init(codec_.get(), algo, &config_, 0);
     if (ret != VPX_CODEC_OK)
@@ -447,12 +472,12 @@ bool VideoEncoderVPX::createVp9Codec(const Size& size)
 
     // Configure VP9 for I420 source frames.
     config_.g_profile = kVp9I420ProfileNumber;
-    config_.rc_min_quantizer = 10;
-    config_.rc_max_quantizer = 30;
+    config_.rc_min_quantizer = min_quantizer_;
+    config_.rc_max_quantizer = max_quantizer_;
 
-    // In the absence of a good bandwidth estimator set the target bitrate to a
-    // conservative default.
-    config_.rc_target_bitrate = 1000;
+    // The target bitrate is set by the owner from the bandwidth estimate. Until then a
+    // conservative default is used.
+    config_.rc_target_bitrate = target_bitrate_;
 
     ret = vpx_codec_enc_init(codec_.get(), algo, &config_, 0);
     if (ret != VPX_CODEC_OK)
@@ -34,6 +34,10 @@ namespace base {
 class VideoEncoderVPX final : public VideoEncoder
 {
 public:
+    // Limits of the target bitrate in kilobits per second.
+    static const uint32_t kMinTargetBitrate;
+    static const uint32_t kMaxTargetBitrate;
+
     ~VideoEncoderVPX() final = default;
 
     static std::unique_ptr<VideoEncoderVPX> createVP8();
@@ -46,6 +50,10 @@ public:
     bool setMaxQuantizer(uint32_t max_quantizer);
     uint32_t maxQuantizer() const;
 
+    // Sets the target bitrate in kilobits per second.
+    bool setTargetBitrate(uint32_t target_bitrate);
+    uint32_t targetBitrate() const;
+
 private:
     explicit VideoEncoderVPX(proto::VideoEncoding encoding);
 
@@ -55,6 +63,11 @@ private:
     void prepareImageAndActiveMap(bool is_key_frame, const Frame* frame, proto::VideoPacket* packet);
     void addRectToActiveMap(const Rect& rect);
     void clearActiveMap();
+    bool applyConfig();
+
+    uint32_t min_quantizer_ = 10;
+    uint32_t max_quantizer_ = 30;
+    uint32_t target_bitrate_;
 
     vpx_codec_enc_cfg_t config_;
     ScopedVpxCodec codec_;
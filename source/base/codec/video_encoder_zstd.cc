@@ -20,12 +20,21 @@
 
 #include "base/logging.h"
 #include "base/codec/pixel_translator.h"
-#include "base/desktop/frame.h"
+#include "base/desktop/frame_aligned.h"
+
+#include <algorithm>
+#include <thread>
 
 namespace base {
 
 namespace {
 
+// Updates of this size or larger are compressed by several worker threads.
+const size_t kMultithreadThreshold = 2 * 1024 * 1024;
+
+// Maximum number of worker threads for one encoder.
+const int kMaxWorkers = 4;
+
 //--------------------------------------------------------------------------------------------------
 // Retrieves a pointer to the output buffer in |update| used for storing the
 // encoded rectangle data. Will resize the buffer to |size|.
@@ -68,7 +77,8 @@ VideoEncoderZstd::VideoEncoderZstd(const PixelFormat& target_format, int compres
     : VideoEncoder(proto::VIDEO_ENCODING_ZSTD),
       target_format_(target_format),
       compress_ratio_(compression_ratio),
-      stream_(ZSTD_createCStream())
+      stream_(ZSTD_createCStream()),
+      max_workers_(std::min(kMaxWorkers, static_cast<int>(std::thread::hardware_concurrency() / 2)))
 {
     // Nothing
 }
@@ -91,41 +101,110 @@ std::unique_ptr<VideoEncoderZstd> VideoEncoderZstd::create(
 }
 
 //--------------------------------------------------------------------------------------------------
-bool VideoEncoderZstd::compressPacket(
-    const uint8_t* input_data, size_t input_size, std::string* output_buffer)
+bool VideoEncoderZstd::compressPacket(const uint8_t* input_data, size_t input_size,
+                                      const uint8_t* prefix_data, size_t prefix_size,
+                                      std::string* output_buffer)
 {
-    size_t ret = ZSTD_initCStream(stream_.get(), compress_ratio_);
+    // The context is kept between packets. Only the session is reset, the parameters stay.
+    size_t ret = ZSTD_CCtx_reset(stream_.get(), ZSTD_reset_session_only);
     if (ZSTD_isError(ret))
     {
-        LOG(LS_ERROR) << "ZSTD_initCStream failed: " << ZSTD_getErrorName(ret);
+        LOG(LS_ERROR) << "ZSTD_CCtx_reset failed: " << ZSTD_getErrorName(ret);
         return false;
     }
 
+    ret = ZSTD_CCtx_setParameter(stream_.get(), ZSTD_c_compressionLevel, compress_ratio_);
+    if (ZSTD_isError(ret))
+    {
+        LOG(LS_ERROR) << "ZSTD_CCtx_setParameter failed: " << ZSTD_getErrorName(ret);
+        return false;
+    }
+
+    // Large updates are compressed by several worker threads.
+    const int workers = (input_size >= kMultithreadThreshold) ? max_workers_ : 0;
+    if (workers != workers_)
+    {
+        ret = ZSTD_CCtx_setParameter(stream_.get(), ZSTD_c_nbWorkers, workers);
+        if (ZSTD_isError(ret))
+        {
+            // The library is built without multithreading support.
+            LOG(LS_INFO) << "Unable to set number of workers: " << ZSTD_getErrorName(ret);
+            max_workers_ = 0;
+        }
+        else
+        {
+            workers_ = workers;
+        }
+    }
+
+    if (prefix_size)
+    {
+        ret = ZSTD_CCtx_refPrefix(stream_.get(), prefix_data, prefix_size);
+        if (ZSTD_isError(ret))
+        {
+            LOG(LS_ERROR) << "ZSTD_CCtx_refPrefix failed: " << ZSTD_getErrorName(ret);
+            return false;
+        }
+    }
+
     const size_t output_size = ZSTD_compressBound(input_size);
     uint8_t* output_data = outputBuffer(output_buffer, output_size);
 
     ZSTD_inBuffer input = { input_data, input_size, 0 };
     ZSTD_outBuffer output = { output_data, output_size, 0 };
 
-    while (input.pos < input.size)
+    do
     {
-        ret = ZSTD_compressStream(stream_.get(), &output, &input);
+        ret = ZSTD_compressStream2(stream_.get(), &output, &input, ZSTD_e_end);
         if (ZSTD_isError(ret))
         {
-            LOG(LS_ERROR) << "ZSTD_compressStream failed: " << ZSTD_getErrorName(ret);
+            LOG(LS_ERROR) << "ZSTD_compressStream2 failed: " << ZSTD_getErrorName(ret);
             return false;
         }
     }
+    while (ret != 0);
 
-    ret = ZSTD_endStream(stream_.get(), &output);
-    if (ZSTD_isError(ret))
+    output_buffer->resize(output.pos);
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+void VideoEncoderZstd::updateReference(bool use_reference, size_t data_size)
+{
+    if (use_reference)
     {
-        LOG(LS_ERROR) << "ZSTD_endStream failed: " << ZSTD_getErrorName(ret);
-        return false;
+        prefix_buffer_.resize(data_size);
+        uint8_t* prefix_pos = prefix_buffer_.data();
+
+        // The prefix is the previous content of the dirty rectangles in the same order as the new
+        // content.
+        for (Region::Iterator it(updated_region_); !it.isAtEnd(); it.advance())
+        {
+            const Rect& rect = it.rect();
+            const size_t row_size =
+                static_cast<size_t>(rect.width() * target_format_.bytesPerPixel());
+            const uint8_t* row = reference_frame_->frameDataAtPos(rect.topLeft());
+
+            for (int y = 0; y < rect.height(); ++y)
+            {
+                memcpy(prefix_pos, row, row_size);
+                prefix_pos += row_size;
+                row += reference_frame_->stride();
+            }
+        }
     }
 
-    output_buffer->resize(output.pos);
-    return true;
+    // Store the new content for the next packet.
+    const uint8_t* translate_pos = translate_buffer_.get();
+
+    for (Region::Iterator it(updated_region_); !it.isAtEnd(); it.advance())
+    {
+        const Rect& rect = it.rect();
+        const int stride = rect.width() * target_format_.bytesPerPixel();
+
+        reference_frame_->copyPixelsFrom(translate_pos, stride, rect);
+        translate_pos += rect.height() * stride;
+    }
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -133,6 +212,19 @@ bool VideoEncoderZstd::encode(const Frame* frame, proto::VideoPacket* packet)
 {
     fillPacketInfo(frame, packet);
 
+    if (reference_enabled_ && (!reference_frame_ || reference_frame_->size() != frame->size()))
+    {
+        reference_frame_ = FrameAligned::create(frame->size(), target_format_, 32);
+        if (!reference_frame_)
+        {
+            LOG(LS_ERROR) << "Unable to create reference frame";
+            return false;
+        }
+
+        // The whole reference frame has to be filled.
+        setKeyFrameRequired(true);
+    }
+
     if (packet->has_format())
     {
         LOG(LS_INFO) << "Has packet format";
@@ -199,15 +291,34 @@ bool VideoEncoderZstd::encode(const Frame* frame, proto::VideoPacket* packet)
         translate_pos += rect.height() * stride;
     }
 
+    // Key frames and packets with a new format are decoded without the previous content.
+    bool use_reference = false;
+
+    if (reference_enabled_)
+    {
+        use_reference = !packet->has_format() && !isKeyFrameRequired();
+        updateReference(use_reference, data_size);
+    }
+
     std::string* encode_buffer = encodeBuffer();
 
     // Compress data with using Zstd compressor.
-    if (!compressPacket(translate_buffer_.get(), data_size, encode_buffer))
+    if (!compressPacket(translate_buffer_.get(), data_size,
+                        use_reference ? prefix_buffer_.data() : nullptr,
+                        use_reference ? data_size : 0,
+                        encode_buffer))
     {
         LOG(LS_ERROR) << "compressPacket failed";
+
+        // The reference frame already contains the content that the decoder will not receive.
+        if (reference_enabled_)
+            setKeyFrameRequired(true);
         return false;
     }
 
+    if (use_reference)
+        packet->set_video_features(proto::VIDEO_FEATURE_ZSTD_REFERENCE);
+
     packet->set_data(std::move(*encode_buffer));
     setKeyFrameRequired(false);
 
@@ -233,4 +344,19 @@ int VideoEncoderZstd::compressRatio() const
     return compress_ratio_;
 }
 
+//--------------------------------------------------------------------------------------------------
+void VideoEncoderZstd::setReferenceEnabled(bool enable)
+{
+    if (reference_enabled_ == enable)
+        return;
+
+    LOG(LS_INFO) << "Reference prefix enabled: " << enable;
+
+    reference_enabled_ = enable;
+    reference_frame_.reset();
+
+    // The decoder does not have the previous content yet.
+    setKeyFrameRequired(true);
+}
+
 } // namespace base
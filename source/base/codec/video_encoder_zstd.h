@@ -21,6 +21,7 @@
 
 #include "base/macros_magic.h"
 #include "base/memory/aligned_memory.h"
+#include "base/memory/byte_array.h"
 #include "base/codec/scoped_zstd_stream.h"
 #include "base/codec/video_encoder.h"
 #include "base/desktop/region.h"
@@ -28,6 +29,7 @@
 
 namespace base {
 
+class Frame;
 class PixelTranslator;
 
 class VideoEncoderZstd final : public VideoEncoder
@@ -43,9 +45,17 @@ public:
     bool setCompressRatio(int compression_ratio);
     int compressRatio() const;
 
+    // Enables compression of the dirty rectangles with their previous content as a reference
+    // prefix. The decoder must support VIDEO_FEATURE_ZSTD_REFERENCE.
+    void setReferenceEnabled(bool enable);
+    bool isReferenceEnabled() const { return reference_enabled_; }
+
 private:
     VideoEncoderZstd(const PixelFormat& target_format, int compression_ratio);
-    bool compressPacket(const uint8_t* input_data, size_t input_size, std::string* output_buffer);
+    bool compressPacket(const uint8_t* input_data, size_t input_size,
+                        const uint8_t* prefix_data, size_t prefix_size,
+                        std::string* output_buffer);
+    void updateReference(bool use_reference, size_t data_size);
 
     Region updated_region_;
     PixelFormat target_format_;
@@ -55,6 +65,15 @@ private:
     std::unique_ptr<uint8_t[], base::AlignedFreeDeleter> translate_buffer_;
     size_t translate_buffer_size_ = 0;
 
+    // Number of worker threads for large updates and the number currently set in the context.
+    int max_workers_ = 0;
+    int workers_ = 0;
+
+    // Previous content of the screen in the target format and the reference prefix built from it.
+    bool reference_enabled_ = false;
+    std::unique_ptr<Frame> reference_frame_;
+    ByteArray prefix_buffer_;
+
     DISALLOW_COPY_AND_ASSIGN(VideoEncoderZstd);
 };
 
@@ -29,6 +29,46 @@
 
 namespace base {
 
+namespace {
+
+//--------------------------------------------------------------------------------------------------
+// Reads the frame type from the uncompressed header of a VP8 or VP9 frame.
+bool isKeyFrame(proto::VideoEncoding encoding, const std::string& data)
+{
+    if (data.empty())
+        return false;
+
+    const uint8_t header = static_cast<uint8_t>(data[0]);
+
+    if (encoding == proto::VIDEO_ENCODING_VP8)
+    {
+        // The lowest bit of the frame tag is 0 for key frames.
+        return (header & 0x01) == 0;
+    }
+
+    if (encoding == proto::VIDEO_ENCODING_VP9)
+    {
+        auto bit = [header](int index) { return (header >> (7 - index)) & 0x01; };
+
+        // Frame marker.
+        if ((header >> 6) != 0x02)
+            return false;
+
+        const int profile = (bit(3) << 1) | bit(2);
+        int index = (profile == 3) ? 5 : 4;
+
+        // A frame that shows an existing frame is not a key frame.
+        if (bit(index++))
+            return false;
+
+        return bit(index) == 0;
+    }
+
+    return false;
+}
+
+} // namespace
+
 //--------------------------------------------------------------------------------------------------
 WebmFileWriter::WebmFileWriter(const std::filesystem::path& path, std::u16string_view name)
     : path_(path),
@@ -120,6 +160,9 @@ void WebmFileWriter::addVideoPacket(const proto::VideoPacket& packet)
         timestamp = NanoSeconds(0);
     }
 
+    if (!is_key_frame)
+        is_key_frame = isKeyFrame(packet.encoding(), packet.data());
+
     muxer_->writeVideoFrame(packet.data(), timestamp, is_key_frame);
 }
 
@@ -87,7 +87,8 @@ WebmVideoEncoder::~WebmVideoEncoder()
 }
 
 //--------------------------------------------------------------------------------------------------
-bool WebmVideoEncoder::encode(const Frame& frame, proto::VideoPacket* packet)
+bool WebmVideoEncoder::encode(
+    const Frame& frame, const Region& dirty_region, proto::VideoPacket* packet)
 {
     DCHECK(packet);
 
@@ -117,13 +118,42 @@ bool WebmVideoEncoder::encode(const Frame& frame, proto::VideoPacket* packet)
     uint8_t* u_data = image_->planes[1];
     uint8_t* v_data = image_->planes[2];
 
-    libyuv::ARGBToI420(frame.frameData(),
-                       frame.stride(),
-                       y_data, y_stride,
-                       u_data, uv_stride,
-                       v_data, uv_stride,
-                       last_frame_size_.width(),
-                       last_frame_size_.height());
+    Region convert_region;
+
+    if (packet->has_format())
+    {
+        convert_region.addRect(Rect::makeSize(last_frame_size_));
+    }
+    else
+    {
+        const Rect frame_rect = Rect::makeSize(last_frame_size_);
+
+        // The chroma planes are subsampled by 2. The rectangles are aligned to even coordinates.
+        for (Region::Iterator it(dirty_region); !it.isAtEnd(); it.advance())
+        {
+            const Rect& rect = it.rect();
+            Rect aligned_rect = Rect::makeLTRB(rect.left() & ~1, rect.top() & ~1,
+                                               (rect.right() + 1) & ~1, (rect.bottom() + 1) & ~1);
+            aligned_rect.intersectWith(frame_rect);
+
+            if (!aligned_rect.isEmpty())
+                convert_region.addRect(aligned_rect);
+        }
+    }
+
+    for (Region::Iterator it(convert_region); !it.isAtEnd(); it.advance())
+    {
+        const Rect& rect = it.rect();
+        const int uv_offset = (rect.top() / 2) * uv_stride + (rect.left() / 2);
+
+        libyuv::ARGBToI420(frame.frameDataAtPos(rect.topLeft()),
+                           frame.stride(),
+                           y_data + rect.top() * y_stride + rect.left(), y_stride,
+                           u_data + uv_offset, uv_stride,
+                           v_data + uv_offset, uv_stride,
+                           rect.width(),
+                           rect.height());
+    }
 
     // Do the actual encoding.
     vpx_codec_err_t ret = vpx_codec_encode(
@@ -186,11 +216,10 @@ void WebmVideoEncoder::createImage()
     const int y_rows = ((static_cast<int>(image_->h) - 1) & ~(kMacroBlockSize - 1)) + kMacroBlockSize;
     const int uv_rows = y_rows >> image_->y_chroma_shift;
 
-    // Allocate a YUV buffer large enough for the aligned data & padding.
-    image_buffer_.resize(static_cast<size_t>(y_stride * y_rows + (2 * uv_stride) * uv_rows));
-
-    // Reset image value to 128 so we just need to fill in the y plane.
-    memset(image_buffer_.data(), 128, image_buffer_.size());
+    // Allocate a YUV buffer large enough for the aligned data & padding and reset image value to
+    // 128 so we just need to fill in the y plane.
+    image_buffer_.assign(
+        static_cast<size_t>(y_stride * y_rows + (2 * uv_stride) * uv_rows), 128);
 
     // Fill in the information.
     image_->planes[0] = image_buffer_.data();
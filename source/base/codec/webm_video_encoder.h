@@ -22,6 +22,7 @@
 #include "base/macros_magic.h"
 #include "base/codec/scoped_vpx_codec.h"
 #include "base/desktop/geometry.h"
+#include "base/desktop/region.h"
 #include "base/memory/byte_array.h"
 
 #define VPX_CODEC_DISABLE_COMPAT 1
@@ -42,7 +43,9 @@ public:
     WebmVideoEncoder();
     ~WebmVideoEncoder();
 
-    bool encode(const Frame& frame, proto::VideoPacket* packet);
+    // Encodes the frame. Only the pixels in |dirty_region| are converted, the rest of the image is
+    // kept from the previous frames. The whole frame is converted when its size changes.
+    bool encode(const Frame& frame, const Region& dirty_region, proto::VideoPacket* packet);
 
 private:
     void createImage();
@@ -84,6 +84,36 @@ bool CpuidUtil::hasAesNi()
     return BitSet<uint32_t>(CpuidUtil(1).ecx()).test(25);
 }
 
+//--------------------------------------------------------------------------------------------------
+// static
+bool CpuidUtil::hasAvx512f()
+{
+    // Check if function 7 is supported.
+    if (CpuidUtil(0).eax() < 7)
+        return false;
+
+    // Bit 27 of register ECX set to 1 indicates that the OS uses XSAVE/XRSTOR.
+    if (!BitSet<uint32_t>(CpuidUtil(1).ecx()).test(27))
+        return false;
+
+#if defined(CC_MSVC)
+    const uint64_t xcr0 = _xgetbv(0);
+#else
+    uint32_t xcr0_low = 0;
+    uint32_t xcr0_high = 0;
+    __asm__ volatile("xgetbv" : "=a"(xcr0_low), "=d"(xcr0_high) : "c"(0));
+    const uint64_t xcr0 = (static_cast<uint64_t>(xcr0_high) << 32) | xcr0_low;
+#endif
+
+    // The OS must save the SSE, AVX, opmask and upper ZMM registers.
+    const uint64_t kAvx512State = 0xE6;
+    if ((xcr0 & kAvx512State) != kAvx512State)
+        return false;
+
+    // Bit 16 of register EBX of function 7 set to 1 indicates the support of AVX-512F.
+    return BitSet<uint32_t>(CpuidUtil(7).ebx()).test(16);
+}
+
 } // namespace base
 
 #endif // defined(ARCH_CPU_X86_FAMILY)
@@ -49,6 +49,10 @@ public:
 
     static bool hasAesNi();
 
+    // Returns true if the processor and the operating system support AVX-512 Foundation
+    // instructions.
+    static bool hasAvx512f();
+
 private:
     uint32_t eax_ = 0;
     uint32_t ebx_ = 0;
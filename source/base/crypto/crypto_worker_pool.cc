@@ -0,0 +1,120 @@
+//
+// Aspia Project
+// Copyright (C) 2016-2025 Dmitry Chapyshev <dmitry@aspia.ru>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "base/crypto/crypto_worker_pool.h"
+
+#include "base/logging.h"
+#include "base/sys_info.h"
+#include "base/task_runner.h"
+
+#include <algorithm>
+
+namespace base {
+
+namespace {
+
+constexpr int kMaxDefaultThreadCount = 8;
+
+//--------------------------------------------------------------------------------------------------
+size_t defaultThreadCount()
+{
+    // One processor is left for the network thread.
+    return static_cast<size_t>(
+        std::clamp(SysInfo::processorThreads() - 1, 1, kMaxDefaultThreadCount));
+}
+
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+CryptoWorkerPool::CryptoWorkerPool(size_t thread_count)
+{
+    if (!thread_count)
+        thread_count = defaultThreadCount();
+
+    LOG(LS_INFO) << "Ctor (threads: " << thread_count << ")";
+
+    threads_.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i)
+        threads_.emplace_back(&CryptoWorkerPool::threadMain, this);
+}
+
+//--------------------------------------------------------------------------------------------------
+CryptoWorkerPool::~CryptoWorkerPool()
+{
+    LOG(LS_INFO) << "Dtor";
+
+    {
+        std::scoped_lock lock(lock_);
+        stopping_ = true;
+        queue_.clear();
+    }
+
+    event_.notify_all();
+
+    for (auto& thread : threads_)
+        thread.join();
+}
+
+//--------------------------------------------------------------------------------------------------
+void CryptoWorkerPool::postTaskAndReply(
+    Task task, std::shared_ptr<TaskRunner> reply_task_runner, Task reply)
+{
+    DCHECK(task);
+    DCHECK(reply_task_runner);
+
+    {
+        std::scoped_lock lock(lock_);
+        queue_.push_back({ std::move(task), std::move(reply_task_runner), std::move(reply) });
+    }
+
+    event_.notify_one();
+}
+
+//--------------------------------------------------------------------------------------------------
+size_t CryptoWorkerPool::pendingTasks() const
+{
+    std::scoped_lock lock(lock_);
+    return queue_.size();
+}
+
+//--------------------------------------------------------------------------------------------------
+void CryptoWorkerPool::threadMain()
+{
+    while (true)
+    {
+        PendingTask pending_task;
+
+        {
+            std::unique_lock lock(lock_);
+            event_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+
+            if (stopping_)
+                return;
+
+            pending_task = std::move(queue_.front());
+            queue_.pop_front();
+        }
+
+        pending_task.task();
+
+        if (pending_task.reply)
+            pending_task.reply_task_runner->postTask(std::move(pending_task.reply));
+    }
+}
+
+} // namespace base
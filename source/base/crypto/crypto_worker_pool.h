@@ -0,0 +1,83 @@
+//
+// Aspia Project
+// Copyright (C) 2016-2025 Dmitry Chapyshev <dmitry@aspia.ru>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef BASE_CRYPTO_CRYPTO_WORKER_POOL_H
+#define BASE_CRYPTO_CRYPTO_WORKER_POOL_H
+
+#include "base/macros_magic.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace base {
+
+class TaskRunner;
+
+// Runs CPU-heavy cryptographic operations (for example, SRP modular exponentiation) on a fixed
+// set of worker threads, so that they do not block the network thread. Tasks are taken from a
+// shared queue in the order in which they were posted.
+class CryptoWorkerPool
+{
+public:
+    // If |thread_count| is 0, the number of threads is selected from the number of processors.
+    explicit CryptoWorkerPool(size_t thread_count = 0);
+
+    // Waits for the running tasks. Tasks that have not been started yet are discarded and their
+    // replies are never posted.
+    ~CryptoWorkerPool();
+
+    using Task = std::function<void()>;
+
+    // Runs |task| on one of the worker threads. After the task completes, |reply| is posted to
+    // |reply_task_runner| (if |reply| is not empty). The task must not access objects owned by
+    // the reply thread.
+    void postTaskAndReply(Task task, std::shared_ptr<TaskRunner> reply_task_runner, Task reply);
+
+    size_t threadCount() const { return threads_.size(); }
+
+    // Returns the number of tasks waiting for a free worker thread.
+    size_t pendingTasks() const;
+
+private:
+    struct PendingTask
+    {
+        Task task;
+        std::shared_ptr<TaskRunner> reply_task_runner;
+        Task reply;
+    };
+
+    void threadMain();
+
+    std::vector<std::thread> threads_;
+
+    mutable std::mutex lock_;
+    std::condition_variable event_;
+    std::deque<PendingTask> queue_;
+    bool stopping_ = false;
+
+    DISALLOW_COPY_AND_ASSIGN(CryptoWorkerPool);
+};
+
+} // namespace base
+
+#endif // BASE_CRYPTO_CRYPTO_WORKER_POOL_H
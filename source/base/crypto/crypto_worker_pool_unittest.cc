@@ -0,0 +1,116 @@
+//
+// Aspia Project
+// Copyright (C) 2016-2025 Dmitry Chapyshev <dmitry@aspia.ru>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "base/crypto/crypto_worker_pool.h"
+
+#include "base/task_runner.h"
+#include "base/threading/thread.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <future>
+
+namespace base {
+
+TEST(crypto_worker_pool_test, task_and_reply)
+{
+    static const int kTaskCount = 100;
+
+    Thread reply_thread;
+    reply_thread.start(MessageLoop::Type::DEFAULT);
+
+    std::shared_ptr<TaskRunner> reply_task_runner = reply_thread.taskRunner();
+    ASSERT_TRUE(reply_task_runner);
+
+    CryptoWorkerPool pool(4);
+    EXPECT_EQ(pool.threadCount(), 4u);
+
+    std::atomic_int tasks_done = 0;
+    int replies_done = 0;
+    bool reply_thread_ok = true;
+    std::promise<void> finished;
+
+    for (int i = 0; i < kTaskCount; ++i)
+    {
+        pool.postTaskAndReply([&tasks_done, reply_task_runner]()
+        {
+            EXPECT_FALSE(reply_task_runner->belongsToCurrentThread());
+            ++tasks_done;
+        },
+        reply_task_runner,
+        [&]()
+        {
+            // Replies are counted only on the reply thread.
+            reply_thread_ok = reply_thread_ok && reply_task_runner->belongsToCurrentThread();
+
+            if (++replies_done == kTaskCount)
+                finished.set_value();
+        });
+    }
+
+    finished.get_future().wait();
+    reply_thread.stop();
+
+    EXPECT_EQ(tasks_done, kTaskCount);
+    EXPECT_EQ(replies_done, kTaskCount);
+    EXPECT_TRUE(reply_thread_ok);
+}
+
+TEST(crypto_worker_pool_test, destroy_with_pending_tasks)
+{
+    Thread reply_thread;
+    reply_thread.start(MessageLoop::Type::DEFAULT);
+
+    std::atomic_int tasks_done = 0;
+
+    {
+        CryptoWorkerPool pool(1);
+        std::promise<void> started;
+        std::promise<void> unblock;
+        std::shared_future<void> unblocked = unblock.get_future().share();
+
+        // The first task blocks the only worker thread, the rest stay in the queue.
+        pool.postTaskAndReply([&started, unblocked, &tasks_done]()
+        {
+            started.set_value();
+            unblocked.wait();
+            ++tasks_done;
+        },
+        reply_thread.taskRunner(), nullptr);
+
+        started.get_future().wait();
+
+        for (int i = 0; i < 10; ++i)
+        {
+            pool.postTaskAndReply(
+                [&tasks_done]() { ++tasks_done; }, reply_thread.taskRunner(), nullptr);
+        }
+
+        unblock.set_value();
+    }
+
+    reply_thread.stop();
+
+    // The running task is completed. Some of the queued tasks can be started before the pool
+    // is destroyed.
+    EXPECT_GE(tasks_done, 1);
+    EXPECT_LE(tasks_done, 11);
+}
+
+} // namespace base
@@ -0,0 +1,76 @@
+//
+// Aspia Project
+// Copyright (C) 2016-2025 Dmitry Chapyshev <dmitry@aspia.ru>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "base/desktop/diff_block_32bpp_avx512.h"
+
+#if defined(ARCH_CPU_X86_FAMILY)
+#if defined(CC_MSVC)
+#include <intrin.h>
+#else
+#include <immintrin.h>
+#endif // defined(CC_*)
+#endif // defined(ARCH_CPU_X86_FAMILY)
+
+namespace base {
+
+#if defined(ARCH_CPU_X86_FAMILY)
+
+//--------------------------------------------------------------------------------------------------
+uint8_t diffFullBlock_32bpp_32x32_AVX512(
+    const uint8_t* image1, const uint8_t* image2, int bytes_per_row)
+{
+    for (int i = 0; i < 32; ++i)
+    {
+        __m512i acc = _mm512_xor_si512(_mm512_loadu_si512(image1), _mm512_loadu_si512(image2));
+        acc = _mm512_or_si512(
+            acc, _mm512_xor_si512(_mm512_loadu_si512(image1 + 64), _mm512_loadu_si512(image2 + 64)));
+
+        // If the row has differences.
+        if (_mm512_test_epi64_mask(acc, acc))
+            return 1U;
+
+        image1 += bytes_per_row;
+        image2 += bytes_per_row;
+    }
+
+    return 0U;
+}
+
+//--------------------------------------------------------------------------------------------------
+uint8_t diffFullBlock_32bpp_16x16_AVX512(
+    const uint8_t* image1, const uint8_t* image2, int bytes_per_row)
+{
+    for (int i = 0; i < 16; ++i)
+    {
+        // The row of the block is exactly 64 bytes and fits into one register.
+        __m512i acc = _mm512_xor_si512(_mm512_loadu_si512(image1), _mm512_loadu_si512(image2));
+
+        // If the row has differences.
+        if (_mm512_test_epi64_mask(acc, acc))
+            return 1U;
+
+        image1 += bytes_per_row;
+        image2 += bytes_per_row;
+    }
+
+    return 0U;
+}
+
+#endif // defined(ARCH_CPU_X86_FAMILY)
+
+} // namespace base
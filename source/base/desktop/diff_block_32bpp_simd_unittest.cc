@@ -0,0 +1,149 @@
+//
+// Aspia Project
+// Copyright (C) 2016-2025 Dmitry Chapyshev <dmitry@aspia.ru>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "base/cpuid_util.h"
+#include "base/memory/aligned_memory.h"
+#include "base/desktop/diff_block_32bpp_avx2.h"
+#include "base/desktop/diff_block_32bpp_avx512.h"
+
+#include <gtest/gtest.h>
+#include <libyuv/cpu_id.h>
+
+#include <cstring>
+
+namespace base {
+
+#if defined(ARCH_CPU_X86_FAMILY)
+
+namespace {
+
+using AlignedBuffer = std::unique_ptr<uint8_t, AlignedFreeDeleter>;
+using DiffFullBlockFunc = uint8_t(*)(const uint8_t*, const uint8_t*, int);
+
+const int kBytesPerPixel = 4;
+const int kAlignment = 64;
+
+struct DiffBlockImpl
+{
+    const char* name;
+    bool (*is_supported)();
+    DiffFullBlockFunc diff_16x16;
+    DiffFullBlockFunc diff_32x32;
+};
+
+bool hasAvx2()
+{
+    return libyuv::TestCpuFlag(libyuv::kCpuHasAVX2);
+}
+
+const DiffBlockImpl kImpls[] =
+{
+    { "AVX2", hasAvx2, diffFullBlock_32bpp_16x16_AVX2, diffFullBlock_32bpp_32x32_AVX2 },
+    { "AVX512", CpuidUtil::hasAvx512f,
+      diffFullBlock_32bpp_16x16_AVX512, diffFullBlock_32bpp_32x32_AVX512 }
+};
+
+void generateData(uint8_t* data, int size)
+{
+    for (int i = 0; i < size; ++i)
+        data[i] = static_cast<uint8_t>(i);
+}
+
+int fullBlockSize(int block_size)
+{
+    return block_size * block_size * kBytesPerPixel;
+}
+
+void prepareBuffers(AlignedBuffer* block1, AlignedBuffer* block2, int block_size)
+{
+    int full_block_size = fullBlockSize(block_size);
+
+    block1->reset(reinterpret_cast<uint8_t*>(alignedAlloc(full_block_size, kAlignment)));
+    block2->reset(reinterpret_cast<uint8_t*>(alignedAlloc(full_block_size, kAlignment)));
+
+    generateData(block1->get(), full_block_size);
+
+    memcpy(block2->get(), block1->get(), full_block_size);
+}
+
+class diff_block_simd : public testing::TestWithParam<DiffBlockImpl>
+{
+protected:
+    void SetUp() override
+    {
+        if (!GetParam().is_supported())
+            GTEST_SKIP() << GetParam().name << " is not supported";
+    }
+
+    uint8_t diffBlock(const AlignedBuffer& block1, const AlignedBuffer& block2, int block_size)
+    {
+        DiffFullBlockFunc func = (block_size == 32) ? GetParam().diff_32x32 : GetParam().diff_16x16;
+        return func(block1.get(), block2.get(), block_size * kBytesPerPixel);
+    }
+};
+
+} // namespace
+
+TEST_P(diff_block_simd, block_difference_test_same)
+{
+    for (int block_size : { 16, 32 })
+    {
+        AlignedBuffer block1;
+        AlignedBuffer block2;
+
+        prepareBuffers(&block1, &block2, block_size);
+
+        // These blocks should match.
+        EXPECT_EQ(0, diffBlock(block1, block2, block_size));
+    }
+}
+
+TEST_P(diff_block_simd, block_difference_test_changed)
+{
+    for (int block_size : { 16, 32 })
+    {
+        const int full_block_size = fullBlockSize(block_size);
+
+        // The first, the middle, the last byte and the last byte of the first row.
+        const int kPositions[] =
+        {
+            0, full_block_size / 2 + 1, full_block_size - 2, block_size * kBytesPerPixel - 1
+        };
+
+        for (int position : kPositions)
+        {
+            AlignedBuffer block1;
+            AlignedBuffer block2;
+
+            prepareBuffers(&block1, &block2, block_size);
+            block2.get()[position] += 1;
+
+            EXPECT_EQ(1, diffBlock(block1, block2, block_size)) << "position: " << position;
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(impls, diff_block_simd, testing::ValuesIn(kImpls),
+                         [](const testing::TestParamInfo<DiffBlockImpl>& info)
+{
+    return std::string(info.param.name);
+});
+
+#endif // defined(ARCH_CPU_X86_FAMILY)
+
+} // namespace base
@@ -18,11 +18,21 @@
 
 #include "base/desktop/differ.h"
 
+#include "base/cpuid_util.h"
 #include "base/logging.h"
+#include "base/desktop/diff_block_32bpp_avx2.h"
+#include "base/desktop/diff_block_32bpp_avx512.h"
 #include "base/desktop/diff_block_32bpp_sse2.h"
 #include "base/desktop/diff_block_32bpp_c.h"
 
+#include <algorithm>
+#include <condition_variable>
 #include <cstring>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #include <libyuv/cpu_id.h>
 
 namespace base {
@@ -33,6 +43,11 @@ const int kBlockSize = 16;
 const int kBytesPerPixel = 4;
 const int kBytesPerBlock = kBlockSize * kBytesPerPixel;
 
+// Number of pixels that one stripe should contain. Frames up to 1920x1080 are compared on the
+// calling thread only.
+const int kPixelsPerStripe = 1920 * 1080;
+const int kMaxStripes = 8;
+
 //--------------------------------------------------------------------------------------------------
 // Check for diffs in upper-left portion of the block. The size of the portion to check is
 // specified by the |width| and |height| values.
@@ -56,12 +71,136 @@ uint8_t diffPartialBlock(const uint8_t* prev_image,
     return 0U;
 }
 
+//--------------------------------------------------------------------------------------------------
+int calcStripeCount(const Size& size, int block_rows, int max_stripes)
+{
+    int stripe_count = max_stripes;
 
+    if (stripe_count <= 0)
+    {
+        const int cpu_count = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+
+        stripe_count = (size.width() * size.height()) / kPixelsPerStripe;
+        stripe_count = std::min(stripe_count, std::min(cpu_count, kMaxStripes));
+    }
+
+    return std::clamp(stripe_count, 1, std::max(block_rows, 1));
+}
 
 } // namespace
 
+// Set of threads that compare the stripes of the frame. The first stripe is always compared on
+// the calling thread.
+class Differ::StripePool
+{
+public:
+    explicit StripePool(int thread_count);
+    ~StripePool();
+
+    using Task = std::function<void(int stripe_index)>;
+
+    // Runs |task| for every stripe and returns when all stripes are completed.
+    void run(const Task& task);
+
+private:
+    void threadMain(int stripe_index);
+
+    std::mutex lock_;
+    std::condition_variable work_event_;
+    std::condition_variable done_event_;
+
+    const Task* task_ = nullptr;
+    uint64_t generation_ = 0;
+    size_t pending_ = 0;
+    bool terminating_ = false;
+
+    std::vector<std::thread> threads_;
+
+    DISALLOW_COPY_AND_ASSIGN(StripePool);
+};
+
+//--------------------------------------------------------------------------------------------------
+Differ::StripePool::StripePool(int thread_count)
+{
+    threads_.reserve(static_cast<size_t>(thread_count));
+
+    for (int i = 0; i < thread_count; ++i)
+        threads_.emplace_back(&StripePool::threadMain, this, i + 1);
+}
+
 //--------------------------------------------------------------------------------------------------
-Differ::Differ(const Size& size)
+Differ::StripePool::~StripePool()
+{
+    {
+        std::scoped_lock lock(lock_);
+        terminating_ = true;
+    }
+
+    work_event_.notify_all();
+
+    for (auto& thread : threads_)
+        thread.join();
+}
+
+//--------------------------------------------------------------------------------------------------
+void Differ::StripePool::run(const Task& task)
+{
+    {
+        std::scoped_lock lock(lock_);
+        task_ = &task;
+        pending_ = threads_.size();
+        ++generation_;
+    }
+
+    work_event_.notify_all();
+
+    // The first stripe is compared on the current thread.
+    task(0);
+
+    std::unique_lock lock(lock_);
+    done_event_.wait(lock, [this]() { return pending_ == 0; });
+    task_ = nullptr;
+}
+
+//--------------------------------------------------------------------------------------------------
+void Differ::StripePool::threadMain(int stripe_index)
+{
+    uint64_t generation = 0;
+
+    while (true)
+    {
+        const Task* task;
+
+        {
+            std::unique_lock lock(lock_);
+            work_event_.wait(lock, [&]()
+            {
+                return terminating_ || generation_ != generation;
+            });
+
+            if (terminating_)
+                return;
+
+            generation = generation_;
+            task = task_;
+        }
+
+        (*task)(stripe_index);
+
+        bool completed;
+
+        {
+            std::scoped_lock lock(lock_);
+            completed = (--pending_ == 0);
+        }
+
+        if (completed)
+            done_event_.notify_one();
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+Differ::Differ(const Size& size, int max_stripes)
     : screen_rect_(Rect::makeSize(size)),
       bytes_per_row_(size.width() * kBytesPerPixel),
       diff_width_(((size.width() + kBlockSize - 1) / kBlockSize) + 1),
@@ -91,51 +230,88 @@ Differ::Differ(const Size& size)
 
     LOG(LS_INFO) << "Block stride: " << block_stride_y_;
 
+    // The partial row (if present) is counted as a separate block row.
+    block_rows_ = full_blocks_y_ + (partial_row_height_ != 0 ? 1 : 0);
+
+    stripe_count_ = calcStripeCount(size, block_rows_, max_stripes);
+    if (stripe_count_ > 1)
+        stripe_pool_ = std::make_unique<StripePool>(stripe_count_ - 1);
+
+    LOG(LS_INFO) << "Stripes: " << stripe_count_;
+
     diff_full_block_func_ = diffFunction();
     CHECK(diff_full_block_func_);
 }
 
+//--------------------------------------------------------------------------------------------------
+Differ::~Differ() = default;
+
 //--------------------------------------------------------------------------------------------------
 // static
 Differ::DiffFullBlockFunc Differ::diffFunction()
 {
-    if (libyuv::TestCpuFlag(libyuv::kCpuHasSSE2))
-    {
 #if defined(ARCH_CPU_X86_FAMILY)
-        LOG(LS_INFO) << "SSE2 differ loaded";
+    if (CpuidUtil::hasAvx512f())
+    {
+        LOG(LS_INFO) << "AVX-512 differ loaded";
 
         if constexpr (kBlockSize == 16)
-            return diffFullBlock_32bpp_16x16_SSE2;
+            return diffFullBlock_32bpp_16x16_AVX512;
         else if constexpr (kBlockSize == 32)
-            return diffFullBlock_32bpp_32x32_SSE2;
-#endif // defined(ARCH_CPU_X86_FAMILY)
+            return diffFullBlock_32bpp_32x32_AVX512;
     }
-    else
+
+    if (libyuv::TestCpuFlag(libyuv::kCpuHasAVX2))
     {
-        LOG(LS_INFO) << "C differ loaded";
+        LOG(LS_INFO) << "AVX2 differ loaded";
 
         if constexpr (kBlockSize == 16)
-            return diffFullBlock_32bpp_16x16_C;
+            return diffFullBlock_32bpp_16x16_AVX2;
         else if constexpr (kBlockSize == 32)
-            return diffFullBlock_32bpp_32x32_C;
+            return diffFullBlock_32bpp_32x32_AVX2;
     }
 
+    if (libyuv::TestCpuFlag(libyuv::kCpuHasSSE2))
+    {
+        LOG(LS_INFO) << "SSE2 differ loaded";
+
+        if constexpr (kBlockSize == 16)
+            return diffFullBlock_32bpp_16x16_SSE2;
+        else if constexpr (kBlockSize == 32)
+            return diffFullBlock_32bpp_32x32_SSE2;
+    }
+#endif // defined(ARCH_CPU_X86_FAMILY)
+
+    LOG(LS_INFO) << "C differ loaded";
+
+    if constexpr (kBlockSize == 16)
+        return diffFullBlock_32bpp_16x16_C;
+    else if constexpr (kBlockSize == 32)
+        return diffFullBlock_32bpp_32x32_C;
+
     return nullptr;
 }
 
 //--------------------------------------------------------------------------------------------------
 // Identify all of the blocks that contain changed pixels.
-void Differ::markDirtyBlocks(const uint8_t* prev_image, const uint8_t* curr_image)
+void Differ::markDirtyBlocks(const uint8_t* prev_image,
+                             const uint8_t* curr_image,
+                             int first_row,
+                             int last_row)
 {
-    const uint8_t* prev_block_row_start = prev_image;
-    const uint8_t* curr_block_row_start = curr_image;
+    const size_t row_offset = static_cast<size_t>(first_row) * static_cast<size_t>(block_stride_y_);
+
+    const uint8_t* prev_block_row_start = prev_image + row_offset;
+    const uint8_t* curr_block_row_start = curr_image + row_offset;
 
     // Offset from the start of one diff_info row to the next.
     const int diff_stride = diff_width_;
 
-    uint8_t* is_diff_row_start = diff_info_.get();
+    uint8_t* is_diff_row_start = diff_info_.get() + first_row * diff_stride;
+
+    const int last_full_row = std::min(last_row, full_blocks_y_);
 
-    for (int y = 0; y < full_blocks_y_; ++y)
+    for (int y = first_row; y < last_full_row; ++y)
     {
         const uint8_t* prev_block = prev_block_row_start;
         const uint8_t* curr_block = curr_block_row_start;
@@ -173,7 +349,7 @@ void Differ::markDirtyBlocks(const uint8_t* prev_image, const uint8_t* curr_imag
 
     // If the screen height is not a multiple of the block size, then this handles the last partial
     // row. This situation is far more common than the 'partial column' case.
-    if (partial_row_height_ != 0)
+    if (partial_row_height_ != 0 && last_row > full_blocks_y_)
     {
         const uint8_t* prev_block = prev_block_row_start;
         const uint8_t* curr_block = curr_block_row_start;
@@ -297,7 +473,21 @@ void Differ::calcDirtyRegion(const uint8_t* prev_image,
     dirty_region->clear();
 
     // Identify all the blocks that contain changed pixels.
-    markDirtyBlocks(prev_image, curr_image);
+    if (stripe_pool_)
+    {
+        // Each stripe writes only to its own rows of |diff_info_|.
+        stripe_pool_->run([&](int stripe_index)
+        {
+            const int first_row = block_rows_ * stripe_index / stripe_count_;
+            const int last_row = block_rows_ * (stripe_index + 1) / stripe_count_;
+
+            markDirtyBlocks(prev_image, curr_image, first_row, last_row);
+        });
+    }
+    else
+    {
+        markDirtyBlocks(prev_image, curr_image, 0, block_rows_);
+    }
 
     // Now that we've identified the blocks that have changed, merge adjacent blocks to minimize
     // the number of rects that we return.
@@ -27,22 +27,33 @@
 namespace base {
 
 // Class to search for changed regions of the screen.
+// Large frames are split into horizontal stripes which are compared in parallel.
 class Differ
 {
 public:
-    explicit Differ(const Size& size);
-    ~Differ() = default;
+    // If |max_stripes| is 0, then the number of stripes is selected automatically based on the
+    // frame size and the number of processors.
+    explicit Differ(const Size& size, int max_stripes = 0);
+    ~Differ();
 
     void calcDirtyRegion(const uint8_t* prev_image,
                          const uint8_t* curr_image,
                          Region* changed_region);
 
+    int stripeCount() const { return stripe_count_; }
+
 private:
+    class StripePool;
+
     typedef uint8_t(*DiffFullBlockFunc)(const uint8_t*, const uint8_t*, int);
 
     static DiffFullBlockFunc diffFunction();
 
-    void markDirtyBlocks(const uint8_t* prev_image, const uint8_t* curr_image);
+    // Marks the blocks that contain changed pixels in block rows [first_row, last_row).
+    void markDirtyBlocks(const uint8_t* prev_image,
+                         const uint8_t* curr_image,
+                         int first_row,
+                         int last_row);
     void mergeBlocks(Region* dirty_region);
 
     const Rect screen_rect_;
@@ -55,9 +66,12 @@ private:
     int partial_column_width_;
     int partial_row_height_;
     int block_stride_y_;
+    int block_rows_;
+    int stripe_count_ = 1;
 
     std::unique_ptr<uint8_t[]> diff_info_;
     DiffFullBlockFunc diff_full_block_func_;
+    std::unique_ptr<StripePool> stripe_pool_;
 
     DISALLOW_COPY_AND_ASSIGN(Differ);
 };
@@ -0,0 +1,226 @@
+//
+// Aspia Project
+// Copyright (C) 2016-2025 Dmitry Chapyshev <dmitry@aspia.ru>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "base/desktop/differ.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace base {
+
+namespace {
+
+const int kBytesPerPixel = 4;
+
+std::vector<uint8_t> generateImage(const Size& size)
+{
+    std::vector<uint8_t> image(static_cast<size_t>(size.width() * size.height() * kBytesPerPixel));
+
+    for (size_t i = 0; i < image.size(); ++i)
+        image[i] = static_cast<uint8_t>(i);
+
+    return image;
+}
+
+void changePixel(std::vector<uint8_t>* image, const Size& size, int x, int y)
+{
+    size_t offset = static_cast<size_t>((y * size.width() + x) * kBytesPerPixel);
+    (*image)[offset] += 1;
+}
+
+} // namespace
+
+TEST(differ_test, same_images)
+{
+    const Size size(1920, 1080);
+
+    std::vector<uint8_t> prev = generateImage(size);
+    std::vector<uint8_t> curr = prev;
+
+    Differ differ(size);
+    Region dirty_region;
+
+    differ.calcDirtyRegion(prev.data(), curr.data(), &dirty_region);
+    EXPECT_TRUE(dirty_region.isEmpty());
+}
+
+TEST(differ_test, single_pixel)
+{
+    const Size size(1920, 1080);
+
+    std::vector<uint8_t> prev = generateImage(size);
+    std::vector<uint8_t> curr = prev;
+
+    changePixel(&curr, size, 100, 200);
+
+    Differ differ(size);
+    Region dirty_region;
+
+    differ.calcDirtyRegion(prev.data(), curr.data(), &dirty_region);
+    EXPECT_TRUE(dirty_region.equals(Region(Rect::makeXYWH(96, 192, 16, 16))));
+}
+
+TEST(differ_test, partial_blocks)
+{
+    // Size is not a multiple of the block size.
+    const Size size(1001, 999);
+
+    std::vector<uint8_t> prev = generateImage(size);
+    std::vector<uint8_t> curr = prev;
+
+    changePixel(&curr, size, size.width() - 1, size.height() - 1);
+
+    Differ differ(size);
+    Region dirty_region;
+
+    differ.calcDirtyRegion(prev.data(), curr.data(), &dirty_region);
+    EXPECT_TRUE(dirty_region.equals(Region(Rect::makeLTRB(992, 992, 1001, 999))));
+}
+
+TEST(differ_test, stripes_match_single_thread)
+{
+    const Size kSizes[] = { Size(3840, 2160), Size(1001, 999), Size(640, 17) };
+
+    std::mt19937 random_engine(12345);
+
+    for (const auto& size : kSizes)
+    {
+        std::vector<uint8_t> prev = generateImage(size);
+        std::vector<uint8_t> curr = prev;
+
+        std::uniform_int_distribution<int> x_dist(0, size.width() - 1);
+        std::uniform_int_distribution<int> y_dist(0, size.height() - 1);
+
+        for (int i = 0; i < 100; ++i)
+            changePixel(&curr, size, x_dist(random_engine), y_dist(random_engine));
+
+        Differ single_differ(size, 1);
+        EXPECT_EQ(single_differ.stripeCount(), 1);
+
+        Region expected_region;
+        single_differ.calcDirtyRegion(prev.data(), curr.data(), &expected_region);
+        EXPECT_FALSE(expected_region.isEmpty());
+
+        for (int stripes = 2; stripes <= 8; ++stripes)
+        {
+            Differ striped_differ(size, stripes);
+            Region dirty_region;
+
+            // Run several times to make sure that the threads are reused correctly.
+            for (int i = 0; i < 3; ++i)
+            {
+                striped_differ.calcDirtyRegion(prev.data(), curr.data(), &dirty_region);
+                EXPECT_TRUE(dirty_region.equals(expected_region));
+            }
+        }
+    }
+}
+
+TEST(differ_test, DISABLED_benchmark)
+{
+    struct Resolution
+    {
+        const char* name;
+        Size size;
+    } const kResolutions[] =
+    {
+        { "1080p", Size(1920, 1080) },
+        { "4K", Size(3840, 2160) },
+        { "8K", Size(7680, 4320) }
+    };
+
+    enum class Pattern { STATIC, SPARSE, FULL };
+
+    struct PatternInfo
+    {
+        const char* name;
+        Pattern pattern;
+    } const kPatterns[] =
+    {
+        { "static", Pattern::STATIC },
+        { "sparse", Pattern::SPARSE },
+        { "full", Pattern::FULL }
+    };
+
+    const int kIterationCount = 50;
+
+    for (const auto& resolution : kResolutions)
+    {
+        const Size& size = resolution.size;
+
+        for (const auto& pattern : kPatterns)
+        {
+            std::vector<uint8_t> prev = generateImage(size);
+            std::vector<uint8_t> curr = prev;
+
+            switch (pattern.pattern)
+            {
+                case Pattern::STATIC:
+                    break;
+
+                case Pattern::SPARSE:
+                {
+                    // One changed pixel in each 256x256 area.
+                    for (int y = 0; y < size.height(); y += 256)
+                    {
+                        for (int x = 0; x < size.width(); x += 256)
+                            changePixel(&curr, size, x, y);
+                    }
+                }
+                break;
+
+                case Pattern::FULL:
+                {
+                    // The last pixel of each block is changed. This is the worst case for
+                    // the block comparators.
+                    for (int y = 15; y < size.height(); y += 16)
+                    {
+                        for (int x = 15; x < size.width(); x += 16)
+                            changePixel(&curr, size, x, y);
+                    }
+                }
+                break;
+            }
+
+            for (int max_stripes : { 1, 0 })
+            {
+                Differ differ(size, max_stripes);
+                Region dirty_region;
+
+                auto start_time = std::chrono::steady_clock::now();
+
+                for (int i = 0; i < kIterationCount; ++i)
+                    differ.calcDirtyRegion(prev.data(), curr.data(), &dirty_region);
+
+                auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start_time);
+
+                std::cout << resolution.name << " " << pattern.name << " (stripes: "
+                          << differ.stripeCount() << "): "
+                          << duration.count() / kIterationCount << " ns/frame" << std::endl;
+            }
+        }
+    }
+}
+
+} // namespace base
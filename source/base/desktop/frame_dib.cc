@@ -29,7 +29,7 @@ FrameDib::FrameDib(const Size& size,
                    const PixelFormat& format,
                    int stride,
                    uint8_t* data,
-                   std::unique_ptr<SharedMemory> shared_memory,
+                   std::unique_ptr<SharedMemoryBase> shared_memory,
                    HBITMAP bitmap)
     : Frame(size, format, stride, data, shared_memory.get()),
       bitmap_(bitmap),
@@ -82,7 +82,7 @@ std::unique_ptr<FrameDib> FrameDib::create(const Size& size,
         }
     }
 
-    std::unique_ptr<SharedMemory> shared_memory;
+    std::unique_ptr<SharedMemoryBase> shared_memory;
     HANDLE section_handle = nullptr;
 
     if (shared_memory_factory)
@@ -46,11 +46,11 @@ private:
              const PixelFormat& format,
              int stride,
              uint8_t* data,
-             std::unique_ptr<SharedMemory> shared_memory,
+             std::unique_ptr<SharedMemoryBase> shared_memory,
              HBITMAP bitmap);
 
     win::ScopedHBITMAP bitmap_;
-    std::unique_ptr<SharedMemory> owned_shared_memory_;
+    std::unique_ptr<SharedMemoryBase> owned_shared_memory_;
 
     DISALLOW_COPY_AND_ASSIGN(FrameDib);
 };
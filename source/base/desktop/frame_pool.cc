@@ -0,0 +1,180 @@
+//
+// Aspia Project
+// Copyright (C) 2016-2025 Dmitry Chapyshev <dmitry@aspia.ru>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "base/desktop/frame_pool.h"
+
+#include "base/logging.h"
+#include "base/memory/aligned_memory.h"
+#include "base/memory/size_class.h"
+
+#include <mutex>
+#include <vector>
+
+namespace base {
+
+namespace {
+
+const size_t kAlignment = 32;
+
+// Total size of the memory that is kept for reuse.
+const size_t kMaxPoolSize = 32 * 1024 * 1024; // 32MB
+
+} // namespace
+
+class FramePool::Buffers
+{
+public:
+    Buffers() = default;
+
+    ~Buffers()
+    {
+        for (const auto& buffer : buffers_)
+            alignedFree(buffer.data);
+    }
+
+    uint8_t* take(size_t size)
+    {
+        std::scoped_lock lock(lock_);
+
+        // The most recently released buffer is taken.
+        for (auto it = buffers_.rbegin(); it != buffers_.rend(); ++it)
+        {
+            if (it->size == size)
+            {
+                uint8_t* data = it->data;
+                buffers_.erase(std::next(it).base());
+                total_size_ -= size;
+                return data;
+            }
+        }
+
+        return nullptr;
+    }
+
+    void release(uint8_t* data, size_t size)
+    {
+        std::scoped_lock lock(lock_);
+
+        if (size > kMaxPoolSize)
+        {
+            alignedFree(data);
+            return;
+        }
+
+        buffers_.push_back({ data, size });
+        total_size_ += size;
+
+        // The oldest buffers are freed if the pool is too big.
+        while (total_size_ > kMaxPoolSize)
+        {
+            total_size_ -= buffers_.front().size;
+            alignedFree(buffers_.front().data);
+            buffers_.erase(buffers_.begin());
+        }
+    }
+
+    size_t count() const
+    {
+        std::scoped_lock lock(lock_);
+        return buffers_.size();
+    }
+
+private:
+    struct Buffer
+    {
+        uint8_t* data;
+        size_t size;
+    };
+
+    mutable std::mutex lock_;
+    std::vector<Buffer> buffers_;
+    size_t total_size_ = 0;
+
+    DISALLOW_COPY_AND_ASSIGN(Buffers);
+};
+
+class FramePool::PooledFrame final : public Frame
+{
+public:
+    PooledFrame(const Size& size,
+                const PixelFormat& format,
+                uint8_t* data,
+                size_t buffer_size,
+                std::shared_ptr<Buffers> buffers)
+        : Frame(size, format, size.width() * format.bytesPerPixel(), data, nullptr),
+          buffer_size_(buffer_size),
+          buffers_(std::move(buffers))
+    {
+        // Nothing
+    }
+
+    ~PooledFrame() final
+    {
+        buffers_->release(data_, buffer_size_);
+    }
+
+private:
+    const size_t buffer_size_;
+    std::shared_ptr<Buffers> buffers_;
+
+    DISALLOW_COPY_AND_ASSIGN(PooledFrame);
+};
+
+//--------------------------------------------------------------------------------------------------
+FramePool::FramePool()
+    : buffers_(std::make_shared<Buffers>())
+{
+    // Nothing
+}
+
+//--------------------------------------------------------------------------------------------------
+FramePool::~FramePool() = default;
+
+//--------------------------------------------------------------------------------------------------
+std::unique_ptr<Frame> FramePool::create(const Size& size, const PixelFormat& format)
+{
+    if (size.isEmpty())
+    {
+        LOG(LS_ERROR) << "Invalid frame size: " << size;
+        return nullptr;
+    }
+
+    const size_t buffer_size = sizeClass(static_cast<size_t>(size.width()) *
+        static_cast<size_t>(size.height()) * static_cast<size_t>(format.bytesPerPixel()));
+
+    uint8_t* data = buffers_->take(buffer_size);
+    if (!data)
+    {
+        data = reinterpret_cast<uint8_t*>(alignedAlloc(buffer_size, kAlignment));
+        if (!data)
+        {
+            LOG(LS_ERROR) << "Unable to allocate memory for frame: " << buffer_size;
+            return nullptr;
+        }
+    }
+
+    return std::make_unique<PooledFrame>(size, format, data, buffer_size, buffers_);
+}
+
+//--------------------------------------------------------------------------------------------------
+size_t FramePool::pooledCount() const
+{
+    return buffers_->count();
+}
+
+} // namespace base
@@ -0,0 +1,54 @@
+//
+// Aspia Project
+// Copyright (C) 2016-2025 Dmitry Chapyshev <dmitry@aspia.ru>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef BASE_DESKTOP_FRAME_POOL_H
+#define BASE_DESKTOP_FRAME_POOL_H
+
+#include "base/desktop/frame.h"
+
+#include <memory>
+
+namespace base {
+
+// Keeps the memory of destroyed frames and uses it for new frames of the same size class. Frames
+// can outlive the pool and can be destroyed on any thread.
+class FramePool
+{
+public:
+    FramePool();
+    ~FramePool();
+
+    // Creates a frame with the memory of a destroyed frame or with new memory. The content of the
+    // frame is not initialized. If an error occurs, nullptr is returned.
+    std::unique_ptr<Frame> create(const Size& size, const PixelFormat& format);
+
+    // Number of buffers that are kept for reuse.
+    size_t pooledCount() const;
+
+private:
+    class Buffers;
+    class PooledFrame;
+
+    std::shared_ptr<Buffers> buffers_;
+
+    DISALLOW_COPY_AND_ASSIGN(FramePool);
+};
+
+} // namespace base
+
+#endif // BASE_DESKTOP_FRAME_POOL_H
@@ -0,0 +1,103 @@
+//
+// Aspia Project
+// Copyright (C) 2016-2025 Dmitry Chapyshev <dmitry@aspia.ru>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "base/desktop/frame_pool.h"
+
+#include <gtest/gtest.h>
+
+namespace base {
+
+TEST(frame_pool_test, reuse_same_size)
+{
+    FramePool pool;
+
+    std::unique_ptr<Frame> frame = pool.create(Size(640, 480), PixelFormat::ARGB());
+    ASSERT_TRUE(frame);
+    EXPECT_EQ(frame->size(), Size(640, 480));
+    EXPECT_EQ(frame->stride(), 640 * 4);
+
+    uint8_t* data = frame->frameData();
+    frame.reset();
+    EXPECT_EQ(pool.pooledCount(), 1u);
+
+    frame = pool.create(Size(640, 480), PixelFormat::ARGB());
+    ASSERT_TRUE(frame);
+    EXPECT_EQ(frame->frameData(), data);
+    EXPECT_EQ(pool.pooledCount(), 0u);
+}
+
+TEST(frame_pool_test, reuse_same_size_class)
+{
+    FramePool pool;
+
+    std::unique_ptr<Frame> frame = pool.create(Size(640, 480), PixelFormat::ARGB());
+    ASSERT_TRUE(frame);
+
+    uint8_t* data = frame->frameData();
+    frame.reset();
+
+    // A slightly smaller frame gets the memory of the same size class.
+    frame = pool.create(Size(638, 480), PixelFormat::ARGB());
+    ASSERT_TRUE(frame);
+    EXPECT_EQ(frame->frameData(), data);
+    EXPECT_EQ(frame->stride(), 638 * 4);
+}
+
+TEST(frame_pool_test, different_size_class)
+{
+    FramePool pool;
+
+    std::unique_ptr<Frame> frame = pool.create(Size(640, 480), PixelFormat::ARGB());
+    ASSERT_TRUE(frame);
+    frame.reset();
+
+    frame = pool.create(Size(1920, 1080), PixelFormat::ARGB());
+    ASSERT_TRUE(frame);
+    EXPECT_EQ(pool.pooledCount(), 1u);
+
+    frame.reset();
+    EXPECT_EQ(pool.pooledCount(), 2u);
+}
+
+TEST(frame_pool_test, frame_outlives_pool)
+{
+    std::unique_ptr<Frame> frame;
+
+    {
+        FramePool pool;
+        frame = pool.create(Size(100, 100), PixelFormat::ARGB());
+        ASSERT_TRUE(frame);
+    }
+
+    // The frame keeps its memory after the pool is destroyed.
+    EXPECT_EQ(frame->size(), Size(100, 100));
+    EXPECT_EQ(frame->stride(), 100 * 4);
+    ASSERT_NE(frame->frameData(), nullptr);
+
+    const size_t size = static_cast<size_t>(frame->stride() * frame->size().height());
+    for (size_t i = 0; i < size; ++i)
+        frame->frameData()[i] = static_cast<uint8_t>(i);
+
+    for (size_t i = 0; i < size; ++i)
+        ASSERT_EQ(frame->frameData()[i], static_cast<uint8_t>(i));
+
+    // The memory is freed with the frame.
+    frame.reset();
+}
+
+} // namespace base
@@ -19,6 +19,7 @@
 #include "base/desktop/screen_capturer_x11.h"
 
 #include "base/logging.h"
+#include "base/desktop/differ.h"
 #include "base/desktop/mouse_cursor.h"
 #include "base/desktop/shared_memory_frame.h"
 #include "base/desktop/x11/x_error_trap.h"
@@ -155,6 +156,8 @@ ScreenCapturer::ScreenId ScreenCapturerX11::currentScreen() const
 //--------------------------------------------------------------------------------------------------
 const Frame* ScreenCapturerX11::captureFrame(Error* error)
 {
+    queue_.moveToNextFrame();
+
     // Process XEvents for XDamage and cursor shape tracking.
     display_->processPendingXEvents();
 
@@ -632,7 +635,22 @@ Frame* ScreenCapturerX11::captureFrameImpl()
         if (!x_server_pixel_buffer_.captureRect(selected_monitor_rect_, frame))
             return nullptr;
 
-        *updated_region = Region(selected_monitor_rect_);
+        Frame* previous = queue_.previousFrame();
+
+        if (!use_damage_ && differ_ && previous && previous->size() == frame->size())
+        {
+            // Without XDamage we have no information about what has changed. Compare the frame
+            // with the previous one to report only the changed blocks.
+            differ_->calcDirtyRegion(previous->frameData(), frame->frameData(), updated_region);
+            updated_region->translate(selected_monitor_rect_.left(), selected_monitor_rect_.top());
+        }
+        else
+        {
+            if (!use_damage_)
+                differ_ = std::make_unique<Differ>(frame->size());
+
+            *updated_region = Region(selected_monitor_rect_);
+        }
     }
 
     return frame;
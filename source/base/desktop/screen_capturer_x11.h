@@ -38,6 +38,8 @@
 
 namespace base {
 
+class Differ;
+
 class ScreenCapturerX11 final
     : public ScreenCapturer,
       public SharedXDisplay::XEventHandler
@@ -133,6 +135,9 @@ private:
     // Queue of the frames buffers.
     FrameQueue<Frame> queue_;
 
+    // Used to find changed regions of the screen when XDamage is not available.
+    std::unique_ptr<Differ> differ_;
+
     // Invalid region from the previous capture. This is used to synchronize the
     // current with the last buffer used.
     Region last_invalid_region_;
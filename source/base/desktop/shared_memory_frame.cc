@@ -46,7 +46,7 @@ std::unique_ptr<Frame> SharedMemoryFrame::create(
 {
     const size_t buffer_size = calcMemorySize(size, format.bytesPerPixel());
 
-    std::unique_ptr<SharedMemory> shared_memory = shared_memory_factory->create(buffer_size);
+    std::unique_ptr<SharedMemoryBase> shared_memory = shared_memory_factory->create(buffer_size);
     if (!shared_memory)
     {
         LOG(LS_ERROR) << "SharedMemoryFactory::create failed for size: " << buffer_size;
@@ -21,6 +21,7 @@
 #include "base/location.h"
 #include "base/logging.h"
 #include "base/ipc/ipc_channel_proxy.h"
+#include "base/ipc/shared_memory_ring.h"
 #include "base/message_loop/message_loop.h"
 #include "base/message_loop/message_pump_asio.h"
 #include "base/strings/unicode.h"
@@ -28,6 +29,7 @@
 #include <asio/read.hpp>
 #include <asio/write.hpp>
 
+#include <cstring>
 #include <functional>
 
 #if defined(OS_WIN)
@@ -41,6 +43,20 @@ namespace {
 
 const uint32_t kMaxMessageSize = 16 * 1024 * 1024; // 16MB
 
+// Several queued messages are sent by one write while their total size is not greater.
+const size_t kWriteBatchSize = 64 * 1024;
+
+// Messages of this size or smaller are copied next to their sizes. It is cheaper than a separate
+// buffer for the write.
+const size_t kMaxCopyMessageSize = 4 * 1024;
+
+const size_t kReadBufferSize = 16 * 1024;
+
+// The size of the message is sent together with flags in the high bits.
+const uint32_t kRingFrameFlag = 0x80000000;    // The message data is in the shared memory ring.
+const uint32_t kServiceFrameFlag = 0x40000000; // The frame contains the id of the ring.
+const uint32_t kFrameSizeMask = 0x3FFFFFFF;
+
 #if defined(OS_POSIX)
 const char16_t kLocalSocketPrefix[] = u"/tmp/aspia_";
 #endif // defined(OS_POSIX)
@@ -108,6 +124,20 @@ SessionId serverSessionIdImpl(HANDLE pipe_handle)
 
 #endif // defined(OS_WIN)
 
+//--------------------------------------------------------------------------------------------------
+void resizeBuffer(ByteArray* buffer, size_t new_size)
+{
+    // If the reserved buffer size is less, then increase it.
+    if (buffer->capacity() < new_size)
+    {
+        buffer->clear();
+        buffer->reserve(new_size);
+    }
+
+    // Change the size of the buffer.
+    buffer->resize(new_size);
+}
+
 } // namespace
 
 class IpcChannel::Handler
@@ -118,10 +148,9 @@ public:
 
     void dettach();
 
-    void onWriteSize(const std::error_code& error_code, size_t bytes_transferred);
-    void onWriteData(const std::error_code& error_code, size_t bytes_transferred);
-    void onReadSize(const std::error_code& error_code, size_t bytes_transferred);
-    void onReadData(const std::error_code& error_code, size_t bytes_transferred);
+    void onWrite(const std::error_code& error_code, size_t bytes_transferred);
+    void onRead(const std::error_code& error_code, size_t bytes_transferred);
+    void onReadMessage(const std::error_code& error_code, size_t bytes_transferred);
 
 private:
     IpcChannel* channel_;
@@ -145,31 +174,24 @@ void IpcChannel::Handler::dettach()
 }
 
 //--------------------------------------------------------------------------------------------------
-void IpcChannel::Handler::onWriteSize(const std::error_code& error_code, size_t bytes_transferred)
-{
-    if (channel_)
-        channel_->onWriteSize(error_code, bytes_transferred);
-}
-
-//--------------------------------------------------------------------------------------------------
-void IpcChannel::Handler::onWriteData(const std::error_code& error_code, size_t bytes_transferred)
+void IpcChannel::Handler::onWrite(const std::error_code& error_code, size_t bytes_transferred)
 {
     if (channel_)
-        channel_->onWriteData(error_code, bytes_transferred);
+        channel_->onWrite(error_code, bytes_transferred);
 }
 
 //--------------------------------------------------------------------------------------------------
-void IpcChannel::Handler::onReadSize(const std::error_code& error_code, size_t bytes_transferred)
+void IpcChannel::Handler::onRead(const std::error_code& error_code, size_t bytes_transferred)
 {
     if (channel_)
-        channel_->onReadSize(error_code, bytes_transferred);
+        channel_->onRead(error_code, bytes_transferred);
 }
 
 //--------------------------------------------------------------------------------------------------
-void IpcChannel::Handler::onReadData(const std::error_code& error_code, size_t bytes_transferred)
+void IpcChannel::Handler::onReadMessage(const std::error_code& error_code, size_t bytes_transferred)
 {
     if (channel_)
-        channel_->onReadData(error_code, bytes_transferred);
+        channel_->onReadMessage(error_code, bytes_transferred);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -354,12 +376,29 @@ void IpcChannel::resume()
     LOG(LS_INFO) << "resume channel (channel_name=" << channel_name_ << ")";
     is_paused_ = false;
 
+    switch (state_)
+    {
+        // We already have an incomplete read operation or messages are being processed now.
+        case ReadState::READ:
+        case ReadState::READ_MESSAGE:
+        case ReadState::PARSE:
+            return;
+
+        default:
+            break;
+    }
+
     // If we have a message that was received before the pause command.
-    if (read_size_)
-        onMessageReceived();
+    if (state_ == ReadState::PENDING)
+    {
+        state_ = ReadState::PARSE;
 
-    DCHECK_EQ(read_size_, 0);
-    doReadSize();
+        if (!onMessageReceived())
+            return;
+    }
+
+    // The read buffer can contain messages received before the pause command.
+    onReadBufferData();
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -367,13 +406,36 @@ void IpcChannel::send(ByteArray&& buffer)
 {
     DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
 
-    const bool schedule_write = write_queue_.empty();
-
     // Add the buffer to the queue for sending.
     write_queue_.emplace(std::move(buffer));
 
-    if (schedule_write)
-        doWriteSize();
+    // If a write is in progress, then the buffer will be sent after its completion.
+    if (!isWriting())
+        doWrite();
+}
+
+//--------------------------------------------------------------------------------------------------
+bool IpcChannel::enableSharedMemoryRing(size_t capacity)
+{
+    DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+
+    if (write_ring_)
+    {
+        LOG(LS_ERROR) << "Shared memory ring is already enabled";
+        return false;
+    }
+
+    write_ring_ = SharedMemoryRing::create(capacity);
+    if (!write_ring_)
+    {
+        LOG(LS_ERROR) << "Unable to create shared memory ring (channel_name=" << channel_name_
+                      << ")";
+        return false;
+    }
+
+    LOG(LS_INFO) << "Shared memory ring created (id=" << write_ring_->id() << " capacity="
+                 << write_ring_->capacity() << " channel_name=" << channel_name_ << ")";
+    return true;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -445,54 +507,132 @@ void IpcChannel::onErrorOccurred(const Location& location, const std::error_code
 }
 
 //--------------------------------------------------------------------------------------------------
-void IpcChannel::doWriteSize()
+void IpcChannel::doWrite()
 {
-    write_size_ = static_cast<uint32_t>(write_queue_.front().size());
+    DCHECK(!isWriting());
+    DCHECK(!write_queue_.empty());
 
-    if (!write_size_ || write_size_ > kMaxMessageSize)
-    {
-        onErrorOccurred(FROM_HERE, asio::error::message_size);
+    if (!takeWriteBatch())
         return;
-    }
 
+    // Send the sizes and the data of all messages of the batch by one write.
     asio::async_write(stream_,
-                      asio::buffer(&write_size_, sizeof(write_size_)),
-                      std::bind(&Handler::onWriteSize,
+                      write_buffers_,
+                      std::bind(&Handler::onWrite,
                                 handler_,
                                 std::placeholders::_1,
                                 std::placeholders::_2));
 }
 
 //--------------------------------------------------------------------------------------------------
-void IpcChannel::onWriteSize(const std::error_code& error_code, size_t bytes_transferred)
+bool IpcChannel::takeWriteBatch()
 {
-    if (error_code)
+    DCHECK(write_batch_.empty());
+
+    size_t write_size = 0;
+    size_t copy_size = 0;
+
+    // The id of the ring is sent before the first message that is written to it.
+    const bool send_ring_id = write_ring_ && !is_ring_id_sent_;
+    if (send_ring_id)
+        copy_size += sizeof(uint32_t) + sizeof(int32_t);
+
+    write_headers_.clear();
+
+    // Take several messages from the queue. The first message is always taken.
+    do
     {
-        onErrorOccurred(FROM_HERE, error_code);
-        return;
+        const ByteArray& message = write_queue_.front();
+
+        if (message.empty() || message.size() > kMaxMessageSize)
+        {
+            onErrorOccurred(FROM_HERE, asio::error::message_size);
+            return false;
+        }
+
+        uint32_t header = static_cast<uint32_t>(message.size());
+        size_t frame_size = sizeof(header) + message.size();
+
+        if (!write_batch_.empty() && write_size + sizeof(header) > kWriteBatchSize)
+            break;
+
+        // Large messages are written to the ring if it has free space. Only their sizes are sent.
+        if (message.size() > kMaxCopyMessageSize && write_ring_ &&
+            write_ring_->write(message.data(), message.size()))
+        {
+            header |= kRingFrameFlag;
+            frame_size = sizeof(header);
+        }
+        else if (!write_batch_.empty() && write_size + frame_size > kWriteBatchSize)
+        {
+            break;
+        }
+
+        write_size += frame_size;
+        copy_size += sizeof(header);
+
+        if (!(header & kRingFrameFlag) && message.size() <= kMaxCopyMessageSize)
+            copy_size += message.size();
+
+        write_headers_.emplace_back(header);
+        write_batch_.emplace_back(std::move(write_queue_.front()));
+        write_queue_.pop();
     }
+    while (!write_queue_.empty());
 
-    DCHECK_EQ(bytes_transferred, sizeof(write_size_));
-    doWriteData();
-}
+    resizeBuffer(&write_buffer_, copy_size);
+    write_buffers_.clear();
 
-//--------------------------------------------------------------------------------------------------
-void IpcChannel::doWriteData()
-{
-    DCHECK(!write_queue_.empty());
+    uint8_t* begin = write_buffer_.data();
+    uint8_t* end = begin;
 
-    const ByteArray& buffer = write_queue_.front();
+    if (send_ring_id)
+    {
+        const uint32_t header = kServiceFrameFlag | sizeof(int32_t);
+        const int32_t ring_id = write_ring_->id();
 
-    // Send the buffer to the recipient.
-    asio::async_write(stream_, asio::buffer(buffer.data(), buffer.size()),
-                      std::bind(&Handler::onWriteData,
-                                handler_,
-                                std::placeholders::_1,
-                                std::placeholders::_2));
+        memcpy(end, &header, sizeof(header));
+        end += sizeof(header);
+
+        memcpy(end, &ring_id, sizeof(ring_id));
+        end += sizeof(ring_id);
+
+        is_ring_id_sent_ = true;
+    }
+
+    for (size_t i = 0; i < write_batch_.size(); ++i)
+    {
+        const ByteArray& message = write_batch_[i];
+        const uint32_t header = write_headers_[i];
+
+        // Copy the size of the message to the buffer.
+        memcpy(end, &header, sizeof(header));
+        end += sizeof(header);
+
+        if (header & kRingFrameFlag)
+            continue;
+
+        if (message.size() <= kMaxCopyMessageSize)
+        {
+            memcpy(end, message.data(), message.size());
+            end += message.size();
+            continue;
+        }
+
+        // A large message is sent from its own buffer after the data copied before it.
+        write_buffers_.emplace_back(begin, end - begin);
+        write_buffers_.emplace_back(message.data(), message.size());
+        begin = end;
+    }
+
+    if (end != begin)
+        write_buffers_.emplace_back(begin, end - begin);
+
+    return true;
 }
 
 //--------------------------------------------------------------------------------------------------
-void IpcChannel::onWriteData(const std::error_code& error_code, size_t bytes_transferred)
+void IpcChannel::onWrite(const std::error_code& error_code, size_t bytes_transferred)
 {
     if (error_code)
     {
@@ -500,109 +640,247 @@ void IpcChannel::onWriteData(const std::error_code& error_code, size_t bytes_tra
         return;
     }
 
-    DCHECK_EQ(bytes_transferred, write_size_);
-    DCHECK(!write_queue_.empty());
+    DCHECK(isWriting());
+    DCHECK_EQ(bytes_transferred, asio::buffer_size(write_buffers_));
 
-    ByteArray buffer = std::move(write_queue_.front());
+    // The sent messages are moved out so that the next write can be started from the
+    // notifications.
+    DCHECK(written_batch_.empty());
+    written_batch_.swap(write_batch_);
 
-    // Delete the sent message from the queue.
-    write_queue_.pop();
+    for (auto& message : written_batch_)
+        onMessageWritten(std::move(message));
 
-    onMessageWritten(std::move(buffer));
+    written_batch_.clear();
 
-    // If the queue is not empty, then we send the following message.
-    if (write_queue_.empty() && !proxy_->reloadWriteQueue(&write_queue_))
-        return;
-
-    doWriteSize();
+    // If the queue is not empty, then we send the following messages.
+    if (!isWriting() && (!write_queue_.empty() || proxy_->reloadWriteQueue(&write_queue_)))
+        doWrite();
 }
 
 //--------------------------------------------------------------------------------------------------
-void IpcChannel::doReadSize()
+void IpcChannel::doRead()
 {
-    asio::async_read(stream_,
-                     asio::buffer(&read_size_, sizeof(read_size_)),
-                     std::bind(&Handler::onReadSize,
-                               handler_,
-                               std::placeholders::_1,
-                               std::placeholders::_2));
+    if (read_buffer_.empty())
+        read_buffer_.resize(kReadBufferSize);
+
+    // Move the beginning of an incomplete message to the start of the buffer.
+    if (read_begin_ == read_end_)
+    {
+        read_begin_ = 0;
+        read_end_ = 0;
+    }
+    else if (read_begin_ != 0)
+    {
+        memmove(read_buffer_.data(), read_buffer_.data() + read_begin_, read_end_ - read_begin_);
+        read_end_ -= read_begin_;
+        read_begin_ = 0;
+    }
+
+    DCHECK_LT(read_end_, read_buffer_.size());
+
+    state_ = ReadState::READ;
+    stream_.async_read_some(asio::buffer(read_buffer_.data() + read_end_,
+                                         read_buffer_.size() - read_end_),
+                            std::bind(&Handler::onRead,
+                                      handler_,
+                                      std::placeholders::_1,
+                                      std::placeholders::_2));
 }
 
 //--------------------------------------------------------------------------------------------------
-void IpcChannel::onReadSize(const std::error_code& error_code, size_t bytes_transferred)
+void IpcChannel::onRead(const std::error_code& error_code, size_t bytes_transferred)
 {
+    DCHECK_EQ(state_, ReadState::READ);
+
     if (error_code)
     {
         onErrorOccurred(FROM_HERE, error_code);
         return;
     }
 
-    DCHECK_EQ(bytes_transferred, sizeof(read_size_));
+    read_end_ += bytes_transferred;
+    DCHECK_LE(read_end_, read_buffer_.size());
+
+    onReadBufferData();
+}
 
-    if (!read_size_ || read_size_ > kMaxMessageSize)
+//--------------------------------------------------------------------------------------------------
+void IpcChannel::onReadBufferData()
+{
+    state_ = ReadState::PARSE;
+
+    // Several messages can be received by one read.
+    while (is_connected_ && !is_paused_)
     {
-        onErrorOccurred(FROM_HERE, asio::error::message_size);
+        const uint8_t* data = read_buffer_.data() + read_begin_;
+        const size_t available = read_end_ - read_begin_;
+
+        uint32_t header = 0;
+        if (available < sizeof(header))
+            break;
+
+        memcpy(&header, data, sizeof(header));
+
+        const uint32_t message_size = header & kFrameSizeMask;
+        const uint32_t flags = header & ~kFrameSizeMask;
+
+        if (!message_size || message_size > kMaxMessageSize ||
+            flags == (kRingFrameFlag | kServiceFrameFlag) ||
+            (flags == kServiceFrameFlag && message_size != sizeof(int32_t)))
+        {
+            onErrorOccurred(FROM_HERE, asio::error::message_size);
+            return;
+        }
+
+        if (flags == kRingFrameFlag)
+        {
+            read_begin_ += sizeof(header);
+
+            // The data of the message is copied from the ring.
+            if (!read_ring_)
+            {
+                LOG(LS_ERROR) << "Shared memory ring is not opened";
+                onErrorOccurred(FROM_HERE, asio::error::invalid_argument);
+                return;
+            }
+
+            resizeBuffer(&message_buffer_, message_size);
+
+            if (!read_ring_->read(message_buffer_.data(), message_size))
+            {
+                LOG(LS_ERROR) << "Unable to read message from shared memory ring (size="
+                              << message_size << ")";
+                onErrorOccurred(FROM_HERE, asio::error::invalid_argument);
+                return;
+            }
+
+            if (!onMessageReceived())
+                return;
+
+            continue;
+        }
+
+        if (available - sizeof(header) < message_size)
+        {
+            // If the message does not fit into the read buffer, then the rest of the message is
+            // read directly into a separate buffer.
+            if (sizeof(header) + message_size > read_buffer_.size())
+                doReadMessage(message_size);
+
+            break;
+        }
+
+        read_begin_ += sizeof(header) + message_size;
+
+        if (flags == kServiceFrameFlag)
+        {
+            int32_t ring_id;
+            memcpy(&ring_id, data + sizeof(header), sizeof(ring_id));
+
+            if (!openReadRing(ring_id))
+                return;
+
+            continue;
+        }
+
+        resizeBuffer(&message_buffer_, message_size);
+        memcpy(message_buffer_.data(), data + sizeof(header), message_size);
+
+        if (!onMessageReceived())
+            return;
+    }
+
+    if (!is_connected_ || state_ != ReadState::PARSE)
+        return;
+
+    if (is_paused_)
+    {
+        state_ = ReadState::IDLE;
         return;
     }
 
-    doReadData();
+    doRead();
 }
 
 //--------------------------------------------------------------------------------------------------
-void IpcChannel::doReadData()
+bool IpcChannel::openReadRing(int32_t ring_id)
 {
-    if (read_buffer_.capacity() < read_size_)
+    LOG(LS_INFO) << "Opening shared memory ring (id=" << ring_id << " channel_name="
+                 << channel_name_ << ")";
+
+    read_ring_ = SharedMemoryRing::open(ring_id);
+    if (!read_ring_)
     {
-        read_buffer_.clear();
-        read_buffer_.reserve(read_size_);
+        onErrorOccurred(FROM_HERE, asio::error::invalid_argument);
+        return false;
     }
 
-    read_buffer_.resize(read_size_);
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+void IpcChannel::doReadMessage(uint32_t message_size)
+{
+    // The beginning of the message is already in the read buffer.
+    const uint8_t* data = read_buffer_.data() + read_begin_ + sizeof(message_size);
+    const size_t available = read_end_ - read_begin_ - sizeof(message_size);
 
+    DCHECK_LT(available, message_size);
+
+    resizeBuffer(&message_buffer_, message_size);
+    memcpy(message_buffer_.data(), data, available);
+
+    read_begin_ = 0;
+    read_end_ = 0;
+
+    state_ = ReadState::READ_MESSAGE;
     asio::async_read(stream_,
-                     asio::buffer(read_buffer_.data(), read_buffer_.size()),
-                     std::bind(&Handler::onReadData,
+                     asio::buffer(message_buffer_.data() + available, message_size - available),
+                     std::bind(&Handler::onReadMessage,
                                handler_,
                                std::placeholders::_1,
                                std::placeholders::_2));
 }
 
 //--------------------------------------------------------------------------------------------------
-void IpcChannel::onReadData(const std::error_code& error_code, size_t bytes_transferred)
+void IpcChannel::onReadMessage(const std::error_code& error_code, size_t /* bytes_transferred */)
 {
+    DCHECK_EQ(state_, ReadState::READ_MESSAGE);
+
     if (error_code)
     {
         onErrorOccurred(FROM_HERE, error_code);
         return;
     }
 
-    DCHECK_EQ(bytes_transferred, read_size_);
-
     if (is_paused_)
+    {
+        state_ = ReadState::PENDING;
         return;
+    }
 
-    onMessageReceived();
+    state_ = ReadState::PARSE;
 
-    if (is_paused_)
+    if (!onMessageReceived())
         return;
 
-    DCHECK_EQ(read_size_, 0);
-    doReadSize();
+    onReadBufferData();
 }
 
 //--------------------------------------------------------------------------------------------------
-void IpcChannel::onMessageReceived()
+bool IpcChannel::onMessageReceived()
 {
     if (listener_)
     {
-        listener_->onIpcMessageReceived(read_buffer_);
+        listener_->onIpcMessageReceived(message_buffer_);
     }
     else
     {
         LOG(LS_ERROR) << "No listener (channel_name=" << channel_name_ << ")";
     }
 
-    read_size_ = 0;
+    return is_connected_;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -33,12 +33,14 @@
 
 #include <filesystem>
 #include <queue>
+#include <vector>
 
 namespace base {
 
 class IpcChannelProxy;
 class IpcServer;
 class Location;
+class SharedMemoryRing;
 
 class IpcChannel
 {
@@ -75,6 +77,11 @@ public:
 
     void send(ByteArray&& buffer);
 
+    // Creates a shared memory ring of the given capacity for outgoing messages. Large messages are
+    // then written to the ring and the socket carries only their sizes. If the ring has no free
+    // space, then a message is sent through the socket. The other side opens the ring itself.
+    bool enableSharedMemoryRing(size_t capacity);
+
     ProcessId peerProcessId() const { return peer_process_id_; }
     SessionId peerSessionId() const { return peer_session_id_; }
     std::filesystem::path peerFilePath() const;
@@ -89,20 +96,32 @@ private:
     using Stream = asio::local::stream_protocol::socket;
 #endif
 
+    enum class ReadState
+    {
+        IDLE,         // No reads are in progress right now.
+        READ,         // Reading data into the read buffer.
+        PARSE,        // Messages from the read buffer are being processed.
+        READ_MESSAGE, // Reading the rest of the message that does not fit the buffer.
+        PENDING       // There is a message about which we did not notify.
+    };
+
     IpcChannel(std::u16string_view channel_name, Stream&& stream);
     static std::u16string channelName(std::u16string_view channel_id);
 
+    bool isWriting() const { return !write_batch_.empty(); }
+
     void onErrorOccurred(const Location& location, const std::error_code& error_code);
-    void doWriteSize();
-    void onWriteSize(const std::error_code& error_code, size_t bytes_transferred);
-    void doWriteData();
-    void onWriteData(const std::error_code& error_code, size_t bytes_transferred);
-    void doReadSize();
-    void onReadSize(const std::error_code& error_code, size_t bytes_transferred);
-    void doReadData();
-    void onReadData(const std::error_code& error_code, size_t bytes_transferred);
-
-    void onMessageReceived();
+    void doWrite();
+    bool takeWriteBatch();
+    void onWrite(const std::error_code& error_code, size_t bytes_transferred);
+    void doRead();
+    void onRead(const std::error_code& error_code, size_t bytes_transferred);
+    void onReadBufferData();
+    bool openReadRing(int32_t ring_id);
+    void doReadMessage(uint32_t message_size);
+    void onReadMessage(const std::error_code& error_code, size_t bytes_transferred);
+
+    bool onMessageReceived();
     void onMessageWritten(ByteArray&& buffer);
 
     std::u16string channel_name_;
@@ -115,10 +134,29 @@ private:
     bool is_paused_ = true;
 
     std::queue<ByteArray> write_queue_;
-    uint32_t write_size_ = 0;
 
-    uint32_t read_size_ = 0;
+    // Messages of the current write operation. They are sent by one gathered write.
+    std::vector<ByteArray> write_batch_;
+    std::vector<uint32_t> write_headers_;
+    std::vector<ByteArray> written_batch_;
+
+    // Sizes of the messages and small messages are copied into one buffer. Large messages are
+    // sent from their own buffers.
+    ByteArray write_buffer_;
+    std::vector<asio::const_buffer> write_buffers_;
+
+    ReadState state_ = ReadState::IDLE;
+
+    // Received data that is not processed yet is in the range [read_begin_, read_end_).
     ByteArray read_buffer_;
+    size_t read_begin_ = 0;
+    size_t read_end_ = 0;
+
+    ByteArray message_buffer_;
+
+    std::unique_ptr<SharedMemoryRing> write_ring_;
+    bool is_ring_id_sent_ = false;
+    std::unique_ptr<SharedMemoryRing> read_ring_;
 
     ProcessId peer_process_id_ = kNullProcessId;
     SessionId peer_session_id_ = kInvalidSessionId;
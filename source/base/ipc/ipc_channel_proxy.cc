@@ -69,10 +69,14 @@ void IpcChannelProxy::scheduleWrite()
     if (!channel_)
         return;
 
+    // If a write is in progress, then the queue will be reloaded after its completion.
+    if (channel_->isWriting())
+        return;
+
     if (!reloadWriteQueue(&channel_->write_queue_))
         return;
 
-    channel_->doWriteSize();
+    channel_->doWrite();
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -0,0 +1,327 @@
+//
+// Aspia Project
+// Copyright (C) 2016-2025 Dmitry Chapyshev <dmitry@aspia.ru>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "base/ipc/ipc_channel.h"
+
+#include "base/ipc/ipc_server.h"
+#include "base/task_runner.h"
+#include "base/threading/thread.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <vector>
+
+namespace base {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Number of messages sent by one task. The receiver gets the messages while they are sent.
+const int kSendChunkSize = 32;
+
+struct MessageHeader
+{
+    uint32_t number;
+    int64_t send_time;
+};
+
+// Sends messages from a client channel to a server channel. Lives on the thread of the channels.
+class Loopback final
+    : public IpcServer::Delegate,
+      public IpcChannel::Listener
+{
+public:
+    using MessageSize = std::function<size_t(int index)>;
+
+    Loopback(MessageSize message_size,
+             int message_count,
+             bool pause,
+             size_t ring_capacity,
+             std::promise<bool>* finished)
+        : task_runner_(MessageLoop::current()->taskRunner()),
+          message_size_(std::move(message_size)),
+          message_count_(message_count),
+          pause_(pause),
+          finished_(finished)
+    {
+        latencies_.reserve(static_cast<size_t>(message_count_));
+
+        const std::u16string channel_id = IpcServer::createUniqueId();
+        if (!server_.start(channel_id, this))
+        {
+            finish(false);
+            return;
+        }
+
+        client_channel_ = std::make_unique<IpcChannel>();
+        if (!client_channel_->connect(channel_id))
+        {
+            finish(false);
+            return;
+        }
+
+        if (ring_capacity && !client_channel_->enableSharedMemoryRing(ring_capacity))
+        {
+            finish(false);
+            return;
+        }
+
+        client_channel_->setListener(this);
+        client_channel_->resume();
+
+        sendMessages();
+    }
+
+    ~Loopback() final = default;
+
+    const std::vector<Clock::duration>& latencies() const { return latencies_; }
+
+    // IpcServer::Delegate implementation.
+    void onNewConnection(std::unique_ptr<IpcChannel> channel) final
+    {
+        server_channel_ = std::move(channel);
+        server_channel_->setListener(this);
+        server_channel_->resume();
+    }
+
+    void onErrorOccurred() final
+    {
+        finish(false);
+    }
+
+    // IpcChannel::Listener implementation.
+    void onIpcDisconnected() final
+    {
+        finish(false);
+    }
+
+    void onIpcMessageReceived(const ByteArray& buffer) final
+    {
+        const Clock::time_point receive_time = Clock::now();
+        ByteArray expected = createMessage(received_count_);
+
+        MessageHeader header;
+        memcpy(&header, buffer.data(), std::min(buffer.size(), sizeof(header)));
+
+        if (buffer.size() != expected.size() ||
+            header.number != static_cast<uint32_t>(received_count_) ||
+            buffer.back() != expected.back())
+        {
+            finish(false);
+            return;
+        }
+
+        const Clock::time_point send_time{ Clock::duration(header.send_time) };
+        latencies_.emplace_back(receive_time - send_time);
+
+        if (++received_count_ == message_count_)
+        {
+            finish(true);
+            return;
+        }
+
+        // Messages received during the pause stay in the channel and are delivered after it.
+        if (pause_ && received_count_ % 100 == 0)
+        {
+            server_channel_->pause();
+            task_runner_->postTask([this]() { server_channel_->resume(); });
+        }
+    }
+
+    void onIpcMessageWritten(ByteArray&& /* buffer */) final
+    {
+        // Nothing
+    }
+
+private:
+    void sendMessages()
+    {
+        const int count = std::min(message_count_ - sent_count_, kSendChunkSize);
+
+        for (int i = 0; i < count; ++i)
+            client_channel_->send(createMessage(sent_count_++));
+
+        if (sent_count_ < message_count_)
+            task_runner_->postTask([this]() { sendMessages(); });
+    }
+
+    ByteArray createMessage(int index) const
+    {
+        ByteArray message(std::max(message_size_(index), sizeof(MessageHeader)),
+                          static_cast<uint8_t>(index));
+
+        MessageHeader header;
+        header.number = static_cast<uint32_t>(index);
+        header.send_time = Clock::now().time_since_epoch().count();
+
+        memcpy(message.data(), &header, sizeof(header));
+        return message;
+    }
+
+    void finish(bool result)
+    {
+        if (!finished_)
+            return;
+
+        finished_->set_value(result);
+        finished_ = nullptr;
+    }
+
+    std::shared_ptr<TaskRunner> task_runner_;
+    const MessageSize message_size_;
+    const int message_count_;
+    const bool pause_;
+    std::promise<bool>* finished_;
+
+    IpcServer server_;
+    std::unique_ptr<IpcChannel> client_channel_;
+    std::unique_ptr<IpcChannel> server_channel_;
+    int sent_count_ = 0;
+    int received_count_ = 0;
+    std::vector<Clock::duration> latencies_;
+
+    DISALLOW_COPY_AND_ASSIGN(Loopback);
+};
+
+struct TransferResult
+{
+    bool succeeded = false;
+    Clock::duration duration;
+    std::vector<Clock::duration> latencies;
+};
+
+TransferResult transfer(Loopback::MessageSize message_size,
+                        int message_count,
+                        bool pause,
+                        size_t ring_capacity = 0)
+{
+    Thread thread;
+    thread.start(MessageLoop::Type::ASIO);
+
+    std::shared_ptr<TaskRunner> task_runner = thread.taskRunner();
+    std::unique_ptr<Loopback> loopback;
+    std::promise<bool> finished;
+    TransferResult result;
+
+    const Clock::time_point start_time = Clock::now();
+
+    task_runner->postTask([&]()
+    {
+        loopback = std::make_unique<Loopback>(
+            std::move(message_size), message_count, pause, ring_capacity, &finished);
+    });
+
+    result.succeeded = finished.get_future().get();
+    result.duration = Clock::now() - start_time;
+
+    std::promise<void> destroyed;
+    task_runner->postTask([&]()
+    {
+        result.latencies = loopback->latencies();
+        loopback.reset();
+        destroyed.set_value();
+    });
+
+    destroyed.get_future().wait();
+    thread.stop();
+
+    return result;
+}
+
+} // namespace
+
+namespace {
+
+// Small messages are coalesced, medium messages are sent from their own buffers and large
+// messages do not fit into the read buffer.
+size_t mixedMessageSize(int index)
+{
+    if (index % 10 == 0)
+        return 100 * 1024;
+
+    if (index % 3 == 0)
+        return 8 * 1024;
+
+    return 16 + static_cast<size_t>(index % 200);
+}
+
+} // namespace
+
+TEST(ipc_channel_test, transfer)
+{
+    EXPECT_TRUE(transfer(mixedMessageSize, 2000, false).succeeded);
+}
+
+TEST(ipc_channel_test, transfer_with_ring)
+{
+    EXPECT_TRUE(transfer(mixedMessageSize, 2000, false, 1024 * 1024).succeeded);
+}
+
+TEST(ipc_channel_test, transfer_with_small_ring)
+{
+    // The ring is often full and some of the large messages are sent through the socket.
+    EXPECT_TRUE(transfer(mixedMessageSize, 2000, true, 64 * 1024).succeeded);
+}
+
+TEST(ipc_channel_test, transfer_with_pause)
+{
+    auto message_size = [](int index) -> size_t
+    {
+        return (index % 7 == 0) ? 64 * 1024 : 64;
+    };
+
+    EXPECT_TRUE(transfer(message_size, 2000, true).succeeded);
+}
+
+TEST(ipc_channel_test, DISABLED_benchmark)
+{
+    const int kMessageCount = 200000;
+
+    for (size_t ring_capacity : { 0, 8 * 1024 * 1024 })
+    {
+        for (size_t size : { 64, 1024, 16 * 1024, 64 * 1024 })
+        {
+            TransferResult result = transfer(
+                [size](int /* index */) { return size; }, kMessageCount, false, ring_capacity);
+            ASSERT_TRUE(result.succeeded);
+
+            std::vector<Clock::duration>& latencies = result.latencies;
+            ASSERT_EQ(latencies.size(), static_cast<size_t>(kMessageCount));
+
+            const size_t p99_index = latencies.size() * 99 / 100;
+            std::nth_element(latencies.begin(), latencies.begin() + p99_index, latencies.end());
+
+            const double seconds = std::chrono::duration<double>(result.duration).count();
+            const auto p99 =
+                std::chrono::duration_cast<std::chrono::microseconds>(latencies[p99_index]);
+
+            std::cout << (ring_capacity ? "ring, " : "socket, ") << size << " bytes: "
+                      << static_cast<int64_t>(kMessageCount / seconds) << " msgs/s, p99 latency "
+                      << p99.count() << " us" << std::endl;
+        }
+    }
+}
+
+} // namespace base
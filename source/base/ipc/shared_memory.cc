@@ -24,7 +24,6 @@
 #include "base/strings/unicode.h"
 
 #include <atomic>
-#include <cstring>
 #include <random>
 
 #if defined(OS_WIN)
@@ -191,10 +190,12 @@ const SharedMemory::PlatformHandle kInvalidHandle = -1;
 SharedMemory::SharedMemory(int id,
                            ScopedPlatformHandle&& handle,
                            void* data,
+                           size_t size,
                            base::local_shared_ptr<SharedMemoryFactoryProxy> factory_proxy)
     : factory_proxy_(std::move(factory_proxy)),
       handle_(std::move(handle)),
       data_(data),
+      size_(size),
       id_(id)
 {
     if (factory_proxy_)
@@ -255,10 +256,10 @@ std::unique_ptr<SharedMemory> SharedMemory::create(
     if (!mapViewOfFile(mode, file, &memory))
         return nullptr;
 
-    memset(memory, 0, size);
+    // The memory of a new file mapping is already filled with zeros.
 
     return std::unique_ptr<SharedMemory>(
-        new SharedMemory(id, std::move(file), memory, std::move(factory_proxy)));
+        new SharedMemory(id, std::move(file), memory, size, std::move(factory_proxy)));
 #elif defined(OS_LINUX)
     int id = -1;
     int fd = -1;
@@ -268,7 +269,7 @@ std::unique_ptr<SharedMemory> SharedMemory::create(
         id = createUniqueId();
 
         std::string name = base::local8BitFromUtf16(createFilePath(id));
-        int open_flags = O_CREAT;
+        int open_flags = O_CREAT | O_EXCL;
 
         if (mode == Mode::READ_ONLY)
         {
@@ -313,10 +314,11 @@ std::unique_ptr<SharedMemory> SharedMemory::create(
         return nullptr;
     }
 
-    memset(memory, 0, size);
+    // The memory of a new object is already filled with zeros. The object can not exist before
+    // because of O_EXCL.
 
     return std::unique_ptr<SharedMemory>(
-        new SharedMemory(id, ScopedPlatformHandle(fd), memory, std::move(factory_proxy)));
+        new SharedMemory(id, ScopedPlatformHandle(fd), memory, size, std::move(factory_proxy)));
 #else
     NOTIMPLEMENTED();
     return nullptr;
@@ -337,8 +339,16 @@ std::unique_ptr<SharedMemory> SharedMemory::open(
     if (!mapViewOfFile(mode, file, &memory))
         return nullptr;
 
-    return std::unique_ptr<SharedMemory>(
-        new SharedMemory(id, std::move(file), memory, std::move(factory_proxy)));
+    MEMORY_BASIC_INFORMATION info;
+    if (!VirtualQuery(memory, &info, sizeof(info)))
+    {
+        PLOG(LS_ERROR) << "VirtualQuery failed";
+        UnmapViewOfFile(memory);
+        return nullptr;
+    }
+
+    return std::unique_ptr<SharedMemory>(new SharedMemory(
+        id, std::move(file), memory, info.RegionSize, std::move(factory_proxy)));
 #elif defined(OS_LINUX)
     std::string name = base::local8BitFromUtf16(createFilePath(id));
     int open_flags = 0;
@@ -378,8 +388,9 @@ std::unique_ptr<SharedMemory> SharedMemory::open(
         return nullptr;
     }
 
-    return std::unique_ptr<SharedMemory>(
-        new SharedMemory(id, ScopedPlatformHandle(fd), memory, std::move(factory_proxy)));
+    return std::unique_ptr<SharedMemory>(new SharedMemory(
+        id, ScopedPlatformHandle(fd), memory, static_cast<size_t>(info.st_size),
+        std::move(factory_proxy)));
 #else
     NOTIMPLEMENTED();
     return nullptr;
@@ -93,15 +93,21 @@ public:
     PlatformHandle handle() const final { return handle_.get(); }
     int id() const final { return id_; }
 
+    // Size of the mapped memory. For opened memory it can be greater than the requested size
+    // because it is rounded up to the page size.
+    size_t size() const { return size_; }
+
 private:
     SharedMemory(int id,
                  ScopedPlatformHandle&& handle,
                  void* data,
+                 size_t size,
                  base::local_shared_ptr<SharedMemoryFactoryProxy> factory_proxy);
 
     base::local_shared_ptr<SharedMemoryFactoryProxy> factory_proxy_;
     ScopedPlatformHandle handle_;
     void* data_;
+    size_t size_;
     int id_;
 
     DISALLOW_COPY_AND_ASSIGN(SharedMemory);
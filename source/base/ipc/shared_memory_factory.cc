@@ -18,11 +18,50 @@
 
 #include "base/ipc/shared_memory_factory.h"
 
+#include "base/logging.h"
 #include "base/ipc/shared_memory.h"
 #include "base/ipc/shared_memory_factory_proxy.h"
+#include "base/memory/size_class.h"
 
 namespace base {
 
+namespace {
+
+// Total size of the released shared memory that is kept for reuse.
+const size_t kMaxPoolSize = 64 * 1024 * 1024; // 64MB
+
+// Shared memory created by the factory. When it is destroyed, the memory is returned to the pool
+// of the factory.
+class PooledSharedMemory final : public SharedMemoryBase
+{
+public:
+    PooledSharedMemory(std::unique_ptr<SharedMemory> shared_memory,
+                       base::local_shared_ptr<SharedMemoryFactoryProxy> factory_proxy)
+        : shared_memory_(std::move(shared_memory)),
+          factory_proxy_(std::move(factory_proxy))
+    {
+        DCHECK(shared_memory_);
+    }
+
+    ~PooledSharedMemory() final
+    {
+        factory_proxy_->onSharedMemoryRelease(std::move(shared_memory_));
+    }
+
+    // SharedMemoryBase implementation.
+    void* data() final { return shared_memory_->data(); }
+    PlatformHandle handle() const final { return shared_memory_->handle(); }
+    int id() const final { return shared_memory_->id(); }
+
+private:
+    std::unique_ptr<SharedMemory> shared_memory_;
+    base::local_shared_ptr<SharedMemoryFactoryProxy> factory_proxy_;
+
+    DISALLOW_COPY_AND_ASSIGN(PooledSharedMemory);
+};
+
+} // namespace
+
 //--------------------------------------------------------------------------------------------------
 SharedMemoryFactory::SharedMemoryFactory(Delegate* delegate)
     : factory_proxy_(base::make_local_shared<SharedMemoryFactoryProxy>(this)),
@@ -35,12 +74,39 @@ SharedMemoryFactory::SharedMemoryFactory(Delegate* delegate)
 SharedMemoryFactory::~SharedMemoryFactory()
 {
     factory_proxy_->dettach();
+
+    // The pooled shared memory is destroyed after the proxy is detached and the delegate is not
+    // notified, as for the memory that is still in use.
+    pool_.clear();
 }
 
 //--------------------------------------------------------------------------------------------------
-std::unique_ptr<SharedMemory> SharedMemoryFactory::create(size_t size)
+std::unique_ptr<SharedMemoryBase> SharedMemoryFactory::create(size_t size)
 {
-    return SharedMemory::create(SharedMemory::Mode::READ_WRITE, size, factory_proxy_);
+    const size_t size_class = sizeClass(size);
+    std::unique_ptr<SharedMemory> shared_memory;
+
+    // The most recently released memory of the same size class is taken.
+    for (auto it = pool_.rbegin(); it != pool_.rend(); ++it)
+    {
+        if ((*it)->size() == size_class)
+        {
+            shared_memory = std::move(*it);
+            pool_.erase(std::next(it).base());
+            pool_size_ -= size_class;
+            break;
+        }
+    }
+
+    if (!shared_memory)
+    {
+        shared_memory =
+            SharedMemory::create(SharedMemory::Mode::READ_WRITE, size_class, factory_proxy_);
+        if (!shared_memory)
+            return nullptr;
+    }
+
+    return std::make_unique<PooledSharedMemory>(std::move(shared_memory), factory_proxy_);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -61,4 +127,22 @@ void SharedMemoryFactory::onSharedMemoryDestroy(int id)
     delegate_->onSharedMemoryDestroy(id);
 }
 
+//--------------------------------------------------------------------------------------------------
+void SharedMemoryFactory::onSharedMemoryRelease(std::unique_ptr<SharedMemory> shared_memory)
+{
+    const size_t size = shared_memory->size();
+    if (size > kMaxPoolSize)
+        return;
+
+    pool_.emplace_back(std::move(shared_memory));
+    pool_size_ += size;
+
+    // The oldest memory is destroyed if the pool is too big.
+    while (pool_size_ > kMaxPoolSize)
+    {
+        pool_size_ -= pool_.front()->size();
+        pool_.erase(pool_.begin());
+    }
+}
+
 } // namespace base
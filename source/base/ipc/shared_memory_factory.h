@@ -23,10 +23,12 @@
 #include "base/memory/local_memory.h"
 
 #include <memory>
+#include <vector>
 
 namespace base {
 
 class SharedMemory;
+class SharedMemoryBase;
 class SharedMemoryFactoryProxy;
 
 class SharedMemoryFactory
@@ -47,8 +49,10 @@ public:
     explicit SharedMemoryFactory(Delegate* delegate);
     ~SharedMemoryFactory();
 
-    // Creates a new shared memory. If an error occurs, nullptr is returned.
-    std::unique_ptr<SharedMemory> create(size_t size);
+    // Creates a new shared memory or takes a released one of the same size class. The content of
+    // the memory is not cleared if it is taken from the pool. If an error occurs, nullptr is
+    // returned.
+    std::unique_ptr<SharedMemoryBase> create(size_t size);
 
     // Opens an existing shared memory.
     // If shared memory does not exist, nullptr is returned.
@@ -59,10 +63,16 @@ private:
     friend class SharedMemoryFactoryProxy;
     void onSharedMemoryCreate(int id);
     void onSharedMemoryDestroy(int id);
+    void onSharedMemoryRelease(std::unique_ptr<SharedMemory> shared_memory);
 
     base::local_shared_ptr<SharedMemoryFactoryProxy> factory_proxy_;
     Delegate* delegate_;
 
+    // Released shared memory in the order of release. It stays open in the other process and is
+    // reused without new notifications.
+    std::vector<std::unique_ptr<SharedMemory>> pool_;
+    size_t pool_size_ = 0;
+
     DISALLOW_COPY_AND_ASSIGN(SharedMemoryFactory);
 };
 
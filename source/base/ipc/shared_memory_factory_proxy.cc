@@ -19,6 +19,7 @@
 #include "base/ipc/shared_memory_factory_proxy.h"
 
 #include "base/logging.h"
+#include "base/ipc/shared_memory.h"
 #include "base/ipc/shared_memory_factory.h"
 
 namespace base {
@@ -60,4 +61,13 @@ void SharedMemoryFactoryProxy::onSharedMemoryDestroy(int id)
     factory_->onSharedMemoryDestroy(id);
 }
 
+//--------------------------------------------------------------------------------------------------
+void SharedMemoryFactoryProxy::onSharedMemoryRelease(std::unique_ptr<SharedMemory> shared_memory)
+{
+    if (!factory_)
+        return;
+
+    factory_->onSharedMemoryRelease(std::move(shared_memory));
+}
+
 } // namespace base
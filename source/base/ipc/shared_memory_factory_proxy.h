@@ -21,8 +21,11 @@
 
 #include "base/macros_magic.h"
 
+#include <memory>
+
 namespace base {
 
+class SharedMemory;
 class SharedMemoryFactory;
 
 class SharedMemoryFactoryProxy
@@ -36,6 +39,10 @@ public:
     void onSharedMemoryCreate(int id);
     void onSharedMemoryDestroy(int id);
 
+    // Returns the shared memory to the pool of the factory. If the factory is already destroyed,
+    // then the shared memory is destroyed.
+    void onSharedMemoryRelease(std::unique_ptr<SharedMemory> shared_memory);
+
 private:
     SharedMemoryFactory* factory_;
 
@@ -0,0 +1,144 @@
+//
+// Aspia Project
+// Copyright (C) 2016-2025 Dmitry Chapyshev <dmitry@aspia.ru>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "base/ipc/shared_memory_factory.h"
+
+#include "base/ipc/shared_memory.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace base {
+
+namespace {
+
+class TestDelegate final : public SharedMemoryFactory::Delegate
+{
+public:
+    TestDelegate() = default;
+    ~TestDelegate() final = default;
+
+    // SharedMemoryFactory::Delegate implementation.
+    void onSharedMemoryCreate(int id) final { created.push_back(id); }
+    void onSharedMemoryDestroy(int id) final { destroyed.push_back(id); }
+
+    std::vector<int> created;
+    std::vector<int> destroyed;
+
+private:
+    DISALLOW_COPY_AND_ASSIGN(TestDelegate);
+};
+
+const size_t kMegabyte = 1024 * 1024;
+
+} // namespace
+
+TEST(shared_memory_factory_test, reuse_without_notifications)
+{
+    TestDelegate delegate;
+    SharedMemoryFactory factory(&delegate);
+
+    std::unique_ptr<SharedMemoryBase> memory = factory.create(kMegabyte);
+    ASSERT_TRUE(memory);
+    ASSERT_NE(memory->data(), nullptr);
+
+    const int id = memory->id();
+    EXPECT_EQ(delegate.created, std::vector<int>({ id }));
+
+    // Released memory stays open and the other process is not notified.
+    memory.reset();
+    EXPECT_TRUE(delegate.destroyed.empty());
+
+    // A slightly smaller size is of the same size class.
+    memory = factory.create(kMegabyte - 100);
+    ASSERT_TRUE(memory);
+    EXPECT_EQ(memory->id(), id);
+    EXPECT_EQ(delegate.created.size(), 1u);
+    EXPECT_TRUE(delegate.destroyed.empty());
+}
+
+TEST(shared_memory_factory_test, different_size_class)
+{
+    TestDelegate delegate;
+    SharedMemoryFactory factory(&delegate);
+
+    std::unique_ptr<SharedMemoryBase> memory = factory.create(kMegabyte);
+    ASSERT_TRUE(memory);
+
+    const int id = memory->id();
+    memory.reset();
+
+    memory = factory.create(2 * kMegabyte);
+    ASSERT_TRUE(memory);
+    EXPECT_NE(memory->id(), id);
+    EXPECT_EQ(delegate.created.size(), 2u);
+    EXPECT_TRUE(delegate.destroyed.empty());
+}
+
+TEST(shared_memory_factory_test, evict_oldest)
+{
+    TestDelegate delegate;
+    SharedMemoryFactory factory(&delegate);
+
+    // Three blocks of 24MB do not fit in the pool of 64MB.
+    std::unique_ptr<SharedMemoryBase> memory1 = factory.create(24 * kMegabyte);
+    std::unique_ptr<SharedMemoryBase> memory2 = factory.create(24 * kMegabyte);
+    std::unique_ptr<SharedMemoryBase> memory3 = factory.create(24 * kMegabyte);
+    ASSERT_TRUE(memory1 && memory2 && memory3);
+    EXPECT_EQ(delegate.created.size(), 3u);
+
+    const int id1 = memory1->id();
+    const int id2 = memory2->id();
+    const int id3 = memory3->id();
+
+    memory1.reset();
+    memory2.reset();
+    EXPECT_TRUE(delegate.destroyed.empty());
+
+    // The memory released first is destroyed.
+    memory3.reset();
+    EXPECT_EQ(delegate.destroyed, std::vector<int>({ id1 }));
+
+    // The memory released last is taken first.
+    std::unique_ptr<SharedMemoryBase> memory = factory.create(24 * kMegabyte);
+    ASSERT_TRUE(memory);
+    EXPECT_EQ(memory->id(), id3);
+
+    memory = factory.create(24 * kMegabyte);
+    ASSERT_TRUE(memory);
+    EXPECT_EQ(memory->id(), id2);
+    EXPECT_EQ(delegate.created.size(), 3u);
+}
+
+TEST(shared_memory_factory_test, too_big_for_pool)
+{
+    TestDelegate delegate;
+    SharedMemoryFactory factory(&delegate);
+
+    std::unique_ptr<SharedMemoryBase> memory = factory.create(80 * kMegabyte);
+    ASSERT_TRUE(memory);
+
+    const int id = memory->id();
+
+    // Memory bigger than the pool is destroyed at once.
+    memory.reset();
+    EXPECT_EQ(delegate.destroyed, std::vector<int>({ id }));
+}
+
+} // namespace base
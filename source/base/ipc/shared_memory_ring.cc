@@ -0,0 +1,180 @@
+//
+// Aspia Project
+// Copyright (C) 2016-2025 Dmitry Chapyshev <dmitry@aspia.ru>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "base/ipc/shared_memory_ring.h"
+
+#include "base/logging.h"
+#include "base/ipc/shared_memory.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <new>
+
+namespace base {
+
+namespace {
+
+const size_t kMinCapacity = 4096;
+const size_t kMaxCapacity = 256 * 1024 * 1024; // 256MB
+
+} // namespace
+
+// Placed at the beginning of the shared memory. The positions are written by different processes,
+// so they are in different cache lines.
+struct SharedMemoryRing::Header
+{
+    uint64_t capacity;
+    alignas(64) std::atomic<uint64_t> write_position;
+    alignas(64) std::atomic<uint64_t> read_position;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+//--------------------------------------------------------------------------------------------------
+SharedMemoryRing::SharedMemoryRing(std::unique_ptr<SharedMemory> shared_memory, size_t capacity)
+    : shared_memory_(std::move(shared_memory)),
+      header_(reinterpret_cast<Header*>(shared_memory_->data())),
+      data_(reinterpret_cast<uint8_t*>(shared_memory_->data()) + sizeof(Header)),
+      capacity_(capacity)
+{
+    DCHECK(std::has_single_bit(capacity_));
+    DCHECK_LE(sizeof(Header) + capacity_, shared_memory_->size());
+}
+
+//--------------------------------------------------------------------------------------------------
+SharedMemoryRing::~SharedMemoryRing() = default;
+
+//--------------------------------------------------------------------------------------------------
+// static
+std::unique_ptr<SharedMemoryRing> SharedMemoryRing::create(size_t capacity)
+{
+    capacity = std::bit_ceil(std::clamp(capacity, kMinCapacity, kMaxCapacity));
+
+    std::unique_ptr<SharedMemory> shared_memory =
+        SharedMemory::create(SharedMemory::Mode::READ_WRITE, sizeof(Header) + capacity);
+    if (!shared_memory)
+    {
+        LOG(LS_ERROR) << "Unable to create shared memory (capacity=" << capacity << ")";
+        return nullptr;
+    }
+
+    Header* header = new (shared_memory->data()) Header();
+    header->capacity = capacity;
+
+    return std::unique_ptr<SharedMemoryRing>(
+        new SharedMemoryRing(std::move(shared_memory), capacity));
+}
+
+//--------------------------------------------------------------------------------------------------
+// static
+std::unique_ptr<SharedMemoryRing> SharedMemoryRing::open(int id)
+{
+    std::unique_ptr<SharedMemory> shared_memory =
+        SharedMemory::open(SharedMemory::Mode::READ_WRITE, id);
+    if (!shared_memory)
+    {
+        LOG(LS_ERROR) << "Unable to open shared memory (id=" << id << ")";
+        return nullptr;
+    }
+
+    if (shared_memory->size() < sizeof(Header))
+    {
+        LOG(LS_ERROR) << "Too small shared memory: " << shared_memory->size();
+        return nullptr;
+    }
+
+    // The capacity is written by the other process. It is read once and checked.
+    uint64_t capacity;
+    memcpy(&capacity, shared_memory->data(), sizeof(capacity));
+
+    if (!std::has_single_bit(capacity) || capacity > kMaxCapacity ||
+        capacity > shared_memory->size() - sizeof(Header))
+    {
+        LOG(LS_ERROR) << "Invalid ring capacity: " << capacity;
+        return nullptr;
+    }
+
+    return std::unique_ptr<SharedMemoryRing>(
+        new SharedMemoryRing(std::move(shared_memory), static_cast<size_t>(capacity)));
+}
+
+//--------------------------------------------------------------------------------------------------
+int SharedMemoryRing::id() const
+{
+    return shared_memory_->id();
+}
+
+//--------------------------------------------------------------------------------------------------
+bool SharedMemoryRing::write(const void* data, size_t size)
+{
+    const uint64_t read_position = header_->read_position.load(std::memory_order_acquire);
+    const uint64_t used = position_ - read_position;
+
+    if (used > capacity_)
+    {
+        LOG(LS_ERROR) << "Invalid read position: " << read_position;
+        return false;
+    }
+
+    if (size > capacity_ - used)
+        return false;
+
+    const size_t offset = static_cast<size_t>(position_ & (capacity_ - 1));
+    const size_t first_part = std::min(size, capacity_ - offset);
+    const uint8_t* source = reinterpret_cast<const uint8_t*>(data);
+
+    // The data can wrap around the end of the ring.
+    memcpy(data_ + offset, source, first_part);
+    memcpy(data_, source + first_part, size - first_part);
+
+    position_ += size;
+    header_->write_position.store(position_, std::memory_order_release);
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+bool SharedMemoryRing::read(void* data, size_t size)
+{
+    const uint64_t write_position = header_->write_position.load(std::memory_order_acquire);
+    const uint64_t available = write_position - position_;
+
+    if (available > capacity_)
+    {
+        LOG(LS_ERROR) << "Invalid write position: " << write_position;
+        return false;
+    }
+
+    if (size > available)
+        return false;
+
+    const size_t offset = static_cast<size_t>(position_ & (capacity_ - 1));
+    const size_t first_part = std::min(size, capacity_ - offset);
+    uint8_t* target = reinterpret_cast<uint8_t*>(data);
+
+    // The data can wrap around the end of the ring.
+    memcpy(target, data_ + offset, first_part);
+    memcpy(target + first_part, data_, size - first_part);
+
+    position_ += size;
+    header_->read_position.store(position_, std::memory_order_release);
+    return true;
+}
+
+} // namespace base
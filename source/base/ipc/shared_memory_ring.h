@@ -0,0 +1,76 @@
+//
+// Aspia Project
+// Copyright (C) 2016-2025 Dmitry Chapyshev <dmitry@aspia.ru>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef BASE_IPC_SHARED_MEMORY_RING_H
+#define BASE_IPC_SHARED_MEMORY_RING_H
+
+#include "base/macros_magic.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace base {
+
+class SharedMemory;
+
+// Ring buffer in shared memory with one writer and one reader in different processes.
+// The ring does not notify the reader. The writer sends the size of each written message by other
+// means (for example, by IpcChannel) and the reader reads exactly this amount of data.
+// The data and positions in shared memory are not trusted: the positions of each side are kept
+// locally and all values received from the other side are checked.
+class SharedMemoryRing
+{
+public:
+    ~SharedMemoryRing();
+
+    // Creates a ring for the writer. |capacity| is rounded up to a power of two.
+    static std::unique_ptr<SharedMemoryRing> create(size_t capacity);
+
+    // Opens the ring created by the writer for the reader.
+    static std::unique_ptr<SharedMemoryRing> open(int id);
+
+    // Id of the shared memory that is passed to the reader.
+    int id() const;
+    size_t capacity() const { return capacity_; }
+
+    // Copies the data to the ring. Returns false if there is not enough free space.
+    bool write(const void* data, size_t size);
+
+    // Copies |size| bytes from the ring. Returns false if the ring contains less data.
+    bool read(void* data, size_t size);
+
+private:
+    struct Header;
+
+    SharedMemoryRing(std::unique_ptr<SharedMemory> shared_memory, size_t capacity);
+
+    std::unique_ptr<SharedMemory> shared_memory_;
+    Header* header_;
+    uint8_t* data_;
+    const size_t capacity_;
+
+    // Write position for the writer or read position for the reader.
+    uint64_t position_ = 0;
+
+    DISALLOW_COPY_AND_ASSIGN(SharedMemoryRing);
+};
+
+} // namespace base
+
+#endif // BASE_IPC_SHARED_MEMORY_RING_H
@@ -0,0 +1,132 @@
+//
+// Aspia Project
+// Copyright (C) 2016-2025 Dmitry Chapyshev <dmitry@aspia.ru>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "base/ipc/shared_memory_ring.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace base {
+
+namespace {
+
+std::vector<uint8_t> createData(size_t size, uint8_t seed)
+{
+    std::vector<uint8_t> data(size);
+
+    for (size_t i = 0; i < size; ++i)
+        data[i] = static_cast<uint8_t>(seed + i);
+
+    return data;
+}
+
+} // namespace
+
+TEST(shared_memory_ring_test, write_and_read)
+{
+    std::unique_ptr<SharedMemoryRing> writer = SharedMemoryRing::create(5000);
+    ASSERT_TRUE(writer);
+    EXPECT_EQ(writer->capacity(), 8192u);
+
+    std::unique_ptr<SharedMemoryRing> reader = SharedMemoryRing::open(writer->id());
+    ASSERT_TRUE(reader);
+    EXPECT_EQ(reader->capacity(), writer->capacity());
+
+    // The sizes are not multiples of the capacity, so the data wraps around the end of the ring.
+    for (int i = 0; i < 100; ++i)
+    {
+        std::vector<uint8_t> data =
+            createData(3000 + static_cast<size_t>(i), static_cast<uint8_t>(i));
+        ASSERT_TRUE(writer->write(data.data(), data.size()));
+
+        std::vector<uint8_t> result(data.size());
+        ASSERT_TRUE(reader->read(result.data(), result.size()));
+        EXPECT_EQ(result, data);
+    }
+}
+
+TEST(shared_memory_ring_test, full_ring)
+{
+    std::unique_ptr<SharedMemoryRing> writer = SharedMemoryRing::create(4096);
+    ASSERT_TRUE(writer);
+
+    std::unique_ptr<SharedMemoryRing> reader = SharedMemoryRing::open(writer->id());
+    ASSERT_TRUE(reader);
+
+    std::vector<uint8_t> data = createData(3000, 1);
+    std::vector<uint8_t> result(data.size());
+
+    ASSERT_TRUE(writer->write(data.data(), data.size()));
+    EXPECT_FALSE(writer->write(data.data(), data.size()));
+
+    // The reader can not read more than it was written.
+    EXPECT_FALSE(reader->read(result.data(), result.size() + 1));
+
+    ASSERT_TRUE(reader->read(result.data(), result.size()));
+    EXPECT_EQ(result, data);
+
+    // The space is free after reading.
+    EXPECT_TRUE(writer->write(data.data(), data.size()));
+}
+
+TEST(shared_memory_ring_test, threads)
+{
+    static const int kMessageCount = 20000;
+
+    std::unique_ptr<SharedMemoryRing> writer = SharedMemoryRing::create(64 * 1024);
+    ASSERT_TRUE(writer);
+
+    std::unique_ptr<SharedMemoryRing> reader = SharedMemoryRing::open(writer->id());
+    ASSERT_TRUE(reader);
+
+    std::thread writer_thread([&writer]()
+    {
+        for (int i = 0; i < kMessageCount; ++i)
+        {
+            std::vector<uint8_t> data = createData(
+                100 + static_cast<size_t>(i % 5000), static_cast<uint8_t>(i));
+
+            while (!writer->write(data.data(), data.size()))
+                std::this_thread::yield();
+        }
+    });
+
+    int errors = 0;
+
+    for (int i = 0; i < kMessageCount; ++i)
+    {
+        std::vector<uint8_t> expected = createData(
+            100 + static_cast<size_t>(i % 5000), static_cast<uint8_t>(i));
+        std::vector<uint8_t> result(expected.size());
+
+        // The size of each message is known to the reader, as it is in IpcChannel.
+        while (!reader->read(result.data(), result.size()))
+            std::this_thread::yield();
+
+        if (result != expected)
+            ++errors;
+    }
+
+    writer_thread.join();
+    EXPECT_EQ(errors, 0);
+}
+
+} // namespace base
@@ -0,0 +1,72 @@
+//
+// Aspia Project
+// Copyright (C) 2016-2025 Dmitry Chapyshev <dmitry@aspia.ru>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "base/log_queue.h"
+
+#include <utility>
+
+namespace base {
+
+//--------------------------------------------------------------------------------------------------
+LogQueue::LogQueue()
+    : head_(new Node()),
+      tail_(head_.load(std::memory_order_relaxed))
+{
+    // Nothing
+}
+
+//--------------------------------------------------------------------------------------------------
+LogQueue::~LogQueue()
+{
+    while (tail_)
+        delete std::exchange(tail_, tail_->next.load(std::memory_order_relaxed));
+}
+
+//--------------------------------------------------------------------------------------------------
+size_t LogQueue::push(LoggingSeverity severity, std::string&& message)
+{
+    const size_t message_size = message.size();
+
+    Node* node = new Node();
+    node->severity = severity;
+    node->message = std::move(message);
+
+    Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+
+    return queued_bytes_.fetch_add(message_size, std::memory_order_relaxed) + message_size;
+}
+
+//--------------------------------------------------------------------------------------------------
+bool LogQueue::pop(LoggingSeverity* severity, std::string* message)
+{
+    Node* next = tail_->next.load(std::memory_order_acquire);
+    if (!next)
+        return false;
+
+    *severity = next->severity;
+    *message = std::move(next->message);
+
+    queued_bytes_.fetch_sub(message->size(), std::memory_order_relaxed);
+
+    // The taken node becomes the new empty tail.
+    delete std::exchange(tail_, next);
+    return true;
+}
+
+} // namespace base
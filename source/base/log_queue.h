@@ -0,0 +1,65 @@
+//
+// Aspia Project
+// Copyright (C) 2016-2025 Dmitry Chapyshev <dmitry@aspia.ru>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef BASE_LOG_QUEUE_H
+#define BASE_LOG_QUEUE_H
+
+#include "base/logging.h"
+#include "base/macros_magic.h"
+
+#include <atomic>
+#include <string>
+
+namespace base {
+
+// Queue of log messages for the writer thread. Any number of threads add messages without
+// locking. Messages are taken out by one thread at a time.
+class LogQueue
+{
+public:
+    LogQueue();
+    ~LogQueue();
+
+    // Returns the size of the queued messages including the added message.
+    size_t push(LoggingSeverity severity, std::string&& message);
+
+    // Must not be called by several threads at the same time. A message whose push has not
+    // completed yet is taken out by the next call.
+    bool pop(LoggingSeverity* severity, std::string* message);
+
+    // Returns the size of the queued messages.
+    size_t queuedBytes() const { return queued_bytes_.load(std::memory_order_relaxed); }
+
+private:
+    struct Node
+    {
+        std::atomic<Node*> next = nullptr;
+        LoggingSeverity severity = LOG_LS_INFO;
+        std::string message;
+    };
+
+    std::atomic<Node*> head_;
+    Node* tail_;
+    std::atomic<size_t> queued_bytes_ = 0;
+
+    DISALLOW_COPY_AND_ASSIGN(LogQueue);
+};
+
+} // namespace base
+
+#endif // BASE_LOG_QUEUE_H
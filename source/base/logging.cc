@@ -21,9 +21,13 @@
 #include "base/debug.h"
 #include "base/endian_util.h"
 #include "base/environment.h"
+#include "base/log_queue.h"
+#include "base/macros_magic.h"
 #include "base/system_time.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/unicode.h"
+#include <atomic>
+#include <condition_variable>
 #include <fstream>
 #include <iomanip>
 #include <mutex>
@@ -47,11 +51,18 @@
 
 namespace base {
 
+std::string logFilePrefix();
+
 namespace {
 
 const LoggingSeverity kDefaultLogLevel = LOG_LS_FATAL;
 const size_t kDefaultMaxLogFileSize = 2 * 1024 * 1024; // 2 Mb.
 const size_t kDefaultMaxLogFileAge = 14; // 14 days.
+const std::chrono::milliseconds kDefaultFlushInterval { 500 };
+
+// The writer thread is woken up before the flush interval expires when the queued messages
+// exceed this size.
+const size_t kMaxQueuedBytes = 256 * 1024;
 
 LoggingSeverity g_min_log_level = LOG_LS_ERROR;
 LoggingDestination g_logging_destination = LOG_DEFAULT;
@@ -65,6 +76,51 @@ std::filesystem::path g_log_file_path;
 std::ofstream g_log_file;
 std::mutex g_log_file_lock;
 
+// Writes the queued messages in batches.
+class LogWriter
+{
+public:
+    explicit LogWriter(const std::chrono::milliseconds& flush_interval);
+    ~LogWriter();
+
+    void wakeup();
+
+private:
+    void threadMain();
+
+    const std::chrono::milliseconds flush_interval_;
+
+    std::mutex wakeup_lock_;
+    std::condition_variable wakeup_event_;
+    bool wakeup_ = false;
+    bool terminating_ = false;
+
+    std::thread thread_;
+
+    DISALLOW_COPY_AND_ASSIGN(LogWriter);
+};
+
+LogQueue g_log_queue;
+
+LogWriter* g_log_writer = nullptr;
+std::atomic<bool> g_async_logging = false;
+
+// Stops the writer thread if the logging is not shut down. Declared after the objects used by the
+// thread, so it is destroyed before them.
+void stopLogWriter();
+
+class LogWriterGuard
+{
+public:
+    LogWriterGuard() = default;
+    ~LogWriterGuard() { stopLogWriter(); }
+
+private:
+    DISALLOW_COPY_AND_ASSIGN(LogWriterGuard);
+};
+
+LogWriterGuard g_log_writer_guard;
+
 //--------------------------------------------------------------------------------------------------
 const char* severityName(LoggingSeverity severity)
 {
@@ -174,6 +230,141 @@ bool initLoggingUnlocked(const std::string& prefix)
     return true;
 }
 
+//--------------------------------------------------------------------------------------------------
+// Must be called under |g_log_file_lock|.
+void writeMessageUnlocked(LoggingSeverity severity, const std::string& message)
+{
+    if ((g_logging_destination & LOG_TO_STDOUT) != 0)
+    {
+        debugPrint(message.data());
+        fwrite(message.data(), message.size(), 1, stderr);
+    }
+    else if (severity >= LOG_LS_ERROR)
+    {
+        // When we're only outputting to a log file, above a certain log level, we
+        // should still output to stderr so that we can better detect and diagnose
+        // problems with unit tests, especially on the buildbots.
+        fwrite(message.data(), message.size(), 1, stderr);
+    }
+
+    // Write to log file.
+    if ((g_logging_destination & LOG_TO_FILE) != 0)
+    {
+        if (static_cast<size_t>(g_log_file.tellp()) >= g_max_log_file_size)
+        {
+            // The maximum size of the log file has been exceeded. Close the current log file and
+            // create a new one.
+            initLoggingUnlocked(logFilePrefix());
+        }
+
+        g_log_file.write(message.c_str(), message.size());
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+// Must be called under |g_log_file_lock|.
+void writeQueuedMessagesUnlocked()
+{
+    LoggingSeverity severity;
+    std::string message;
+
+    while (g_log_queue.pop(&severity, &message))
+        writeMessageUnlocked(severity, message);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Must be called under |g_log_file_lock|.
+void flushUnlocked()
+{
+    fflush(stderr);
+
+    if (g_log_file.is_open())
+        g_log_file.flush();
+}
+
+//--------------------------------------------------------------------------------------------------
+LogWriter::LogWriter(const std::chrono::milliseconds& flush_interval)
+    : flush_interval_(flush_interval),
+      thread_(&LogWriter::threadMain, this)
+{
+    // Nothing
+}
+
+//--------------------------------------------------------------------------------------------------
+LogWriter::~LogWriter()
+{
+    {
+        std::scoped_lock lock(wakeup_lock_);
+        terminating_ = true;
+    }
+
+    wakeup_event_.notify_one();
+    thread_.join();
+}
+
+//--------------------------------------------------------------------------------------------------
+void LogWriter::wakeup()
+{
+    {
+        std::scoped_lock lock(wakeup_lock_);
+        wakeup_ = true;
+    }
+
+    wakeup_event_.notify_one();
+}
+
+//--------------------------------------------------------------------------------------------------
+void LogWriter::threadMain()
+{
+    std::unique_lock lock(wakeup_lock_);
+
+    while (true)
+    {
+        wakeup_event_.wait_for(lock, flush_interval_, [this]()
+        {
+            return wakeup_ || terminating_;
+        });
+
+        wakeup_ = false;
+        const bool terminating = terminating_;
+
+        lock.unlock();
+
+        {
+            std::scoped_lock file_lock(g_log_file_lock);
+            writeQueuedMessagesUnlocked();
+            flushUnlocked();
+        }
+
+        if (terminating)
+            break;
+
+        lock.lock();
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+// Writes all queued messages and stops the writer thread. Does nothing if it is already stopped.
+void stopLogWriter()
+{
+    // Messages logged after this are written immediately.
+    g_async_logging.store(false, std::memory_order_release);
+
+    LogWriter* log_writer;
+
+    {
+        std::scoped_lock lock(g_log_file_lock);
+        log_writer = std::exchange(g_log_writer, nullptr);
+    }
+
+    // The writer writes all queued messages before it exits.
+    delete log_writer;
+
+    std::scoped_lock lock(g_log_file_lock);
+    writeQueuedMessagesUnlocked();
+    flushUnlocked();
+}
+
 } // namespace
 
 // This is never instantiated, it's just used for EAT_STREAM_PARAMETERS to have
@@ -185,7 +376,8 @@ std::ostream* g_swallow_stream;
 LoggingSettings::LoggingSettings()
     : min_log_level(kDefaultLogLevel),
       max_log_file_size(kDefaultMaxLogFileSize),
-      max_log_file_age(kDefaultMaxLogFileAge)
+      max_log_file_age(kDefaultMaxLogFileAge),
+      flush_interval(kDefaultFlushInterval)
 {
     std::string log_level_string;
     if (Environment::get("ASPIA_LOG_LEVEL", &log_level_string))
@@ -255,6 +447,17 @@ LoggingSettings::LoggingSettings()
             max_log_file_age = static_cast<size_t>(std::min(value, 366ULL));
         }
     }
+
+    std::string flush_interval_string;
+    if (Environment::get("ASPIA_LOG_FLUSH_INTERVAL", &flush_interval_string))
+    {
+        unsigned long long value;
+        if (stringToULong64(flush_interval_string, &value))
+        {
+            // Milliseconds, zero disables the background writing.
+            flush_interval = std::chrono::milliseconds(std::min(value, 60000ULL));
+        }
+    }
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -306,6 +509,13 @@ bool initLogging(const LoggingSettings& settings)
 
         if (!initLoggingUnlocked(logFilePrefix()))
             return false;
+
+        if (settings.flush_interval.count() > 0 && g_logging_destination != LOG_NONE &&
+            !g_log_writer)
+        {
+            g_log_writer = new LogWriter(settings.flush_interval);
+            g_async_logging.store(true, std::memory_order_release);
+        }
     }
 
     LOG(LS_INFO) << "Executable file: " << execFilePath();
@@ -315,6 +525,7 @@ bool initLogging(const LoggingSettings& settings)
         LOG(LS_INFO) << "Logging file: " << g_log_file_path;
     }
     LOG(LS_INFO) << "Logging level: " << g_min_log_level;
+    LOG(LS_INFO) << "Flush interval: " << settings.flush_interval.count() << " ms";
     LOG(LS_INFO) << "Debugger present: " << (isDebuggerPresent() ? "Yes" : "No");
 
 #if defined(NDEBUG)
@@ -333,6 +544,8 @@ void shutdownLogging()
 {
     LOG(LS_INFO) << "Logging finished";
 
+    stopLogWriter();
+
     std::scoped_lock lock(g_log_file_lock);
     g_log_file.close();
 }
@@ -467,36 +680,29 @@ LogMessage::~LogMessage()
 
     std::string message(stream_.str());
 
-    if ((g_logging_destination & LOG_TO_STDOUT) != 0)
+    if (severity_ < LOG_LS_ERROR && g_async_logging.load(std::memory_order_acquire))
     {
-        debugPrint(message.data());
+        // The message is written by the writer thread.
+        const size_t message_size = message.size();
+        const size_t queued_bytes = g_log_queue.push(severity_, std::move(message));
 
-        fwrite(message.data(), message.size(), 1, stderr);
-        fflush(stderr);
-    }
-    else if (severity_ >= LOG_LS_ERROR)
-    {
-        // When we're only outputting to a log file, above a certain log level, we
-        // should still output to stderr so that we can better detect and diagnose
-        // problems with unit tests, especially on the buildbots.
-        fwrite(message.data(), message.size(), 1, stderr);
-        fflush(stderr);
+        // Only the message that crossed the limit wakes up the writer.
+        if (queued_bytes >= kMaxQueuedBytes && queued_bytes - message_size < kMaxQueuedBytes)
+        {
+            std::scoped_lock lock(g_log_file_lock);
+            if (g_log_writer)
+                g_log_writer->wakeup();
+        }
+        return;
     }
 
-    // Write to log file.
-    if ((g_logging_destination & LOG_TO_FILE) != 0)
     {
         std::scoped_lock lock(g_log_file_lock);
 
-        if (static_cast<size_t>(g_log_file.tellp()) >= g_max_log_file_size)
-        {
-            // The maximum size of the log file has been exceeded. Close the current log file and
-            // create a new one.
-            initLoggingUnlocked(logFilePrefix());
-        }
-
-        g_log_file.write(message.c_str(), message.size());
-        g_log_file.flush();
+        // Earlier messages are written first. Errors are flushed immediately.
+        writeQueuedMessagesUnlocked();
+        writeMessageUnlocked(severity_, message);
+        flushUnlocked();
     }
 
     if (severity_ == LOG_LS_FATAL)
@@ -22,6 +22,7 @@
 #include "base/scoped_clear_last_error.h"
 #include "base/system_error.h"
 
+#include <chrono>
 #include <filesystem>
 #include <sstream>
 #include <string>
@@ -127,6 +128,7 @@ struct LoggingSettings
     //  min_log_level: LOG_LS_INFO
     //  max_log_file_size: 2 Mb
     //  max_log_file_age: 14 days
+    //  flush_interval: 500 ms
     LoggingSettings();
 
     LoggingDestination destination;
@@ -136,6 +138,11 @@ struct LoggingSettings
 
     size_t max_log_file_size;
     size_t max_log_file_age;
+
+    // Messages below LOG_LS_ERROR are queued and written by a background thread at least once per
+    // this interval. Errors are written immediately together with all queued messages. A zero
+    // interval writes and flushes every message on the calling thread.
+    std::chrono::milliseconds flush_interval;
 };
 
 // Sets the log file name and other global logging state. Calling this function is recommended,
@@ -0,0 +1,186 @@
+//
+// Aspia Project
+// Copyright (C) 2016-2025 Dmitry Chapyshev <dmitry@aspia.ru>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "base/logging.h"
+#include "base/log_queue.h"
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace base {
+
+namespace {
+
+//--------------------------------------------------------------------------------------------------
+std::string readFile(const std::filesystem::path& path)
+{
+    std::ifstream file(path);
+    std::ostringstream stream;
+    stream << file.rdbuf();
+    return stream.str();
+}
+
+//--------------------------------------------------------------------------------------------------
+std::filesystem::path uniqueLogDir()
+{
+    std::filesystem::path path = std::filesystem::temp_directory_path();
+    path.append("aspia_logging_unittest_" +
+                std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+    return path;
+}
+
+} // namespace
+
+TEST(LogQueueTest, Empty)
+{
+    LogQueue queue;
+
+    LoggingSeverity severity;
+    std::string message;
+    EXPECT_FALSE(queue.pop(&severity, &message));
+    EXPECT_EQ(queue.queuedBytes(), 0u);
+}
+
+TEST(LogQueueTest, Order)
+{
+    LogQueue queue;
+
+    EXPECT_EQ(queue.push(LOG_LS_INFO, "first"), 5u);
+    EXPECT_EQ(queue.push(LOG_LS_ERROR, "second"), 11u);
+    EXPECT_EQ(queue.push(LOG_LS_INFO, "third"), 16u);
+
+    LoggingSeverity severity;
+    std::string message;
+
+    ASSERT_TRUE(queue.pop(&severity, &message));
+    EXPECT_EQ(severity, LOG_LS_INFO);
+    EXPECT_EQ(message, "first");
+    EXPECT_EQ(queue.queuedBytes(), 11u);
+
+    ASSERT_TRUE(queue.pop(&severity, &message));
+    EXPECT_EQ(severity, LOG_LS_ERROR);
+    EXPECT_EQ(message, "second");
+
+    ASSERT_TRUE(queue.pop(&severity, &message));
+    EXPECT_EQ(severity, LOG_LS_INFO);
+    EXPECT_EQ(message, "third");
+
+    EXPECT_FALSE(queue.pop(&severity, &message));
+    EXPECT_EQ(queue.queuedBytes(), 0u);
+}
+
+TEST(LogQueueTest, OrderOfEachThread)
+{
+    static const int kThreadCount = 4;
+    static const int kMessageCount = 10000;
+
+    LogQueue queue;
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < kThreadCount; ++i)
+    {
+        threads.emplace_back([&queue, i]()
+        {
+            for (int j = 0; j < kMessageCount; ++j)
+                queue.push(i, std::to_string(j));
+        });
+    }
+
+    std::vector<int> next(kThreadCount, 0);
+    int count = 0;
+
+    // Messages are taken out while the threads still add them.
+    while (count < kThreadCount * kMessageCount)
+    {
+        LoggingSeverity severity;
+        std::string message;
+
+        if (!queue.pop(&severity, &message))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        ASSERT_GE(severity, 0);
+        ASSERT_LT(severity, kThreadCount);
+        EXPECT_EQ(message, std::to_string(next[severity]));
+
+        ++next[severity];
+        ++count;
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    for (int i = 0; i < kThreadCount; ++i)
+        EXPECT_EQ(next[i], kMessageCount);
+
+    EXPECT_EQ(queue.queuedBytes(), 0u);
+}
+
+TEST(LoggingTest, Flush)
+{
+    LoggingSettings settings;
+    settings.destination = LOG_TO_FILE;
+    settings.min_log_level = LOG_LS_INFO;
+    settings.log_dir = uniqueLogDir();
+    settings.max_log_file_age = 0;
+    settings.flush_interval = std::chrono::hours(1);
+
+    ASSERT_TRUE(initLogging(settings));
+
+    LOG(LS_INFO) << "queued message 1";
+    LOG(LS_INFO) << "queued message 2";
+
+    // An error writes the queued messages before itself.
+    LOG(LS_ERROR) << "error message";
+
+    std::string content = readFile(loggingFile());
+    size_t pos1 = content.find("queued message 1");
+    size_t pos2 = content.find("queued message 2");
+    size_t pos3 = content.find("error message");
+
+    ASSERT_NE(pos1, std::string::npos);
+    ASSERT_NE(pos2, std::string::npos);
+    ASSERT_NE(pos3, std::string::npos);
+    EXPECT_LT(pos1, pos2);
+    EXPECT_LT(pos2, pos3);
+
+    LOG(LS_INFO) << "queued message 3";
+
+    // Shutdown writes all queued messages.
+    shutdownLogging();
+
+    content = readFile(loggingFile());
+    size_t pos4 = content.find("queued message 3");
+
+    ASSERT_NE(pos4, std::string::npos);
+    EXPECT_LT(pos3, pos4);
+
+    std::error_code ignored_code;
+    std::filesystem::remove_all(settings.log_dir, ignored_code);
+
+    // Restore the logging of the other tests.
+    initLogging();
+}
+
+} // namespace base
@@ -19,6 +19,8 @@
 #ifndef BASE_MEMORY_BYTE_ARRAY_H
 #define BASE_MEMORY_BYTE_ARRAY_H
 
+#include "base/memory/byte_array_pool.h"
+
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -27,7 +29,10 @@
 
 namespace base {
 
-using ByteArray = std::vector<uint8_t>;
+// The memory of arrays is taken from ByteArrayPool. ByteArray(size) and resize(size) do not
+// initialize the new elements, use ByteArray(size, value) and resize(size, value) if the content
+// must be filled.
+using ByteArray = std::vector<uint8_t, ByteArrayAllocator<uint8_t>>;
 
 ByteArray fromData(const void* data, size_t size);
 
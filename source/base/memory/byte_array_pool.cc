@@ -0,0 +1,248 @@
+//
+// Aspia Project
+// Copyright (C) 2016-2025 Dmitry Chapyshev <dmitry@aspia.ru>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "base/memory/byte_array_pool.h"
+
+#include "base/memory/size_class.h"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <mutex>
+#include <vector>
+
+namespace base {
+
+namespace {
+
+// Size classes from 64 bytes to ByteArrayPool::kMaxBlockSize, four classes per power of two.
+const size_t kClassCount = (std::bit_width(ByteArrayPool::kMaxBlockSize) - 7) * 4 + 1;
+
+// Maximum number of blocks of one class in the cache of a thread.
+const size_t kMaxThreadBlocks = 16;
+
+// Total size of the blocks in the cache of a thread.
+const size_t kMaxThreadCacheSize = 4 * 1024 * 1024; // 4MB
+
+// Total size of the blocks in the common cache.
+const size_t kMaxCommonCacheSize = 32 * 1024 * 1024; // 32MB
+
+std::atomic_uint64_t allocations = 0;
+std::atomic_uint64_t deallocations = 0;
+std::atomic_uint64_t reuses = 0;
+
+//--------------------------------------------------------------------------------------------------
+size_t classIndex(size_t size_class)
+{
+    const int shift = std::bit_width(size_class) - 3;
+    return static_cast<size_t>(shift - 4) * 4 + ((size_class >> shift) & 3);
+}
+
+//--------------------------------------------------------------------------------------------------
+void* systemAllocate(size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return ::operator new(size);
+}
+
+//--------------------------------------------------------------------------------------------------
+void systemDeallocate(void* block)
+{
+    deallocations.fetch_add(1, std::memory_order_relaxed);
+    ::operator delete(block);
+}
+
+class CommonCache
+{
+public:
+    void* take(size_t index)
+    {
+        std::scoped_lock lock(lock_);
+
+        std::vector<void*>& blocks = blocks_[index];
+        if (blocks.empty())
+            return nullptr;
+
+        void* block = blocks.back();
+        blocks.pop_back();
+        size_ -= sizeOfClass(index);
+        return block;
+    }
+
+    bool put(void* block, size_t index)
+    {
+        std::scoped_lock lock(lock_);
+
+        const size_t size = sizeOfClass(index);
+        if (size_ + size > kMaxCommonCacheSize)
+            return false;
+
+        blocks_[index].push_back(block);
+        size_ += size;
+        return true;
+    }
+
+    static size_t sizeOfClass(size_t index)
+    {
+        return static_cast<size_t>(4 + (index & 3)) << (index / 4 + 4);
+    }
+
+private:
+    std::mutex lock_;
+    std::array<std::vector<void*>, kClassCount> blocks_;
+    size_t size_ = 0;
+};
+
+//--------------------------------------------------------------------------------------------------
+CommonCache& commonCache()
+{
+    // The cache is never destroyed, because blocks can be freed by static objects and by threads
+    // that finish after the exit from main().
+    static CommonCache* cache = new CommonCache();
+    return *cache;
+}
+
+class ThreadCache
+{
+public:
+    ThreadCache() = default;
+
+    ~ThreadCache()
+    {
+        is_destroyed_ = true;
+
+        // Blocks of a finished thread can be used by other threads.
+        for (size_t index = 0; index < kClassCount; ++index)
+        {
+            for (void* block : blocks_[index])
+            {
+                if (!commonCache().put(block, index))
+                    systemDeallocate(block);
+            }
+        }
+    }
+
+    // Returns nullptr if the cache of the current thread is already destroyed.
+    static ThreadCache* current()
+    {
+        if (is_destroyed_)
+            return nullptr;
+
+        static thread_local ThreadCache cache;
+        return &cache;
+    }
+
+    void* take(size_t index)
+    {
+        std::vector<void*>& blocks = blocks_[index];
+        if (blocks.empty())
+            return nullptr;
+
+        void* block = blocks.back();
+        blocks.pop_back();
+        size_ -= CommonCache::sizeOfClass(index);
+        return block;
+    }
+
+    bool put(void* block, size_t index)
+    {
+        std::vector<void*>& blocks = blocks_[index];
+        const size_t size = CommonCache::sizeOfClass(index);
+
+        if (blocks.size() >= kMaxThreadBlocks || size_ + size > kMaxThreadCacheSize)
+            return false;
+
+        if (blocks.capacity() == 0)
+            blocks.reserve(kMaxThreadBlocks);
+
+        blocks.push_back(block);
+        size_ += size;
+        return true;
+    }
+
+private:
+    static thread_local bool is_destroyed_;
+
+    std::array<std::vector<void*>, kClassCount> blocks_;
+    size_t size_ = 0;
+};
+
+thread_local bool ThreadCache::is_destroyed_ = false;
+
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+// static
+void* ByteArrayPool::allocate(size_t size)
+{
+    if (size > kMaxBlockSize)
+        return systemAllocate(size);
+
+    const size_t size_class = sizeClass(size);
+    const size_t index = classIndex(size_class);
+
+    ThreadCache* thread_cache = ThreadCache::current();
+    void* block = thread_cache ? thread_cache->take(index) : nullptr;
+
+    if (!block)
+        block = commonCache().take(index);
+
+    if (!block)
+        return systemAllocate(size_class);
+
+    reuses.fetch_add(1, std::memory_order_relaxed);
+    return block;
+}
+
+//--------------------------------------------------------------------------------------------------
+// static
+void ByteArrayPool::deallocate(void* block, size_t size)
+{
+    if (!block)
+        return;
+
+    if (size > kMaxBlockSize)
+    {
+        systemDeallocate(block);
+        return;
+    }
+
+    const size_t index = classIndex(sizeClass(size));
+
+    ThreadCache* thread_cache = ThreadCache::current();
+    if (thread_cache && thread_cache->put(block, index))
+        return;
+
+    if (commonCache().put(block, index))
+        return;
+
+    systemDeallocate(block);
+}
+
+//--------------------------------------------------------------------------------------------------
+// static
+ByteArrayPool::Statistics ByteArrayPool::statistics()
+{
+    Statistics statistics;
+    statistics.allocations = allocations.load(std::memory_order_relaxed);
+    statistics.deallocations = deallocations.load(std::memory_order_relaxed);
+    statistics.reuses = reuses.load(std::memory_order_relaxed);
+    return statistics;
+}
+
+} // namespace base
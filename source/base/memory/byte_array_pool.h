@@ -0,0 +1,110 @@
+//
+// Aspia Project
+// Copyright (C) 2016-2025 Dmitry Chapyshev <dmitry@aspia.ru>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef BASE_MEMORY_BYTE_ARRAY_POOL_H
+#define BASE_MEMORY_BYTE_ARRAY_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace base {
+
+// Pool of memory blocks for ByteArray. Blocks are kept by size class in a cache of the current
+// thread and in a common cache, so buffers that are freed on one thread (for example, messages
+// written by a network channel) are reused by other threads (for example, a serializer).
+class ByteArrayPool
+{
+public:
+    // Blocks larger than this are allocated and freed without the pool.
+    static const size_t kMaxBlockSize = 4 * 1024 * 1024; // 4MB
+
+    static void* allocate(size_t size);
+    static void deallocate(void* block, size_t size);
+
+    struct Statistics
+    {
+        // Blocks allocated from the system.
+        uint64_t allocations = 0;
+        // Blocks returned to the system.
+        uint64_t deallocations = 0;
+        // Blocks taken from the pool.
+        uint64_t reuses = 0;
+    };
+
+    // Returns the counters of the pool since the start of the process.
+    static Statistics statistics();
+
+private:
+    ByteArrayPool() = delete;
+};
+
+// Allocator for ByteArray. Memory is taken from ByteArrayPool and the elements are not
+// initialized when the array grows by resize() or is created with a size. The content of the new
+// elements is undefined until it is written.
+template <class T>
+class ByteArrayAllocator
+{
+public:
+    static_assert(std::is_trivial_v<T>);
+
+    using value_type = T;
+
+    ByteArrayAllocator() noexcept = default;
+
+    template <class U>
+    ByteArrayAllocator(const ByteArrayAllocator<U>& /* other */) noexcept
+    {
+        // Nothing
+    }
+
+    T* allocate(size_t count)
+    {
+        if (count > SIZE_MAX / sizeof(T))
+            throw std::bad_array_new_length();
+
+        return static_cast<T*>(ByteArrayPool::allocate(count * sizeof(T)));
+    }
+
+    void deallocate(T* block, size_t count) noexcept
+    {
+        ByteArrayPool::deallocate(block, count * sizeof(T));
+    }
+
+    // Default initialization instead of value initialization.
+    template <class U>
+    void construct(U* ptr) noexcept(std::is_nothrow_default_constructible_v<U>)
+    {
+        ::new (static_cast<void*>(ptr)) U;
+    }
+
+    template <class U, class... Args>
+    void construct(U* ptr, Args&&... args)
+    {
+        ::new (static_cast<void*>(ptr)) U(std::forward<Args>(args)...);
+    }
+
+    template <class U>
+    bool operator==(const ByteArrayAllocator<U>& /* other */) const noexcept { return true; }
+};
+
+} // namespace base
+
+#endif // BASE_MEMORY_BYTE_ARRAY_POOL_H
@@ -0,0 +1,144 @@
+//
+// Aspia Project
+// Copyright (C) 2016-2025 Dmitry Chapyshev <dmitry@aspia.ru>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "base/memory/byte_array_pool.h"
+
+#include "base/memory/byte_array.h"
+
+#include <gtest/gtest.h>
+
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <queue>
+#include <thread>
+
+namespace base {
+
+TEST(byte_array_pool_test, reuse)
+{
+    ByteArray buffer(1000);
+    const uint8_t* data = buffer.data();
+    buffer = ByteArray();
+
+    ByteArrayPool::Statistics before = ByteArrayPool::statistics();
+
+    // A buffer of the same size class gets the same memory.
+    buffer.resize(990);
+    EXPECT_EQ(buffer.data(), data);
+
+    ByteArrayPool::Statistics after = ByteArrayPool::statistics();
+    EXPECT_EQ(after.allocations, before.allocations);
+    EXPECT_EQ(after.reuses, before.reuses + 1);
+}
+
+TEST(byte_array_pool_test, fill)
+{
+    ByteArray buffer(4096);
+    memset(buffer.data(), 0xAA, buffer.size());
+    buffer = ByteArray();
+
+    // The explicit value is used for the new elements.
+    buffer.resize(4096, 0);
+    for (uint8_t value : buffer)
+        ASSERT_EQ(value, 0);
+
+    ByteArray other(100, 0x55);
+    for (uint8_t value : other)
+        ASSERT_EQ(value, 0x55);
+}
+
+TEST(byte_array_pool_test, large_buffer)
+{
+    ByteArrayPool::Statistics before = ByteArrayPool::statistics();
+
+    {
+        ByteArray buffer(ByteArrayPool::kMaxBlockSize + 1);
+        buffer.back() = 1;
+    }
+
+    ByteArrayPool::Statistics after = ByteArrayPool::statistics();
+    EXPECT_EQ(after.allocations, before.allocations + 1);
+    EXPECT_EQ(after.deallocations, before.deallocations + 1);
+}
+
+TEST(byte_array_pool_test, steady_state_between_threads)
+{
+    static const int kWarmupCount = 1000;
+    static const int kMessageCount = 10000;
+    static const size_t kMaxQueueSize = 8;
+
+    std::mutex lock;
+    std::condition_variable event;
+    std::queue<ByteArray> queue;
+    bool finished = false;
+
+    // The buffers are created on the current thread and destroyed on another thread, like
+    // serialized messages that are written by a channel.
+    std::thread writer([&]()
+    {
+        for (;;)
+        {
+            ByteArray buffer;
+
+            {
+                std::unique_lock lock_guard(lock);
+                event.wait(lock_guard, [&]() { return !queue.empty() || finished; });
+
+                if (queue.empty())
+                    return;
+
+                buffer = std::move(queue.front());
+                queue.pop();
+            }
+
+            event.notify_all();
+        }
+    });
+
+    ByteArrayPool::Statistics statistics;
+
+    for (int i = 0; i < kWarmupCount + kMessageCount; ++i)
+    {
+        if (i == kWarmupCount)
+            statistics = ByteArrayPool::statistics();
+
+        ByteArray buffer(static_cast<size_t>(100 + (i % 7) * 1000));
+        memset(buffer.data(), i, buffer.size());
+
+        std::unique_lock lock_guard(lock);
+        event.wait(lock_guard, [&]() { return queue.size() < kMaxQueueSize; });
+        queue.emplace(std::move(buffer));
+        event.notify_all();
+    }
+
+    {
+        std::scoped_lock lock_guard(lock);
+        finished = true;
+    }
+
+    event.notify_all();
+    writer.join();
+
+    // The blocks move from the cache of the writer thread to the common cache and back, so the
+    // memory is not allocated again.
+    EXPECT_LE(ByteArrayPool::statistics().allocations - statistics.allocations,
+              kMaxQueueSize * 7);
+}
+
+} // namespace base
@@ -21,11 +21,7 @@
 namespace base {
 
 //--------------------------------------------------------------------------------------------------
-Serializer::Serializer()
-{
-    for (size_t i = 0; i < kPoolSize; ++i)
-        pool_[i].reserve(kBufferSize);
-}
+Serializer::Serializer() = default;
 
 //--------------------------------------------------------------------------------------------------
 Serializer::~Serializer() = default;
@@ -37,32 +33,11 @@ base::ByteArray Serializer::serialize(const google::protobuf::MessageLite& messa
     if (!size)
         return base::ByteArray();
 
-    base::ByteArray buffer;
-
-    if (free_)
-    {
-        buffer = std::move(pool_[free_ - 1]);
-
-        if (buffer.capacity() < size)
-            buffer.reserve(size);
-
-        --free_;
-    }
-
-    buffer.resize(size);
+    // The buffer is not filled with zeros before serialization.
+    base::ByteArray buffer(size);
 
     message.SerializeWithCachedSizesToArray(buffer.data());
     return buffer;
 }
 
-//--------------------------------------------------------------------------------------------------
-void Serializer::addBuffer(base::ByteArray&& buffer)
-{
-    if (free_ < kPoolSize)
-    {
-        pool_[free_] = std::move(buffer);
-        ++free_;
-    }
-}
-
 } // namespace base
@@ -22,8 +22,6 @@
 #include "base/macros_magic.h"
 #include "base/memory/byte_array.h"
 
-#include <array>
-
 namespace base {
 
 class Serializer
@@ -32,16 +30,12 @@ public:
     Serializer();
     ~Serializer();
 
-    static constexpr size_t kPoolSize = 32;
-    static constexpr size_t kBufferSize = 1024;
-
+    // Serializes the message into a buffer. The memory of the buffer is taken from ByteArrayPool
+    // and is returned there when the buffer is destroyed (usually after it is written to a
+    // channel).
     base::ByteArray serialize(const google::protobuf::MessageLite& message);
-    void addBuffer(base::ByteArray&& buffer);
 
 private:
-    std::array<base::ByteArray, kPoolSize> pool_;
-    size_t free_ = kPoolSize;
-
     DISALLOW_COPY_AND_ASSIGN(Serializer);
 };
 
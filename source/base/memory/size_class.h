@@ -0,0 +1,43 @@
+//
+// Aspia Project
+// Copyright (C) 2016-2025 Dmitry Chapyshev <dmitry@aspia.ru>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef BASE_MEMORY_SIZE_CLASS_H
+#define BASE_MEMORY_SIZE_CLASS_H
+
+#include <bit>
+#include <cstddef>
+
+namespace base {
+
+// Rounds |size| up to its size class. Pools keep released buffers by size class, so a buffer is
+// reused for requests of a slightly different size. Classes are spaced by a quarter of a power of
+// two and a buffer is at most 25% bigger than requested.
+inline size_t sizeClass(size_t size)
+{
+    static const size_t kMinSizeClass = 64;
+
+    if (size <= kMinSizeClass)
+        return kMinSizeClass;
+
+    const size_t step = std::bit_floor(size) / 4;
+    return (size + step - 1) & ~(step - 1);
+}
+
+} // namespace base
+
+#endif // BASE_MEMORY_SIZE_CLASS_H
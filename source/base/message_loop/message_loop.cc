@@ -179,7 +179,7 @@ std::shared_ptr<TaskRunner> MessageLoop::taskRunner() const
 }
 
 //--------------------------------------------------------------------------------------------------
-void MessageLoop::runTask(const PendingTask& pending_task)
+void MessageLoop::runTask(PendingTask&& pending_task)
 {
     DCHECK(nestable_tasks_allowed_);
 
@@ -192,11 +192,11 @@ void MessageLoop::runTask(const PendingTask& pending_task)
 }
 
 //--------------------------------------------------------------------------------------------------
-bool MessageLoop::deferOrRunPendingTask(const PendingTask& pending_task)
+bool MessageLoop::deferOrRunPendingTask(PendingTask&& pending_task)
 {
     if (pending_task.nestable)
     {
-        runTask(pending_task);
+        runTask(std::move(pending_task));
 
         // Show that we ran a task (Note: a new one might arrive as a consequence!).
         return true;
@@ -204,7 +204,7 @@ bool MessageLoop::deferOrRunPendingTask(const PendingTask& pending_task)
 
     // We couldn't run the task now because we're in a nested message loop
     // and the task isn't nestable.
-    deferred_non_nestable_work_queue_.emplace(pending_task);
+    deferred_non_nestable_work_queue_.emplace(std::move(pending_task));
     return false;
 }
 
@@ -265,7 +265,7 @@ bool MessageLoop::deletePendingTasks()
 
     while (!work_queue_.empty())
     {
-        PendingTask pending_task = work_queue_.front();
+        PendingTask pending_task = std::move(work_queue_.front());
         work_queue_.pop();
 
         if (pending_task.delayed_run_time != TimePoint())
@@ -320,7 +320,7 @@ bool MessageLoop::doWork()
         // Execute oldest task.
         do
         {
-            PendingTask pending_task = work_queue_.front();
+            PendingTask pending_task = std::move(work_queue_.front());
             work_queue_.pop();
 
             if (pending_task.delayed_run_time != TimePoint())
@@ -335,7 +335,7 @@ bool MessageLoop::doWork()
             }
             else
             {
-                if (deferOrRunPendingTask(pending_task))
+                if (deferOrRunPendingTask(std::move(pending_task)))
                     return true;
             }
         }
@@ -373,13 +373,15 @@ bool MessageLoop::doDelayedWork(TimePoint* next_delayed_work_time)
         }
     }
 
-    PendingTask pending_task = delayed_work_queue_.top();
+    // std::priority_queue only gives const access to the top task. Moving the callback out of it
+    // is safe: the ordering fields stay untouched until the task is popped.
+    PendingTask pending_task = std::move(const_cast<PendingTask&>(delayed_work_queue_.top()));
     delayed_work_queue_.pop();
 
     if (!delayed_work_queue_.empty())
         *next_delayed_work_time = delayed_work_queue_.top().delayed_run_time;
 
-    return deferOrRunPendingTask(pending_task);
+    return deferOrRunPendingTask(std::move(pending_task));
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -388,10 +390,10 @@ bool MessageLoop::doIdleWork()
     if (deferred_non_nestable_work_queue_.empty())
         return false;
 
-    PendingTask pending_task = deferred_non_nestable_work_queue_.front();
+    PendingTask pending_task = std::move(deferred_non_nestable_work_queue_.front());
     deferred_non_nestable_work_queue_.pop();
 
-    runTask(pending_task);
+    runTask(std::move(pending_task));
     return true;
 }
 
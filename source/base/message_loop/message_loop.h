@@ -83,11 +83,11 @@ protected:
     PendingTask::Callback quitClosure();
 
     // Runs the specified PendingTask.
-    void runTask(const PendingTask& pending_task);
+    void runTask(PendingTask&& pending_task);
 
     // Calls RunTask or queues the pending_task on the deferred task list if it cannot be run right
     // now. Returns true if the task was run.
-    bool deferOrRunPendingTask(const PendingTask& pending_task);
+    bool deferOrRunPendingTask(PendingTask&& pending_task);
 
     // Adds the pending task to delayed_work_queue_.
     void addToDelayedWorkQueue(PendingTask* pending_task);
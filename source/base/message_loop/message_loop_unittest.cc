@@ -0,0 +1,187 @@
+//
+// Aspia Project
+// Copyright (C) 2016-2025 Dmitry Chapyshev <dmitry@aspia.ru>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "base/message_loop/message_loop.h"
+
+#include "base/task_runner.h"
+#include "base/threading/thread.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace base {
+
+namespace {
+
+class CopyCounter
+{
+public:
+    explicit CopyCounter(int* copy_count)
+        : copy_count_(copy_count)
+    {
+        // Nothing
+    }
+
+    CopyCounter(const CopyCounter& other)
+        : copy_count_(other.copy_count_)
+    {
+        ++*copy_count_;
+    }
+
+    CopyCounter(CopyCounter&& other) = default;
+
+    void operator()() const
+    {
+        // Nothing
+    }
+
+private:
+    int* copy_count_;
+};
+
+// Posts |tasks_per_thread| tasks from each of |thread_count| threads and waits until all of them
+// are done. Returns false if the tasks of some thread have been run out of order.
+bool postFromThreads(std::shared_ptr<TaskRunner> task_runner,
+                     int thread_count,
+                     int tasks_per_thread)
+{
+    std::vector<int> last_index(static_cast<size_t>(thread_count), -1);
+    std::atomic_bool in_order = true;
+    std::atomic_int tasks_left = thread_count * tasks_per_thread;
+    std::promise<void> finished;
+
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < thread_count; ++i)
+    {
+        threads.emplace_back([&, i]()
+        {
+            for (int j = 0; j < tasks_per_thread; ++j)
+            {
+                task_runner->postTask([&, i, j]()
+                {
+                    // Tasks are run on a single thread.
+                    int& last = last_index[static_cast<size_t>(i)];
+                    if (last + 1 != j)
+                        in_order = false;
+                    last = j;
+
+                    if (--tasks_left == 0)
+                        finished.set_value();
+                });
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    finished.get_future().wait();
+    return in_order;
+}
+
+} // namespace
+
+TEST(message_loop_test, post_from_threads)
+{
+    Thread thread;
+    thread.start(MessageLoop::Type::DEFAULT);
+
+    EXPECT_TRUE(postFromThreads(thread.taskRunner(), 4, 10000));
+
+    thread.stop();
+}
+
+TEST(message_loop_test, delayed_tasks)
+{
+    Thread thread;
+    thread.start(MessageLoop::Type::DEFAULT);
+
+    std::shared_ptr<TaskRunner> task_runner = thread.taskRunner();
+    std::vector<int> order;
+    std::promise<void> finished;
+
+    task_runner->postDelayedTask([&]()
+    {
+        order.emplace_back(3);
+        finished.set_value();
+    },
+    std::chrono::milliseconds(40));
+
+    task_runner->postDelayedTask([&]() { order.emplace_back(2); }, std::chrono::milliseconds(10));
+    task_runner->postTask([&]() { order.emplace_back(1); });
+
+    finished.get_future().wait();
+    thread.stop();
+
+    EXPECT_EQ(order, std::vector<int>({ 1, 2, 3 }));
+}
+
+TEST(message_loop_test, tasks_are_not_copied)
+{
+    Thread thread;
+    thread.start(MessageLoop::Type::DEFAULT);
+
+    std::shared_ptr<TaskRunner> task_runner = thread.taskRunner();
+    int copy_count = 0;
+
+    task_runner->postTask(CopyCounter(&copy_count));
+    task_runner->postDelayedTask(CopyCounter(&copy_count), std::chrono::milliseconds(1));
+    task_runner->postNonNestableTask(CopyCounter(&copy_count));
+
+    std::promise<void> finished;
+    task_runner->postDelayedTask(
+        [&finished]() { finished.set_value(); }, std::chrono::milliseconds(10));
+
+    finished.get_future().wait();
+    thread.stop();
+
+    EXPECT_EQ(copy_count, 0);
+}
+
+TEST(message_loop_test, DISABLED_benchmark)
+{
+    const int kTasksPerThread = 1000000;
+
+    Thread thread;
+    thread.start(MessageLoop::Type::DEFAULT);
+
+    for (int thread_count : { 1, 2, 4 })
+    {
+        auto start_time = std::chrono::steady_clock::now();
+
+        EXPECT_TRUE(postFromThreads(thread.taskRunner(), thread_count, kTasksPerThread));
+
+        auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start_time);
+
+        std::cout << thread_count << " posting threads: "
+                  << duration.count() / (thread_count * kTasksPerThread) << " ns/task"
+                  << std::endl;
+    }
+
+    thread.stop();
+}
+
+} // namespace base
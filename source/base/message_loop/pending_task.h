@@ -19,6 +19,8 @@
 #ifndef BASE_MESSAGE_LOOP_PENDING_TASK_H
 #define BASE_MESSAGE_LOOP_PENDING_TASK_H
 
+#include "base/macros_magic.h"
+
 #include <chrono>
 #include <functional>
 #include <queue>
@@ -38,6 +40,8 @@ public:
                 TimePoint delayed_run_time,
                 bool nestable,
                 int sequence_num = 0);
+    PendingTask(PendingTask&& other) = default;
+    PendingTask& operator=(PendingTask&& other) = default;
     ~PendingTask() = default;
 
     // Used to support sorting.
@@ -53,6 +57,10 @@ public:
 
     // OK to dispatch from a nested loop.
     bool nestable;
+
+private:
+    // Tasks are only moved. Copying would copy the state captured by the callback.
+    DISALLOW_COPY_AND_ASSIGN(PendingTask);
 };
 
 // Wrapper around std::queue specialized for PendingTask which adds a Swap helper method.
@@ -0,0 +1,115 @@
+//
+// Aspia Project
+// Copyright (C) 2016-2025 Dmitry Chapyshev <dmitry@aspia.ru>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "base/net/bandwidth_estimator.h"
+
+#include "base/logging.h"
+
+#include <algorithm>
+
+namespace base {
+
+namespace {
+
+// Extra round-trip time above the minimum that is considered to be queueing.
+const std::chrono::milliseconds kQueueingThreshold { 50 };
+
+} // namespace
+
+// static
+const BandwidthEstimator::Milliseconds BandwidthEstimator::kMinSampleDuration { 100 };
+
+//--------------------------------------------------------------------------------------------------
+void BandwidthEstimator::onWriteStarted(const TimePoint& time)
+{
+    if (is_busy_)
+        return;
+
+    is_busy_ = true;
+    busy_start_ = time;
+    busy_bytes_ = 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+void BandwidthEstimator::onWriteCompleted(const TimePoint& time, size_t bytes, bool has_more_data)
+{
+    if (!is_busy_)
+        return;
+
+    busy_bytes_ += bytes;
+
+    const std::chrono::microseconds duration =
+        std::chrono::duration_cast<std::chrono::microseconds>(time - busy_start_);
+
+    if (duration >= kMinSampleDuration)
+    {
+        addSample(static_cast<int64_t>(busy_bytes_) * 1000000 / duration.count(), time);
+
+        busy_start_ = time;
+        busy_bytes_ = 0;
+    }
+
+    // A shorter interval that ended because there is nothing more to write is limited by the
+    // application. It is discarded.
+    if (!has_more_data)
+        is_busy_ = false;
+}
+
+//--------------------------------------------------------------------------------------------------
+void BandwidthEstimator::onRttMeasured(const Microseconds& rtt)
+{
+    rtt_window_[rtt_window_pos_] = rtt;
+    rtt_window_pos_ = (rtt_window_pos_ + 1) % kRttWindowSize;
+    rtt_window_count_ = std::min(rtt_window_count_ + 1, kRttWindowSize);
+
+    min_rtt_ = *std::min_element(rtt_window_.begin(), rtt_window_.begin() + rtt_window_count_);
+
+    if (!has_rtt_)
+    {
+        has_rtt_ = true;
+        rtt_ = rtt;
+        return;
+    }
+
+    rtt_ = (rtt_ * 7 + rtt) / 8;
+}
+
+//--------------------------------------------------------------------------------------------------
+bool BandwidthEstimator::isQueueing() const
+{
+    if (!has_rtt_)
+        return false;
+
+    return rtt_ > min_rtt_ * 2 && rtt_ - min_rtt_ > kQueueingThreshold;
+}
+
+//--------------------------------------------------------------------------------------------------
+void BandwidthEstimator::addSample(int64_t bandwidth, const TimePoint& time)
+{
+    if (!bandwidth_)
+        bandwidth_ = bandwidth;
+    else
+        bandwidth_ = (bandwidth_ * 3 + bandwidth) / 4;
+
+    last_sample_time_ = time;
+
+    DLOG(LS_INFO) << "Bandwidth sample: " << bandwidth << " B/s (estimate: " << bandwidth_
+                  << " B/s)";
+}
+
+} // namespace base
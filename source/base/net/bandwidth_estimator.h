@@ -0,0 +1,108 @@
+//
+// Aspia Project
+// Copyright (C) 2016-2025 Dmitry Chapyshev <dmitry@aspia.ru>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef BASE_NET_BANDWIDTH_ESTIMATOR_H
+#define BASE_NET_BANDWIDTH_ESTIMATOR_H
+
+#include "base/macros_magic.h"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace base {
+
+// Estimates the bandwidth of a connection from the completion times of socket writes, and the
+// network queueing from round-trip times.
+//
+// A write completes when its data has been accepted by the socket send buffer. While the sender
+// has more data to write, the buffer stays full and writes complete at the rate the network drains
+// the buffer. Such busy intervals give bandwidth samples. Intervals limited by the application
+// (the sender had nothing more to write) say nothing about the network and are ignored.
+class BandwidthEstimator
+{
+public:
+    using Clock = std::chrono::high_resolution_clock;
+    using TimePoint = std::chrono::time_point<Clock>;
+    using Milliseconds = std::chrono::milliseconds;
+    using Microseconds = std::chrono::microseconds;
+
+    // Minimum duration of a busy interval that gives a sample.
+    static const Milliseconds kMinSampleDuration;
+
+    // Number of the last round-trip times from which the minimum is taken. The base round-trip
+    // time can change with the network path (for example, after a VPN reconnect), so older
+    // measurements expire.
+    static constexpr size_t kRttWindowSize = 10;
+
+    BandwidthEstimator() = default;
+    ~BandwidthEstimator() = default;
+
+    // Called when a write operation is started.
+    void onWriteStarted(const TimePoint& time);
+
+    // Called when a write operation is completed. |has_more_data| is true if the next write has
+    // been started (or will be started) immediately.
+    void onWriteCompleted(const TimePoint& time, size_t bytes, bool has_more_data);
+
+    // Called when a round-trip time has been measured (for example, by a keep alive packet).
+    void onRttMeasured(const Microseconds& rtt);
+
+    // Estimated bandwidth in bytes per second. Returns 0 if there are no samples yet.
+    int64_t bandwidth() const { return bandwidth_; }
+
+    // Time of the last bandwidth sample.
+    const TimePoint& lastSampleTime() const { return last_sample_time_; }
+
+    // Returns true if at least one round-trip time has been measured. On a local network the
+    // round-trip time can be less than a millisecond, so a zero time is a valid measurement.
+    bool hasRtt() const { return has_rtt_; }
+
+    // Smoothed round-trip time and the minimum of the last |kRttWindowSize| measurements. Zero if
+    // there are no measurements yet.
+    const Microseconds& rtt() const { return rtt_; }
+    const Microseconds& minRtt() const { return min_rtt_; }
+
+    // Returns true if the round-trip time has grown noticeably above its minimum, which means that
+    // the data is queued somewhere in the network.
+    bool isQueueing() const;
+
+private:
+    void addSample(int64_t bandwidth, const TimePoint& time);
+
+    bool is_busy_ = false;
+    TimePoint busy_start_;
+    size_t busy_bytes_ = 0;
+
+    int64_t bandwidth_ = 0;
+    TimePoint last_sample_time_;
+
+    bool has_rtt_ = false;
+    Microseconds rtt_ { 0 };
+    Microseconds min_rtt_ { 0 };
+    std::array<Microseconds, kRttWindowSize> rtt_window_;
+    size_t rtt_window_count_ = 0;
+    size_t rtt_window_pos_ = 0;
+
+    DISALLOW_COPY_AND_ASSIGN(BandwidthEstimator);
+};
+
+} // namespace base
+
+#endif // BASE_NET_BANDWIDTH_ESTIMATOR_H
@@ -0,0 +1,151 @@
+//
+// Aspia Project
+// Copyright (C) 2016-2025 Dmitry Chapyshev <dmitry@aspia.ru>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "base/net/bandwidth_estimator.h"
+
+#include <gtest/gtest.h>
+
+namespace base {
+
+namespace {
+
+using Milliseconds = BandwidthEstimator::Milliseconds;
+using Microseconds = BandwidthEstimator::Microseconds;
+
+} // namespace
+
+TEST(BandwidthEstimatorTest, BusyInterval)
+{
+    BandwidthEstimator estimator;
+    BandwidthEstimator::TimePoint time;
+
+    EXPECT_EQ(estimator.bandwidth(), 0);
+
+    // 10 writes of 100 KB, 20 ms each: 5 MB/s.
+    estimator.onWriteStarted(time);
+
+    for (int i = 0; i < 10; ++i)
+    {
+        time += Milliseconds(20);
+        estimator.onWriteCompleted(time, 100 * 1000, i != 9);
+    }
+
+    EXPECT_EQ(estimator.bandwidth(), 5 * 1000 * 1000);
+    EXPECT_EQ(estimator.lastSampleTime(), time);
+}
+
+TEST(BandwidthEstimatorTest, ApplicationLimited)
+{
+    BandwidthEstimator estimator;
+    BandwidthEstimator::TimePoint time;
+
+    // Short writes after which there is nothing more to send do not give samples.
+    for (int i = 0; i < 100; ++i)
+    {
+        estimator.onWriteStarted(time);
+        time += Milliseconds(1);
+        estimator.onWriteCompleted(time, 1000, false);
+        time += Milliseconds(50);
+    }
+
+    EXPECT_EQ(estimator.bandwidth(), 0);
+}
+
+TEST(BandwidthEstimatorTest, Smoothing)
+{
+    BandwidthEstimator estimator;
+    BandwidthEstimator::TimePoint time;
+
+    // 1 MB/s.
+    estimator.onWriteStarted(time);
+    time += Milliseconds(100);
+    estimator.onWriteCompleted(time, 100 * 1000, false);
+    EXPECT_EQ(estimator.bandwidth(), 1000 * 1000);
+
+    // 5 MB/s moves the estimate by a quarter of the difference.
+    estimator.onWriteStarted(time);
+    time += Milliseconds(100);
+    estimator.onWriteCompleted(time, 500 * 1000, false);
+    EXPECT_EQ(estimator.bandwidth(), 2 * 1000 * 1000);
+}
+
+TEST(BandwidthEstimatorTest, Rtt)
+{
+    BandwidthEstimator estimator;
+
+    EXPECT_FALSE(estimator.isQueueing());
+
+    estimator.onRttMeasured(Milliseconds(40));
+    EXPECT_TRUE(estimator.hasRtt());
+    EXPECT_EQ(estimator.rtt(), Milliseconds(40));
+    EXPECT_EQ(estimator.minRtt(), Milliseconds(40));
+    EXPECT_FALSE(estimator.isQueueing());
+
+    for (int i = 0; i < 5; ++i)
+        estimator.onRttMeasured(Milliseconds(400));
+
+    EXPECT_EQ(estimator.minRtt(), Milliseconds(40));
+    EXPECT_GT(estimator.rtt(), Milliseconds(200));
+    EXPECT_TRUE(estimator.isQueueing());
+}
+
+TEST(BandwidthEstimatorTest, SubMillisecondRtt)
+{
+    BandwidthEstimator estimator;
+    EXPECT_FALSE(estimator.hasRtt());
+
+    // Round-trip times of a local network are shorter than a millisecond.
+    estimator.onRttMeasured(Microseconds(200));
+    EXPECT_TRUE(estimator.hasRtt());
+    EXPECT_EQ(estimator.rtt(), Microseconds(200));
+    EXPECT_EQ(estimator.minRtt(), Microseconds(200));
+
+    // The first measurement is kept as the minimum and is not replaced by the next one.
+    estimator.onRttMeasured(Microseconds(300));
+    EXPECT_EQ(estimator.minRtt(), Microseconds(200));
+    EXPECT_FALSE(estimator.isQueueing());
+
+    for (int i = 0; i < 8; ++i)
+        estimator.onRttMeasured(Milliseconds(100));
+
+    EXPECT_EQ(estimator.minRtt(), Microseconds(200));
+    EXPECT_TRUE(estimator.isQueueing());
+}
+
+TEST(BandwidthEstimatorTest, BaseRttIncrease)
+{
+    BandwidthEstimator estimator;
+
+    estimator.onRttMeasured(Milliseconds(20));
+    EXPECT_EQ(estimator.minRtt(), Milliseconds(20));
+
+    // The network path has changed and the base round-trip time is now 300 ms. Until the old
+    // measurement leaves the window this looks like queueing.
+    estimator.onRttMeasured(Milliseconds(300));
+    estimator.onRttMeasured(Milliseconds(300));
+    estimator.onRttMeasured(Milliseconds(300));
+    EXPECT_TRUE(estimator.isQueueing());
+
+    for (size_t i = 0; i < BandwidthEstimator::kRttWindowSize; ++i)
+        estimator.onRttMeasured(Milliseconds(300));
+
+    EXPECT_EQ(estimator.minRtt(), Milliseconds(300));
+    EXPECT_FALSE(estimator.isQueueing());
+}
+
+} // namespace base
@@ -20,6 +20,7 @@
 
 #include "base/location.h"
 #include "base/logging.h"
+#include "base/crypto/crypto_worker_pool.h"
 #include "base/crypto/large_number_increment.h"
 #include "base/crypto/message_encryptor_fake.h"
 #include "base/crypto/message_decryptor_fake.h"
@@ -36,6 +37,19 @@ namespace base {
 
 namespace {
 
+// Maximum size of data sent by one write operation. Several small messages are combined into one
+// write. A large message is always sent by a separate write.
+const size_t kWriteBatchSize = 64 * 1024;
+
+// Size of the buffer for incoming data. Several small messages can be received by one read.
+// Messages that do not fit into the buffer are read directly into a separate buffer.
+const size_t kReadBufferSize = 8 * 1024;
+
+// User messages of this size and larger are encrypted and decrypted on the worker pool if it is
+// set. Smaller messages are processed faster than a task is passed to another thread. Such a
+// message does not fit into a write batch with other messages.
+const size_t kWorkerPoolMessageSize = kWriteBatchSize;
+
 std::string endpointsToString(const asio::ip::tcp::resolver::results_type& endpoints)
 {
     std::string str;
@@ -64,9 +78,8 @@ public:
                     const asio::ip::tcp::resolver::results_type& endpoints);
     void onConnected(const std::error_code& error_code, const asio::ip::tcp::endpoint& endpoint);
     void onWrite(const std::error_code& error_code, size_t bytes_transferred);
-    void onReadSize(const std::error_code& error_code, size_t bytes_transferred);
+    void onRead(const std::error_code& error_code, size_t bytes_transferred);
     void onReadUserData(const std::error_code& error_code, size_t bytes_transferred);
-    void onReadServiceHeader(const std::error_code& error_code, size_t bytes_transferred);
     void onReadServiceData(const std::error_code& error_code, size_t bytes_transferred);
     void onKeepAliveInterval(const std::error_code& error_code);
     void onKeepAliveTimeout(const std::error_code& error_code);
@@ -116,10 +129,10 @@ void TcpChannel::Handler::onWrite(const std::error_code& error_code, size_t byte
 }
 
 //--------------------------------------------------------------------------------------------------
-void TcpChannel::Handler::onReadSize(const std::error_code& error_code, size_t bytes_transferred)
+void TcpChannel::Handler::onRead(const std::error_code& error_code, size_t bytes_transferred)
 {
     if (channel_)
-        channel_->onReadSize(error_code, bytes_transferred);
+        channel_->onRead(error_code, bytes_transferred);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -129,14 +142,6 @@ void TcpChannel::Handler::onReadUserData(const std::error_code& error_code, size
         channel_->onReadUserData(error_code, bytes_transferred);
 }
 
-//--------------------------------------------------------------------------------------------------
-void TcpChannel::Handler::onReadServiceHeader(
-    const std::error_code& error_code, size_t bytes_transferred)
-{
-    if (channel_)
-        channel_->onReadServiceHeader(error_code, bytes_transferred);
-}
-
 //--------------------------------------------------------------------------------------------------
 void TcpChannel::Handler::onReadServiceData(
     const std::error_code& error_code, size_t bytes_transferred)
@@ -191,6 +196,9 @@ TcpChannel::~TcpChannel()
 {
     LOG(LS_INFO) << "Dtor (start)";
 
+    if (alive_)
+        *alive_ = false;
+
     proxy_->willDestroyCurrentChannel();
     proxy_ = nullptr;
 
@@ -224,6 +232,20 @@ void TcpChannel::setDecryptor(std::unique_ptr<MessageDecryptor> decryptor)
     decryptor_ = std::move(decryptor);
 }
 
+//--------------------------------------------------------------------------------------------------
+void TcpChannel::setWorkerPool(std::shared_ptr<CryptoWorkerPool> worker_pool)
+{
+    worker_pool_ = std::move(worker_pool);
+
+    if (!worker_pool_)
+        return;
+
+    task_runner_ = MessageLoop::current()->taskRunner();
+
+    if (!alive_)
+        alive_ = std::make_shared<bool>(true);
+}
+
 //--------------------------------------------------------------------------------------------------
 std::u16string TcpChannel::peerAddress() const
 {
@@ -316,11 +338,12 @@ void TcpChannel::resume()
 
     switch (state_)
     {
-        // We already have an incomplete read operation.
-        case ReadState::READ_SIZE:
+        // We already have an incomplete read operation or messages are being processed now.
+        case ReadState::READ:
         case ReadState::READ_USER_DATA:
-        case ReadState::READ_SERVICE_HEADER:
         case ReadState::READ_SERVICE_DATA:
+        case ReadState::PARSE:
+        case ReadState::DECRYPT:
             return;
 
         default:
@@ -329,9 +352,25 @@ void TcpChannel::resume()
 
     // If we have a message that was received before the pause command.
     if (state_ == ReadState::PENDING)
-        onMessageReceived();
+    {
+        state_ = ReadState::PARSE;
+
+        if (decryptOnWorkerPool())
+            return;
+
+        if (!onMessageReceived(message_buffer_.data(), message_buffer_.size()))
+            return;
+    }
+    else if (state_ == ReadState::DECRYPTED)
+    {
+        state_ = ReadState::PARSE;
+
+        if (!notifyDecryptedMessage())
+            return;
+    }
 
-    doReadSize();
+    // The read buffer can contain messages received before the pause command.
+    onReadBufferData();
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -583,15 +622,12 @@ void TcpChannel::onConnected(const std::error_code &error_code, const asio::ip::
 void TcpChannel::onMessageWritten(uint8_t channel_id, ByteArray&& buffer)
 {
     if (listener_)
-        listener_->onTcpMessageWritten(channel_id, std::move(buffer), write_queue_.size());
+        listener_->onTcpMessageWritten(channel_id, std::move(buffer), pendingMessages());
 }
 
 //--------------------------------------------------------------------------------------------------
-void TcpChannel::onMessageReceived()
+bool TcpChannel::onMessageReceived(const uint8_t* read_data, size_t read_size)
 {
-    uint8_t* read_data = read_buffer_.data();
-    size_t read_size = read_buffer_.size();
-
     UserDataHeader header;
 
     if (is_channel_id_supported_)
@@ -599,7 +635,7 @@ void TcpChannel::onMessageReceived()
         if (read_size < sizeof(header))
         {
             onErrorOccurred(FROM_HERE, ErrorCode::INVALID_PROTOCOL);
-            return;
+            return false;
         }
 
         memcpy(&header, read_data, sizeof(header));
@@ -615,7 +651,7 @@ void TcpChannel::onMessageReceived()
     if (!read_size)
     {
         onErrorOccurred(FROM_HERE, ErrorCode::INVALID_PROTOCOL);
-        return;
+        return false;
     }
 
     resizeBuffer(&decrypt_buffer_, decryptor_->decryptedDataSize(read_size));
@@ -623,65 +659,240 @@ void TcpChannel::onMessageReceived()
     if (!decryptor_->decrypt(read_data, read_size, decrypt_buffer_.data()))
     {
         onErrorOccurred(FROM_HERE, ErrorCode::ACCESS_DENIED);
-        return;
+        return false;
     }
 
     if (listener_)
         listener_->onTcpMessageReceived(header.channel_id, decrypt_buffer_);
+
+    return connected_;
+}
+
+//--------------------------------------------------------------------------------------------------
+bool TcpChannel::onServiceMessageReceived(const uint8_t* read_data, size_t read_size)
+{
+    DCHECK_GT(read_size, sizeof(ServiceHeader));
+
+    // Incoming buffer contains a service header.
+    ServiceHeader header;
+    memcpy(&header, read_data, sizeof(header));
+
+    const uint8_t* data = read_data + sizeof(ServiceHeader);
+    const size_t data_size = read_size - sizeof(ServiceHeader);
+
+    DCHECK_EQ(header.length, data_size);
+
+    if (header.type != KEEP_ALIVE)
+    {
+        onErrorOccurred(FROM_HERE, ErrorCode::INVALID_PROTOCOL);
+        return false;
+    }
+
+    if (header.flags & KEEP_ALIVE_PING)
+    {
+        // Send pong.
+        sendKeepAlive(KEEP_ALIVE_PONG, data, data_size);
+        return connected_;
+    }
+
+    if (header.length != keep_alive_counter_.size())
+    {
+        onErrorOccurred(FROM_HERE, ErrorCode::INVALID_PROTOCOL);
+        return false;
+    }
+
+    // Pong must contain the same data as ping.
+    if (memcmp(data, keep_alive_counter_.data(), keep_alive_counter_.size()) != 0)
+    {
+        onErrorOccurred(FROM_HERE, ErrorCode::INVALID_PROTOCOL);
+        return false;
+    }
+
+    const auto ping_duration = Clock::now() - keep_alive_timestamp_;
+    Milliseconds ping_time = std::chrono::duration_cast<Milliseconds>(ping_duration);
+
+    DLOG(LS_INFO) << "Ping result: " << ping_time.count() << " ms ("
+                  << keep_alive_counter_.size() << " bytes)";
+
+    bandwidth_estimator_.onRttMeasured(
+        std::chrono::duration_cast<BandwidthEstimator::Microseconds>(ping_duration));
+
+    // The user can disable keep alive. Restart the timer only if keep alive is enabled.
+    if (keep_alive_timer_)
+    {
+        DCHECK(!keep_alive_counter_.empty());
+
+        // Increase the counter of sent packets.
+        largeNumberIncrement(&keep_alive_counter_);
+
+        // Restart keep alive timer.
+        keep_alive_timer_->cancel();
+        keep_alive_timer_->expires_after(keep_alive_interval_);
+        keep_alive_timer_->async_wait(
+            std::bind(&Handler::onKeepAliveInterval, handler_, std::placeholders::_1));
+    }
+
+    return true;
 }
 
 //--------------------------------------------------------------------------------------------------
 void TcpChannel::addWriteTask(
     WriteTask::Type type, WriteTask::Priority priority, uint8_t channel_id, ByteArray&& data)
 {
-    const bool schedule_write = write_queue_.empty();
-
     // Add the buffer to the queue for sending.
     write_queue_.emplace(type, priority, next_sequence_num_++, channel_id, std::move(data));
 
-    if (schedule_write)
+    // If a write is in progress, then the task will be sent after its completion.
+    if (!isWriting())
         doWrite();
+    else
+        encryptAhead();
 }
 
 //--------------------------------------------------------------------------------------------------
 void TcpChannel::doWrite()
 {
-    const WriteTask& task = write_queue_.top();
-    const ByteArray& source_buffer = task.data();
-    const uint8_t channel_id = task.channelId();
+    DCHECK(!isWriting());
 
-    if (source_buffer.empty())
+    if (next_batch_)
     {
-        onErrorOccurred(FROM_HERE, ErrorCode::INVALID_PROTOCOL);
-        return;
+        // The write is started when the encryption is finished.
+        if (encrypting_)
+            return;
+
+        write_batch_ = std::move(*next_batch_);
+        next_batch_.reset();
+    }
+    else
+    {
+        DCHECK(!write_queue_.empty());
+
+        if (!takeWriteBatch(&write_batch_))
+            return;
+
+        const WriteTask& task = write_batch_.tasks.front();
+        if (worker_pool_ && task.type() == WriteTask::Type::USER_DATA &&
+            task.data().size() >= kWorkerPoolMessageSize)
+        {
+            encryptOnWorkerPool(std::move(write_batch_));
+            write_batch_.tasks.clear();
+            return;
+        }
+
+        if (!encryptWriteBatch(encryptor_.get(), is_channel_id_supported_, &write_batch_))
+        {
+            onErrorOccurred(FROM_HERE, ErrorCode::ACCESS_DENIED);
+            return;
+        }
     }
 
-    if (task.type() == WriteTask::Type::USER_DATA)
+    bandwidth_estimator_.onWriteStarted(Clock::now());
+
+    // Send the buffers to the recipient.
+    asio::async_write(socket_,
+                      write_batch_.buffers,
+                      std::bind(&Handler::onWrite,
+                                handler_,
+                                std::placeholders::_1,
+                                std::placeholders::_2));
+
+    encryptAhead();
+}
+
+//--------------------------------------------------------------------------------------------------
+bool TcpChannel::takeWriteBatch(WriteBatch* batch)
+{
+    DCHECK(batch->tasks.empty());
+
+    size_t write_size = 0;
+
+    // Take several tasks from the queue in order of priority. The first task is always taken.
+    // The batch size is limited so that messages with a higher priority added during the write
+    // are not delayed for long.
+    do
     {
-        // Calculate the size of the encrypted message.
-        size_t target_data_size = encryptor_->encryptedDataSize(source_buffer.size());
-        if (is_channel_id_supported_)
-            target_data_size += sizeof(UserDataHeader);
+        const WriteTask& task = write_queue_.top();
+        const size_t source_size = task.data().size();
 
-        if (target_data_size > kMaxMessageSize)
+        if (!source_size)
         {
-            LOG(LS_ERROR) << "Too big outgoing message: " << target_data_size;
             onErrorOccurred(FROM_HERE, ErrorCode::INVALID_PROTOCOL);
-            return;
+            return false;
+        }
+
+        size_t task_size = source_size;
+
+        if (task.type() == WriteTask::Type::USER_DATA)
+        {
+            // Calculate the size of the encrypted message.
+            size_t target_data_size = encryptor_->encryptedDataSize(source_size);
+            if (is_channel_id_supported_)
+                target_data_size += sizeof(UserDataHeader);
+
+            if (target_data_size > kMaxMessageSize)
+            {
+                LOG(LS_ERROR) << "Too big outgoing message: " << target_data_size;
+                onErrorOccurred(FROM_HERE, ErrorCode::INVALID_PROTOCOL);
+                return false;
+            }
+
+            task_size = variable_size_writer_.variableSize(target_data_size).size() +
+                target_data_size;
+        }
+
+        if (!batch->tasks.empty() && write_size + task_size > kWriteBatchSize)
+            break;
+
+        write_size += task_size;
+
+        // The data of the task is moved. It is not used by the queue.
+        batch->tasks.emplace_back(std::move(const_cast<WriteTask&>(task)));
+        write_queue_.pop();
+    }
+    while (!write_queue_.empty());
+
+    // User data is encrypted into one buffer.
+    resizeBuffer(&batch->buffer, write_size);
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+// static
+bool TcpChannel::encryptWriteBatch(
+    MessageEncryptor* encryptor, bool is_channel_id_supported, WriteBatch* batch)
+{
+    // User data is encrypted into one buffer. Service data is sent from the task buffers as is.
+    VariableSizeWriter variable_size_writer;
+    uint8_t* write_buffer = batch->buffer.data();
+    batch->buffers.clear();
+
+    for (const auto& task : batch->tasks)
+    {
+        const ByteArray& source_buffer = task.data();
+
+        if (task.type() == WriteTask::Type::SERVICE_DATA)
+        {
+            batch->buffers.emplace_back(source_buffer.data(), source_buffer.size());
+            continue;
         }
 
-        asio::const_buffer variable_size = variable_size_writer_.variableSize(target_data_size);
+        DCHECK_EQ(task.type(), WriteTask::Type::USER_DATA);
 
-        resizeBuffer(&write_buffer_, variable_size.size() + target_data_size);
+        size_t target_data_size = encryptor->encryptedDataSize(source_buffer.size());
+        if (is_channel_id_supported)
+            target_data_size += sizeof(UserDataHeader);
+
+        asio::const_buffer variable_size = variable_size_writer.variableSize(target_data_size);
+        uint8_t* message_begin = write_buffer;
 
         // Copy the size of the message to the buffer.
-        memcpy(write_buffer_.data(), variable_size.data(), variable_size.size());
+        memcpy(write_buffer, variable_size.data(), variable_size.size());
+        write_buffer += variable_size.size();
 
-        uint8_t* write_buffer = write_buffer_.data() + variable_size.size();
-        if (is_channel_id_supported_)
+        if (is_channel_id_supported)
         {
             UserDataHeader header;
-            header.channel_id = channel_id;
+            header.channel_id = task.channelId();
             header.reserved = 0;
 
             // Copy the channel id to the buffer.
@@ -690,29 +901,95 @@ void TcpChannel::doWrite()
         }
 
         // Encrypt the message.
-        if (!encryptor_->encrypt(source_buffer.data(), source_buffer.size(), write_buffer))
+        if (!encryptor->encrypt(source_buffer.data(), source_buffer.size(), write_buffer))
+            return false;
+
+        write_buffer += encryptor->encryptedDataSize(source_buffer.size());
+
+        // Messages that follow each other in the buffer are sent as one piece.
+        const size_t message_size = static_cast<size_t>(write_buffer - message_begin);
+        if (!batch->buffers.empty() &&
+            static_cast<const uint8_t*>(batch->buffers.back().data()) +
+                batch->buffers.back().size() == message_begin)
         {
-            onErrorOccurred(FROM_HERE, ErrorCode::ACCESS_DENIED);
-            return;
+            batch->buffers.back() = asio::const_buffer(
+                batch->buffers.back().data(), batch->buffers.back().size() + message_size);
+        }
+        else
+        {
+            batch->buffers.emplace_back(message_begin, message_size);
         }
     }
-    else
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+void TcpChannel::encryptAhead()
+{
+    if (!worker_pool_ || next_batch_ || !connected_)
+        return;
+
+    if (write_queue_.empty() && !proxy_->reloadWriteQueue(&write_queue_))
+        return;
+
+    // Only a large message is taken from the queue before the current write is completed. Smaller
+    // messages are taken after it, so that messages with a higher priority are not delayed.
+    const WriteTask& task = write_queue_.top();
+    if (task.type() != WriteTask::Type::USER_DATA || task.data().size() < kWorkerPoolMessageSize)
+        return;
+
+    WriteBatch batch;
+    if (!takeWriteBatch(&batch))
+        return;
+
+    encryptOnWorkerPool(std::move(batch));
+}
+
+//--------------------------------------------------------------------------------------------------
+void TcpChannel::encryptOnWorkerPool(WriteBatch&& batch)
+{
+    DCHECK(worker_pool_);
+    DCHECK(!next_batch_);
+
+    next_batch_ = std::make_shared<WriteBatch>(std::move(batch));
+    encrypting_ = true;
+
+    std::shared_ptr<bool> result = std::make_shared<bool>(false);
+
+    worker_pool_->postTaskAndReply(
+        [encryptor = encryptor_,
+         batch = next_batch_,
+         is_channel_id_supported = is_channel_id_supported_,
+         result]()
     {
-        DCHECK_EQ(task.type(), WriteTask::Type::SERVICE_DATA);
+        *result = encryptWriteBatch(encryptor.get(), is_channel_id_supported, batch.get());
+    },
+    task_runner_,
+    [this, alive = alive_, result]()
+    {
+        if (*alive)
+            onWriteBatchEncrypted(*result);
+    });
+}
 
-        resizeBuffer(&write_buffer_, source_buffer.size());
+//--------------------------------------------------------------------------------------------------
+void TcpChannel::onWriteBatchEncrypted(bool result)
+{
+    DCHECK(encrypting_);
+    encrypting_ = false;
+
+    if (!connected_)
+        return;
 
-        // Service data does not need encryption. Copy the source buffer.
-        memcpy(write_buffer_.data(), source_buffer.data(), source_buffer.size());
+    if (!result)
+    {
+        onErrorOccurred(FROM_HERE, ErrorCode::ACCESS_DENIED);
+        return;
     }
 
-    // Send the buffer to the recipient.
-    asio::async_write(socket_,
-                      asio::buffer(write_buffer_.data(), write_buffer_.size()),
-                      std::bind(&Handler::onWrite,
-                                handler_,
-                                std::placeholders::_1,
-                                std::placeholders::_2));
+    if (!isWriting())
+        doWrite();
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -724,44 +1001,71 @@ void TcpChannel::onWrite(const std::error_code& error_code, size_t bytes_transfe
         return;
     }
 
-    DCHECK(!write_queue_.empty());
+    DCHECK(isWriting());
+
+    const TimePoint write_time = Clock::now();
 
     // Update TX statistics.
     addTxBytes(bytes_transferred);
 
-    const WriteTask& task = write_queue_.top();
-    WriteTask::Type task_type = task.type();
-    uint8_t channel_id = task.channelId();
-    ByteArray buffer = std::move(task.data());
-
-    // Delete the sent message from the queue.
-    write_queue_.pop();
+    // The sent tasks are moved out so that the next write can be started from the notifications.
+    DCHECK(written_batch_.empty());
+    written_batch_.swap(write_batch_.tasks);
 
-    // If the queue is not empty, then we send the following message.
-    bool schedule_write = !write_queue_.empty() || proxy_->reloadWriteQueue(&write_queue_);
+    for (auto& task : written_batch_)
+    {
+        if (task.type() == WriteTask::Type::USER_DATA)
+            onMessageWritten(task.channelId(), std::move(task.data()));
+    }
 
-    if (task_type == WriteTask::Type::USER_DATA)
-        onMessageWritten(channel_id, std::move(buffer));
+    written_batch_.clear();
 
-    if (schedule_write)
+    // If the queue is not empty, then we send the following messages.
+    if (!isWriting() &&
+        (next_batch_ || !write_queue_.empty() || proxy_->reloadWriteQueue(&write_queue_)))
+    {
         doWrite();
+    }
+
+    // If the next write has been started, the socket stays busy and the bandwidth can be measured.
+    bandwidth_estimator_.onWriteCompleted(write_time, bytes_transferred, isWriting());
 }
 
 //--------------------------------------------------------------------------------------------------
-void TcpChannel::doReadSize()
+void TcpChannel::doRead()
 {
-    state_ = ReadState::READ_SIZE;
-    asio::async_read(socket_,
-                     variable_size_reader_.buffer(),
-                     std::bind(&Handler::onReadSize,
-                               handler_,
-                               std::placeholders::_1,
-                               std::placeholders::_2));
+    if (read_buffer_.empty())
+        read_buffer_.resize(kReadBufferSize);
+
+    // Move the beginning of an incomplete message to the start of the buffer.
+    if (read_begin_ == read_end_)
+    {
+        read_begin_ = 0;
+        read_end_ = 0;
+    }
+    else if (read_begin_ != 0)
+    {
+        memmove(read_buffer_.data(), read_buffer_.data() + read_begin_, read_end_ - read_begin_);
+        read_end_ -= read_begin_;
+        read_begin_ = 0;
+    }
+
+    DCHECK_LT(read_end_, read_buffer_.size());
+
+    state_ = ReadState::READ;
+    socket_.async_read_some(asio::buffer(read_buffer_.data() + read_end_,
+                                         read_buffer_.size() - read_end_),
+                            std::bind(&Handler::onRead,
+                                      handler_,
+                                      std::placeholders::_1,
+                                      std::placeholders::_2));
 }
 
 //--------------------------------------------------------------------------------------------------
-void TcpChannel::onReadSize(const std::error_code& error_code, size_t bytes_transferred)
+void TcpChannel::onRead(const std::error_code& error_code, size_t bytes_transferred)
 {
+    DCHECK_EQ(state_, ReadState::READ);
+
     if (error_code)
     {
         onErrorOccurred(FROM_HERE, error_code);
@@ -771,10 +1075,27 @@ void TcpChannel::onReadSize(const std::error_code& error_code, size_t bytes_tran
     // Update RX statistics.
     addRxBytes(bytes_transferred);
 
-    std::optional<size_t> size = variable_size_reader_.messageSize();
-    if (size.has_value())
+    read_end_ += bytes_transferred;
+    DCHECK_LE(read_end_, read_buffer_.size());
+
+    onReadBufferData();
+}
+
+//--------------------------------------------------------------------------------------------------
+void TcpChannel::onReadBufferData()
+{
+    state_ = ReadState::PARSE;
+
+    // Several messages can be received by one read.
+    while (connected_ && !paused_)
     {
-        size_t message_size = *size;
+        const uint8_t* data = read_buffer_.data() + read_begin_;
+        const size_t available = read_end_ - read_begin_;
+
+        size_t message_size = 0;
+        const size_t size_length = VariableSizeReader::read(data, available, &message_size);
+        if (!size_length)
+            break;
 
         if (message_size > kMaxMessageSize)
         {
@@ -783,31 +1104,92 @@ void TcpChannel::onReadSize(const std::error_code& error_code, size_t bytes_tran
             return;
         }
 
-        // If the message size is 0 (in other words, the first received byte is 0), then you need
-        // to start reading the service message.
+        ReadState message_state = ReadState::READ_USER_DATA;
+
+        // If the message size is 0 (in other words, the first received byte is 0), then it is a
+        // service message. The service header contains the size of the service data.
         if (!message_size)
         {
-            doReadServiceHeader();
-            return;
+            if (available - size_length < sizeof(ServiceHeader))
+                break;
+
+            ServiceHeader header;
+            memcpy(&header, data + size_length, sizeof(header));
+
+            if (header.length > kMaxMessageSize)
+            {
+                LOG(LS_INFO) << "Too big service message: " << header.length;
+                onErrorOccurred(FROM_HERE, ErrorCode::INVALID_PROTOCOL);
+                return;
+            }
+
+            // Keep alive packet must always contain data.
+            if (header.type != KEEP_ALIVE || !header.length)
+            {
+                onErrorOccurred(FROM_HERE, ErrorCode::INVALID_PROTOCOL);
+                return;
+            }
+
+            message_size = sizeof(ServiceHeader) + header.length;
+            message_state = ReadState::READ_SERVICE_DATA;
         }
 
-        doReadUserData(message_size);
+        if (available - size_length < message_size)
+        {
+            // If the message does not fit into the read buffer, then the rest of the message is
+            // read directly into a separate buffer.
+            if (size_length + message_size > read_buffer_.size())
+                doReadMessage(message_state, message_size, size_length);
+
+            break;
+        }
+
+        read_begin_ += size_length + message_size;
+
+        bool result;
+        if (message_state == ReadState::READ_USER_DATA)
+            result = onMessageReceived(data + size_length, message_size);
+        else
+            result = onServiceMessageReceived(data + size_length, message_size);
+
+        if (!result)
+            return;
     }
-    else
+
+    if (!connected_ || state_ != ReadState::PARSE)
+        return;
+
+    if (paused_)
     {
-        doReadSize();
+        state_ = ReadState::IDLE;
+        return;
     }
+
+    doRead();
 }
 
 //--------------------------------------------------------------------------------------------------
-void TcpChannel::doReadUserData(size_t length)
+void TcpChannel::doReadMessage(ReadState state, size_t message_size, size_t size_length)
 {
-    resizeBuffer(&read_buffer_, length);
+    DCHECK(state == ReadState::READ_USER_DATA || state == ReadState::READ_SERVICE_DATA);
 
-    state_ = ReadState::READ_USER_DATA;
+    // The beginning of the message is already in the read buffer.
+    const uint8_t* data = read_buffer_.data() + read_begin_ + size_length;
+    const size_t available = read_end_ - read_begin_ - size_length;
+
+    DCHECK_LT(available, message_size);
+
+    resizeBuffer(&message_buffer_, message_size);
+    memcpy(message_buffer_.data(), data, available);
+
+    read_begin_ = 0;
+    read_end_ = 0;
+
+    state_ = state;
     asio::async_read(socket_,
-                     asio::buffer(read_buffer_.data(), read_buffer_.size()),
-                     std::bind(&Handler::onReadUserData,
+                     asio::buffer(message_buffer_.data() + available, message_size - available),
+                     std::bind(state == ReadState::READ_USER_DATA ?
+                                   &Handler::onReadUserData : &Handler::onReadServiceData,
                                handler_,
                                std::placeholders::_1,
                                std::placeholders::_2));
@@ -827,107 +1209,125 @@ void TcpChannel::onReadUserData(const std::error_code& error_code, size_t bytes_
     // Update RX statistics.
     addRxBytes(bytes_transferred);
 
-    DCHECK_EQ(bytes_transferred, read_buffer_.size());
-
     if (paused_)
     {
         state_ = ReadState::PENDING;
         return;
     }
 
-    onMessageReceived();
+    state_ = ReadState::PARSE;
 
-    if (paused_)
-    {
-        state_ = ReadState::IDLE;
+    if (decryptOnWorkerPool())
+        return;
+
+    if (!onMessageReceived(message_buffer_.data(), message_buffer_.size()))
         return;
-    }
 
-    doReadSize();
+    onReadBufferData();
 }
 
 //--------------------------------------------------------------------------------------------------
-void TcpChannel::doReadServiceHeader()
+bool TcpChannel::decryptOnWorkerPool()
 {
-    resizeBuffer(&read_buffer_, sizeof(ServiceHeader));
+    DCHECK_EQ(state_, ReadState::PARSE);
 
-    state_ = ReadState::READ_SERVICE_HEADER;
-    asio::async_read(socket_,
-                     asio::buffer(read_buffer_.data(), read_buffer_.size()),
-                     std::bind(&Handler::onReadServiceHeader,
-                               handler_,
-                               std::placeholders::_1,
-                               std::placeholders::_2));
-}
+    if (!worker_pool_ || message_buffer_.size() < kWorkerPoolMessageSize)
+        return false;
 
-//--------------------------------------------------------------------------------------------------
-void TcpChannel::onReadServiceHeader(const std::error_code& error_code, size_t bytes_transferred)
-{
-    DCHECK_EQ(state_, ReadState::READ_SERVICE_HEADER);
-    DCHECK_EQ(read_buffer_.size(), sizeof(ServiceHeader));
+    UserDataHeader header;
+    size_t header_size = 0;
 
-    if (error_code)
+    if (is_channel_id_supported_)
     {
-        onErrorOccurred(FROM_HERE, error_code);
-        return;
+        memcpy(&header, message_buffer_.data(), sizeof(header));
+        header_size = sizeof(header);
+    }
+    else
+    {
+        memset(&header, 0, sizeof(header));
     }
 
-    DCHECK_EQ(bytes_transferred, read_buffer_.size());
+    struct Message
+    {
+        ByteArray source;
+        ByteArray target;
+        bool result = false;
+    };
 
-    // Update RX statistics.
-    addRxBytes(bytes_transferred);
+    // The buffers are returned to the channel after the decryption.
+    std::shared_ptr<Message> message = std::make_shared<Message>();
+    message->source = std::move(message_buffer_);
+    message->target = std::move(decrypt_buffer_);
+
+    state_ = ReadState::DECRYPT;
 
-    ServiceHeader* header = reinterpret_cast<ServiceHeader*>(read_buffer_.data());
-    if (header->length > kMaxMessageSize)
+    worker_pool_->postTaskAndReply([decryptor = decryptor_, message, header_size]()
     {
-        LOG(LS_INFO) << "Too big service message: " << header->length;
-        onErrorOccurred(FROM_HERE, ErrorCode::INVALID_PROTOCOL);
-        return;
-    }
+        const uint8_t* data = message->source.data() + header_size;
+        const size_t size = message->source.size() - header_size;
 
-    if (header->type == KEEP_ALIVE)
+        resizeBuffer(&message->target, decryptor->decryptedDataSize(size));
+        message->result = decryptor->decrypt(data, size, message->target.data());
+    },
+    task_runner_,
+    [this, alive = alive_, message, channel_id = header.channel_id]()
     {
-        // Keep alive packet must always contain data.
-        if (!header->length)
-        {
-            onErrorOccurred(FROM_HERE, ErrorCode::INVALID_PROTOCOL);
+        if (!*alive)
             return;
-        }
 
-        doReadServiceData(header->length);
+        message_buffer_ = std::move(message->source);
+        decrypt_buffer_ = std::move(message->target);
+
+        onMessageDecrypted(channel_id, message->result);
+    });
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+void TcpChannel::onMessageDecrypted(uint8_t channel_id, bool result)
+{
+    DCHECK_EQ(state_, ReadState::DECRYPT);
+
+    if (!connected_)
+        return;
+
+    if (!result)
+    {
+        onErrorOccurred(FROM_HERE, ErrorCode::ACCESS_DENIED);
+        return;
     }
-    else
+
+    decrypted_channel_id_ = channel_id;
+
+    // The channel has been paused while the message was decrypted.
+    if (paused_)
     {
-        onErrorOccurred(FROM_HERE, ErrorCode::INVALID_PROTOCOL);
+        state_ = ReadState::DECRYPTED;
         return;
     }
+
+    state_ = ReadState::PARSE;
+
+    if (!notifyDecryptedMessage())
+        return;
+
+    onReadBufferData();
 }
 
 //--------------------------------------------------------------------------------------------------
-void TcpChannel::doReadServiceData(size_t length)
+bool TcpChannel::notifyDecryptedMessage()
 {
-    DCHECK_EQ(read_buffer_.size(), sizeof(ServiceHeader));
-    DCHECK_EQ(state_, ReadState::READ_SERVICE_HEADER);
-    DCHECK_GT(length, 0u);
-
-    read_buffer_.resize(read_buffer_.size() + length);
+    if (listener_)
+        listener_->onTcpMessageReceived(decrypted_channel_id_, decrypt_buffer_);
 
-    // Now we read the data after the header.
-    state_ = ReadState::READ_SERVICE_DATA;
-    asio::async_read(socket_,
-                     asio::buffer(read_buffer_.data() + sizeof(ServiceHeader),
-                                  read_buffer_.size() - sizeof(ServiceHeader)),
-                     std::bind(&Handler::onReadServiceData,
-                               handler_,
-                               std::placeholders::_1,
-                               std::placeholders::_2));
+    return connected_;
 }
 
 //--------------------------------------------------------------------------------------------------
 void TcpChannel::onReadServiceData(const std::error_code& error_code, size_t bytes_transferred)
 {
     DCHECK_EQ(state_, ReadState::READ_SERVICE_DATA);
-    DCHECK_GT(read_buffer_.size(), sizeof(ServiceHeader));
 
     if (error_code)
     {
@@ -938,76 +1338,12 @@ void TcpChannel::onReadServiceData(const std::error_code& error_code, size_t byt
     // Update RX statistics.
     addRxBytes(bytes_transferred);
 
-    // Incoming buffer contains a service header.
-    ServiceHeader* header = reinterpret_cast<ServiceHeader*>(read_buffer_.data());
-
-    DCHECK_EQ(bytes_transferred, read_buffer_.size() - sizeof(ServiceHeader));
-    DCHECK_LE(header->length, kMaxMessageSize);
-
-    if (header->type == KEEP_ALIVE)
-    {
-        if (header->flags & KEEP_ALIVE_PING)
-        {
-            // Send pong.
-            sendKeepAlive(KEEP_ALIVE_PONG,
-                          read_buffer_.data() + sizeof(ServiceHeader),
-                          read_buffer_.size() - sizeof(ServiceHeader));
-        }
-        else
-        {
-            if (read_buffer_.size() < (sizeof(ServiceHeader) + header->length))
-            {
-                onErrorOccurred(FROM_HERE, ErrorCode::INVALID_PROTOCOL);
-                return;
-            }
-
-            if (header->length != keep_alive_counter_.size())
-            {
-                onErrorOccurred(FROM_HERE, ErrorCode::INVALID_PROTOCOL);
-                return;
-            }
-
-            // Pong must contain the same data as ping.
-            if (memcmp(read_buffer_.data() + sizeof(ServiceHeader),
-                       keep_alive_counter_.data(),
-                       keep_alive_counter_.size()) != 0)
-            {
-                onErrorOccurred(FROM_HERE, ErrorCode::INVALID_PROTOCOL);
-                return;
-            }
-
-            if (DCHECK_IS_ON())
-            {
-                Milliseconds ping_time = std::chrono::duration_cast<Milliseconds>(
-                    Clock::now() - keep_alive_timestamp_);
-
-                DLOG(LS_INFO) << "Ping result: " << ping_time.count() << " ms ("
-                              << keep_alive_counter_.size() << " bytes)";
-            }
-
-            // The user can disable keep alive. Restart the timer only if keep alive is enabled.
-            if (keep_alive_timer_)
-            {
-                DCHECK(!keep_alive_counter_.empty());
+    state_ = ReadState::PARSE;
 
-                // Increase the counter of sent packets.
-                largeNumberIncrement(&keep_alive_counter_);
-
-                // Restart keep alive timer.
-                keep_alive_timer_->cancel();
-                keep_alive_timer_->expires_after(keep_alive_interval_);
-                keep_alive_timer_->async_wait(
-                    std::bind(&Handler::onKeepAliveInterval, handler_, std::placeholders::_1));
-            }
-        }
-    }
-    else
-    {
-        onErrorOccurred(FROM_HERE, ErrorCode::INVALID_PROTOCOL);
+    if (!onServiceMessageReceived(message_buffer_.data(), message_buffer_.size()))
         return;
-    }
 
-    doReadSize();
+    onReadBufferData();
 }
 
 //--------------------------------------------------------------------------------------------------
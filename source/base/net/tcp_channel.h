@@ -21,6 +21,7 @@
 
 #include "base/memory/byte_array.h"
 #include "base/memory/local_memory.h"
+#include "base/net/bandwidth_estimator.h"
 #include "base/net/network_channel.h"
 #include "base/net/variable_size.h"
 #include "base/net/write_task.h"
@@ -31,10 +32,12 @@
 
 namespace base {
 
+class CryptoWorkerPool;
 class TcpChannelProxy;
 class Location;
 class MessageEncryptor;
 class MessageDecryptor;
+class TaskRunner;
 class TcpServer;
 
 class TcpChannel final : public NetworkChannel
@@ -67,6 +70,12 @@ public:
     void setEncryptor(std::unique_ptr<MessageEncryptor> encryptor);
     void setDecryptor(std::unique_ptr<MessageDecryptor> decryptor);
 
+    // Enables encryption and decryption of large messages on |worker_pool|. While a large message
+    // is written to the socket, the next large message is encrypted ahead. Messages keep their
+    // order and IV sequence: a channel never has more than one message encrypted or decrypted at a
+    // time. Must be called on the thread of the channel.
+    void setWorkerPool(std::shared_ptr<CryptoWorkerPool> worker_pool);
+
     // Gets the address of the remote host as a string.
     std::u16string peerAddress() const;
 
@@ -105,7 +114,15 @@ public:
     bool setReadBufferSize(size_t size);
     bool setWriteBufferSize(size_t size);
 
-    size_t pendingMessages() const { return write_queue_.size(); }
+    size_t pendingMessages() const
+    {
+        return write_queue_.size() + write_batch_.tasks.size() +
+            (next_batch_ ? next_batch_->tasks.size() : 0);
+    }
+
+    // Bandwidth and round-trip time estimates of the connection. Round-trip times are measured
+    // with keep alive packets.
+    const BandwidthEstimator& bandwidthEstimator() const { return bandwidth_estimator_; }
 
     base::HostId hostId() const { return host_id_; }
     void setHostId(base::HostId host_id) { host_id_ = host_id; }
@@ -126,12 +143,26 @@ private:
 
     enum class ReadState
     {
-        IDLE,                // No reads are in progress right now.
-        READ_SIZE,           // Reading the message size.
-        READ_SERVICE_HEADER, // Reading the contents of the service header.
-        READ_SERVICE_DATA,   // Reading the contents of the service data.
-        READ_USER_DATA,      // Reading the contents of the user data.
-        PENDING              // There is a message about which we did not notify.
+        IDLE,              // No reads are in progress right now.
+        READ,              // Reading data into the read buffer.
+        PARSE,             // Messages from the read buffer are being processed.
+        READ_SERVICE_DATA, // Reading the rest of the service message that does not fit the buffer.
+        READ_USER_DATA,    // Reading the rest of the user message that does not fit the buffer.
+        PENDING,           // There is a message about which we did not notify.
+        DECRYPT,           // The user message is being decrypted on the worker pool.
+        DECRYPTED          // There is a decrypted message about which we did not notify.
+    };
+
+    struct WriteBatch
+    {
+        // Tasks of one write operation.
+        std::vector<WriteTask> tasks;
+
+        // Sizes, headers and encrypted data of the user messages.
+        ByteArray buffer;
+
+        // Buffers of the write operation.
+        std::vector<asio::const_buffer> buffers;
     };
 
     struct UserDataHeader
@@ -168,25 +199,36 @@ private:
     void onConnected(const std::error_code& error_code, const asio::ip::tcp::endpoint& endpoint);
 
     void onMessageWritten(uint8_t channel_id, ByteArray&& buffer);
-    void onMessageReceived();
+
+    // Return false if the channel was disconnected while processing the message.
+    bool onMessageReceived(const uint8_t* read_data, size_t read_size);
+    bool onServiceMessageReceived(const uint8_t* read_data, size_t read_size);
 
     void addWriteTask(WriteTask::Type type, WriteTask::Priority priority, uint8_t channel_id, ByteArray&& data);
 
+    bool isWriting() const { return !write_batch_.tasks.empty(); }
     void doWrite();
+    bool takeWriteBatch(WriteBatch* batch);
+    static bool encryptWriteBatch(
+        MessageEncryptor* encryptor, bool is_channel_id_supported, WriteBatch* batch);
+    void encryptAhead();
+    void encryptOnWorkerPool(WriteBatch&& batch);
+    void onWriteBatchEncrypted(bool result);
     void onWrite(const std::error_code& error_code, size_t bytes_transferred);
 
-    void doReadSize();
-    void onReadSize(const std::error_code& error_code, size_t bytes_transferred);
+    void doRead();
+    void onRead(const std::error_code& error_code, size_t bytes_transferred);
+    void onReadBufferData();
 
-    void doReadUserData(size_t length);
+    void doReadMessage(ReadState state, size_t message_size, size_t size_length);
     void onReadUserData(const std::error_code& error_code, size_t bytes_transferred);
-
-    void doReadServiceHeader();
-    void onReadServiceHeader(const std::error_code& error_code, size_t bytes_transferred);
-
-    void doReadServiceData(size_t length);
     void onReadServiceData(const std::error_code& error_code, size_t bytes_transferred);
 
+    // Returns false if the message in |message_buffer_| is decrypted on the calling thread.
+    bool decryptOnWorkerPool();
+    void onMessageDecrypted(uint8_t channel_id, bool result);
+    bool notifyDecryptedMessage();
+
     void onKeepAliveInterval(const std::error_code& error_code);
     void onKeepAliveTimeout(const std::error_code& error_code);
     void sendKeepAlive(uint8_t flags, const void* data, size_t size);
@@ -202,22 +244,45 @@ private:
     ByteArray keep_alive_counter_;
     TimePoint keep_alive_timestamp_;
 
+    BandwidthEstimator bandwidth_estimator_;
+
     Listener* listener_ = nullptr;
     bool connected_ = false;
     bool paused_ = true;
 
-    std::unique_ptr<MessageEncryptor> encryptor_;
-    std::unique_ptr<MessageDecryptor> decryptor_;
+    // Shared with the tasks of the worker pool.
+    std::shared_ptr<MessageEncryptor> encryptor_;
+    std::shared_ptr<MessageDecryptor> decryptor_;
+
+    std::shared_ptr<CryptoWorkerPool> worker_pool_;
+    std::shared_ptr<TaskRunner> task_runner_;
+
+    // Cleared in the destructor. Replies of the worker pool posted after that are ignored.
+    std::shared_ptr<bool> alive_;
 
     int next_sequence_num_ = 0;
     WriteQueue write_queue_;
     VariableSizeWriter variable_size_writer_;
-    ByteArray write_buffer_;
+
+    // Tasks that are being written now and the buffers of the write operation.
+    WriteBatch write_batch_;
+    std::vector<WriteTask> written_batch_;
+
+    // Batch that is encrypted ahead on the worker pool. The worker thread writes to its buffers
+    // until |encrypting_| is cleared.
+    std::shared_ptr<WriteBatch> next_batch_;
+    bool encrypting_ = false;
 
     ReadState state_ = ReadState::IDLE;
-    VariableSizeReader variable_size_reader_;
+
+    // Received data that is not processed yet is in the range [read_begin_, read_end_).
     ByteArray read_buffer_;
+    size_t read_begin_ = 0;
+    size_t read_end_ = 0;
+
+    ByteArray message_buffer_;
     ByteArray decrypt_buffer_;
+    uint8_t decrypted_channel_id_ = 0;
 
     base::HostId host_id_ = base::kInvalidHostId;
     bool is_channel_id_supported_ = false;
@@ -65,6 +65,14 @@ void TcpChannelProxy::scheduleWrite()
     if (!channel_)
         return;
 
+    // If a write is in progress, then the queue will be reloaded after its completion. A large
+    // message can be encrypted ahead in the meantime.
+    if (channel_->isWriting())
+    {
+        channel_->encryptAhead();
+        return;
+    }
+
     if (!reloadWriteQueue(&channel_->write_queue_))
         return;
 
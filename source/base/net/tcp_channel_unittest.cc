@@ -0,0 +1,237 @@
+//
+// Aspia Project
+// Copyright (C) 2016-2025 Dmitry Chapyshev <dmitry@aspia.ru>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "base/net/tcp_channel.h"
+
+#include "base/crypto/crypto_worker_pool.h"
+#include "base/crypto/message_decryptor_openssl.h"
+#include "base/crypto/message_encryptor_openssl.h"
+#include "base/net/tcp_server.h"
+#include "base/task_runner.h"
+#include "base/threading/thread.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <iostream>
+
+namespace base {
+
+namespace {
+
+// Sends messages from a client channel to a server channel over loopback. Lives on the thread of
+// the channels.
+class Loopback final
+    : public TcpServer::Delegate,
+      public TcpChannel::Listener
+{
+public:
+    Loopback(std::shared_ptr<CryptoWorkerPool> worker_pool,
+             size_t message_size,
+             int message_count,
+             std::promise<bool>* finished)
+        : worker_pool_(std::move(worker_pool)),
+          message_size_(message_size),
+          message_count_(message_count),
+          finished_(finished)
+    {
+        // Nothing
+    }
+
+    ~Loopback() final = default;
+
+    // Starts the server on a port chosen by the system and connects the client to it.
+    bool start()
+    {
+        if (!server_.start(u"127.0.0.1", 0, this))
+            return false;
+
+        client_channel_ = std::make_unique<TcpChannel>();
+        setupChannel(client_channel_.get());
+        client_channel_->connect(u"127.0.0.1", server_.port());
+        return true;
+    }
+
+    // TcpServer::Delegate implementation.
+    void onNewConnection(std::unique_ptr<TcpChannel> channel) final
+    {
+        server_channel_ = std::move(channel);
+        setupChannel(server_channel_.get());
+        server_channel_->resume();
+    }
+
+    // TcpChannel::Listener implementation.
+    void onTcpConnected() final
+    {
+        // Every third message is small, so small and large messages are mixed in the queue.
+        for (int i = 0; i < message_count_; ++i)
+            client_channel_->send(0, createMessage(i));
+    }
+
+    void onTcpDisconnected(NetworkChannel::ErrorCode /* error_code */) final
+    {
+        finish(false);
+    }
+
+    void onTcpMessageReceived(uint8_t /* channel_id */, const ByteArray& buffer) final
+    {
+        ByteArray expected = createMessage(received_count_);
+
+        if (buffer != expected)
+        {
+            finish(false);
+            return;
+        }
+
+        if (++received_count_ == message_count_)
+            finish(true);
+    }
+
+    void onTcpMessageWritten(uint8_t /* channel_id */, ByteArray&& /* buffer */,
+                             size_t /* pending */) final
+    {
+        // Nothing
+    }
+
+private:
+    void setupChannel(TcpChannel* channel)
+    {
+        // The same key and IV are used for both directions of the test connection.
+        ByteArray key(32, 0x5A);
+        ByteArray iv(12, 0xA5);
+
+        channel->setListener(this);
+        channel->setEncryptor(MessageEncryptorOpenssl::createForAes256Gcm(key, iv));
+        channel->setDecryptor(MessageDecryptorOpenssl::createForAes256Gcm(key, iv));
+
+        if (worker_pool_)
+            channel->setWorkerPool(worker_pool_);
+    }
+
+    ByteArray createMessage(int index) const
+    {
+        ByteArray message((index % 3) ? message_size_ : 100, static_cast<uint8_t>(index));
+        const uint32_t number = static_cast<uint32_t>(index);
+        memcpy(message.data(), &number, sizeof(number));
+        return message;
+    }
+
+    void finish(bool result)
+    {
+        if (!finished_)
+            return;
+
+        finished_->set_value(result);
+        finished_ = nullptr;
+    }
+
+    std::shared_ptr<CryptoWorkerPool> worker_pool_;
+    const size_t message_size_;
+    const int message_count_;
+    std::promise<bool>* finished_;
+
+    TcpServer server_;
+    std::unique_ptr<TcpChannel> client_channel_;
+    std::unique_ptr<TcpChannel> server_channel_;
+    int received_count_ = 0;
+
+    DISALLOW_COPY_AND_ASSIGN(Loopback);
+};
+
+// Returns the time of the transfer or zero if the messages were not received.
+std::chrono::nanoseconds transfer(std::shared_ptr<CryptoWorkerPool> worker_pool,
+                                  size_t message_size,
+                                  int message_count)
+{
+    Thread thread;
+    thread.start(MessageLoop::Type::ASIO);
+
+    std::shared_ptr<TaskRunner> task_runner = thread.taskRunner();
+    std::unique_ptr<Loopback> loopback;
+    std::promise<bool> started;
+    std::promise<bool> finished;
+
+    auto start_time = std::chrono::steady_clock::now();
+
+    task_runner->postTask([&]()
+    {
+        loopback = std::make_unique<Loopback>(
+            std::move(worker_pool), message_size, message_count, &finished);
+        started.set_value(loopback->start());
+    });
+
+    const bool is_started = started.get_future().get();
+    EXPECT_TRUE(is_started) << "Unable to start the server";
+
+    const bool result = is_started && finished.get_future().get();
+
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start_time);
+
+    std::promise<void> destroyed;
+    task_runner->postTask([&]()
+    {
+        loopback.reset();
+        destroyed.set_value();
+    });
+
+    destroyed.get_future().wait();
+    thread.stop();
+
+    return result ? duration : std::chrono::nanoseconds::zero();
+}
+
+} // namespace
+
+TEST(tcp_channel_test, transfer)
+{
+    EXPECT_NE(transfer(nullptr, 200 * 1024, 30).count(), 0);
+}
+
+TEST(tcp_channel_test, transfer_with_worker_pool)
+{
+    EXPECT_NE(transfer(std::make_shared<CryptoWorkerPool>(2), 200 * 1024, 30).count(), 0);
+}
+
+TEST(tcp_channel_test, DISABLED_benchmark)
+{
+    const size_t kMessageSize = 2 * 1024 * 1024;
+    const int kMessageCount = 300;
+
+    for (bool use_worker_pool : { false, true })
+    {
+        std::shared_ptr<CryptoWorkerPool> worker_pool;
+        if (use_worker_pool)
+            worker_pool = std::make_shared<CryptoWorkerPool>(2);
+
+        std::chrono::nanoseconds duration = transfer(worker_pool, kMessageSize, kMessageCount);
+        ASSERT_NE(duration.count(), 0);
+
+        // Every third message is small.
+        const double megabytes =
+            static_cast<double>(kMessageSize * (kMessageCount * 2 / 3)) / (1024 * 1024);
+
+        std::cout << (use_worker_pool ? "worker pool: " : "network thread: ")
+                  << static_cast<int>(megabytes * 1e9 / static_cast<double>(duration.count()))
+                  << " MB/s" << std::endl;
+    }
+}
+
+} // namespace base
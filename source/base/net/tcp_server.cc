@@ -34,7 +34,7 @@ public:
     explicit Impl(asio::io_context& io_context);
     ~Impl();
 
-    void start(std::u16string_view listen_interface, uint16_t port, Delegate* delegate);
+    bool start(std::u16string_view listen_interface, uint16_t port, Delegate* delegate);
     void stop();
 
     std::u16string listenInterface() const;
@@ -71,7 +71,7 @@ TcpServer::Impl::~Impl()
 }
 
 //--------------------------------------------------------------------------------------------------
-void TcpServer::Impl::start(std::u16string_view listen_interface, uint16_t port, Delegate* delegate)
+bool TcpServer::Impl::start(std::u16string_view listen_interface, uint16_t port, Delegate* delegate)
 {
     delegate_ = delegate;
     listen_interface_ = listen_interface;
@@ -93,7 +93,7 @@ void TcpServer::Impl::start(std::u16string_view listen_interface, uint16_t port,
         {
             LOG(LS_ERROR) << "Invalid listen address: " << listen_interface_
                           << " (" << base::utf16FromLocal8Bit(error_code.message()) << ")";
-            return;
+            return false;
         }
     }
     else
@@ -109,7 +109,7 @@ void TcpServer::Impl::start(std::u16string_view listen_interface, uint16_t port,
     {
         LOG(LS_ERROR) << "acceptor_->open failed: "
                       << base::utf16FromLocal8Bit(error_code.message());
-        return;
+        return false;
     }
 
     acceptor_->set_option(asio::ip::tcp::acceptor::reuse_address(true), error_code);
@@ -117,7 +117,7 @@ void TcpServer::Impl::start(std::u16string_view listen_interface, uint16_t port,
     {
         LOG(LS_ERROR) << "acceptor_->set_option failed: "
                       << base::utf16FromLocal8Bit(error_code.message());
-        return;
+        return false;
     }
 
     acceptor_->bind(endpoint, error_code);
@@ -125,7 +125,7 @@ void TcpServer::Impl::start(std::u16string_view listen_interface, uint16_t port,
     {
         LOG(LS_ERROR) << "acceptor_->bind failed: "
                       << base::utf16FromLocal8Bit(error_code.message());
-        return;
+        return false;
     }
 
     acceptor_->listen(asio::ip::tcp::socket::max_listen_connections, error_code);
@@ -133,10 +133,25 @@ void TcpServer::Impl::start(std::u16string_view listen_interface, uint16_t port,
     {
         LOG(LS_ERROR) << "acceptor_->listen failed: "
                       << base::utf16FromLocal8Bit(error_code.message());
-        return;
+        return false;
+    }
+
+    if (!port_)
+    {
+        // The port was chosen by the system.
+        port_ = acceptor_->local_endpoint(error_code).port();
+        if (error_code)
+        {
+            LOG(LS_ERROR) << "acceptor_->local_endpoint failed: "
+                          << base::utf16FromLocal8Bit(error_code.message());
+            return false;
+        }
+
+        LOG(LS_INFO) << "Listen port: " << port_;
     }
 
     doAccept();
+    return true;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -216,9 +231,9 @@ TcpServer::~TcpServer()
 }
 
 //--------------------------------------------------------------------------------------------------
-void TcpServer::start(std::u16string_view listen_interface, uint16_t port, Delegate* delegate)
+bool TcpServer::start(std::u16string_view listen_interface, uint16_t port, Delegate* delegate)
 {
-    impl_->start(listen_interface, port, delegate);
+    return impl_->start(listen_interface, port, delegate);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -44,7 +44,9 @@ public:
         virtual void onNewConnection(std::unique_ptr<TcpChannel> channel) = 0;
     };
 
-    void start(std::u16string_view listen_interface, uint16_t port, Delegate* delegate);
+    // Returns false if the server could not listen. If |port| is zero, the system chooses a free
+    // port, which port() returns after a successful start.
+    bool start(std::u16string_view listen_interface, uint16_t port, Delegate* delegate);
     void stop();
 
     std::u16string listenInterface() const;
@@ -23,48 +23,35 @@
 namespace base {
 
 //--------------------------------------------------------------------------------------------------
-VariableSizeReader::VariableSizeReader() = default;
-
-//--------------------------------------------------------------------------------------------------
-VariableSizeReader::~VariableSizeReader() = default;
-
-//--------------------------------------------------------------------------------------------------
-asio::mutable_buffer VariableSizeReader::buffer()
+// static
+size_t VariableSizeReader::read(const uint8_t* data, size_t size, size_t* value)
 {
-    DCHECK_LT(pos_, std::size(buffer_));
+    DCHECK(value);
 
-    return asio::mutable_buffer(&buffer_[pos_], sizeof(uint8_t));
-}
-
-//--------------------------------------------------------------------------------------------------
-std::optional<size_t> VariableSizeReader::messageSize()
-{
-    DCHECK_LT(pos_, std::size(buffer_));
+    size_t result = 0;
 
-    if (pos_ == 3 || !(buffer_[pos_] & 0x80))
+    for (size_t i = 0; i < 3; ++i)
     {
-        size_t result = buffer_[0] & 0x7F;
+        if (i >= size)
+            return 0;
 
-        if (pos_ >= 1)
-            result += (buffer_[1] & 0x7F) << 7;
+        result += static_cast<size_t>(data[i] & 0x7F) << (i * 7);
 
-        if (pos_ >= 2)
-            result += (buffer_[2] & 0x7F) << 14;
+        if (!(data[i] & 0x80))
+        {
+            *value = result;
+            return i + 1;
+        }
+    }
 
-        if (pos_ >= 3)
-            result += buffer_[3] << 21;
+    if (size < 4)
+        return 0;
 
-        memset(buffer_, 0, std::size(buffer_));
-        pos_ = 0;
+    // The fourth byte uses all 8 bits.
+    result += static_cast<size_t>(data[3]) << 21;
 
-        return result;
-    }
-    else
-    {
-        ++pos_;
-
-        return std::nullopt;
-    }
+    *value = result;
+    return 4;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -23,25 +23,20 @@
 
 #include <asio/buffer.hpp>
 
+#include <cstddef>
 #include <cstdint>
-#include <optional>
 
 namespace base {
 
 class VariableSizeReader
 {
 public:
-    VariableSizeReader();
-    ~VariableSizeReader();
-
-    asio::mutable_buffer buffer();
-    std::optional<size_t> messageSize();
+    // Reads the size from |data|. Returns the number of bytes that contain the size or 0 if |size|
+    // bytes are not enough to read it.
+    static size_t read(const uint8_t* data, size_t size, size_t* value);
 
 private:
-    uint8_t buffer_[4] = { 0 };
-    size_t pos_ = 0;
-
-    DISALLOW_COPY_AND_ASSIGN(VariableSizeReader);
+    DISALLOW_IMPLICIT_CONSTRUCTORS(VariableSizeReader);
 };
 
 class VariableSizeWriter
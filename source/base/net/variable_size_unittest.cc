@@ -0,0 +1,59 @@
+//
+// Aspia Project
+// Copyright (C) 2016-2025 Dmitry Chapyshev <dmitry@aspia.ru>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "base/net/variable_size.h"
+
+#include <gtest/gtest.h>
+
+namespace base {
+
+TEST(VariableSizeTest, WriteRead)
+{
+    const size_t kTestTable[] =
+    {
+        0, 1, 0x7F, 0x80, 0x3FFF, 0x4000, 0x1FFFF, 0x20000, 0x1FFFFF, 7 * 1024 * 1024
+    };
+
+    VariableSizeWriter writer;
+
+    for (size_t i = 0; i < std::size(kTestTable); ++i)
+    {
+        asio::const_buffer buffer = writer.variableSize(kTestTable[i]);
+        const uint8_t* data = static_cast<const uint8_t*>(buffer.data());
+
+        size_t value = 0;
+        EXPECT_EQ(VariableSizeReader::read(data, buffer.size(), &value), buffer.size());
+        EXPECT_EQ(value, kTestTable[i]);
+
+        // Not enough data to read the size.
+        for (size_t size = 0; size < buffer.size(); ++size)
+            EXPECT_EQ(VariableSizeReader::read(data, size, &value), 0U);
+    }
+}
+
+TEST(VariableSizeTest, ReadFromStream)
+{
+    // The size is followed by the message data.
+    const uint8_t kData[] = { 0x81, 0x01, 0xAA, 0xBB };
+
+    size_t value = 0;
+    EXPECT_EQ(VariableSizeReader::read(kData, std::size(kData), &value), 2U);
+    EXPECT_EQ(value, 0x81U);
+}
+
+} // namespace base
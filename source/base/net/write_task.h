@@ -53,6 +53,9 @@ public:
     WriteTask(const WriteTask& other) = default;
     WriteTask& operator=(const WriteTask& other) = default;
 
+    WriteTask(WriteTask&& other) = default;
+    WriteTask& operator=(WriteTask&& other) = default;
+
     Type type() const { return type_; }
     Priority priority() const { return priority_; }
     int sequenceNum() const { return sequence_num_; }
@@ -23,6 +23,8 @@
 #include "base/location.h"
 #include "base/logging.h"
 #include "base/sys_info.h"
+#include "base/task_runner.h"
+#include "base/crypto/crypto_worker_pool.h"
 #include "base/crypto/generic_hash.h"
 #include "base/crypto/random.h"
 #include "base/crypto/srp_constants.h"
@@ -36,6 +38,26 @@ namespace {
 
 constexpr size_t kIvSize = 12;
 
+// Input and output values of SRP calculations. While a calculation is running on the worker pool,
+// the values are owned by the calculation task.
+struct SrpData
+{
+    BigNum N;
+    BigNum g;
+    BigNum s;
+    BigNum v;
+    BigNum b;
+    BigNum B;
+    BigNum A;
+
+    // For an unknown user the verifier is calculated from the user name and the seed key.
+    bool fake_user = false;
+    std::u16string user_name;
+    ByteArray seed_key;
+
+    ByteArray srp_key;
+};
+
 //--------------------------------------------------------------------------------------------------
 const char* identifyToString(proto::Identify identify)
 {
@@ -52,11 +74,28 @@ const char* identifyToString(proto::Identify identify)
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+ByteArray createSrpKey(const SrpData& data)
+{
+    if (!SrpMath::verify_A_mod_N(data.A, data.N))
+    {
+        LOG(LS_ERROR) << "SrpMath::verify_A_mod_N failed";
+        return ByteArray();
+    }
+
+    BigNum u = SrpMath::calc_u(data.A, data.B, data.N);
+    BigNum server_key = SrpMath::calcServerKey(data.A, data.v, u, data.b, data.N);
+
+    return server_key.toByteArray();
+}
+
 } // namespace
 
 //--------------------------------------------------------------------------------------------------
 ServerAuthenticator::ServerAuthenticator(std::shared_ptr<TaskRunner> task_runner)
-    : Authenticator(std::move(task_runner))
+    : Authenticator(task_runner),
+      task_runner_(std::move(task_runner)),
+      alive_(std::make_shared<bool>(true))
 {
     LOG(LS_INFO) << "Ctor";
 }
@@ -65,6 +104,7 @@ ServerAuthenticator::ServerAuthenticator(std::shared_ptr<TaskRunner> task_runner
 ServerAuthenticator::~ServerAuthenticator()
 {
     LOG(LS_INFO) << "Dtor";
+    *alive_ = false;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -144,6 +184,12 @@ bool ServerAuthenticator::setAnonymousAccess(
     return true;
 }
 
+//--------------------------------------------------------------------------------------------------
+void ServerAuthenticator::setWorkerPool(std::shared_ptr<CryptoWorkerPool> worker_pool)
+{
+    worker_pool_ = std::move(worker_pool);
+}
+
 //--------------------------------------------------------------------------------------------------
 bool ServerAuthenticator::onStarted()
 {
@@ -206,6 +252,12 @@ void ServerAuthenticator::onReceived(const ByteArray& buffer)
             onSessionResponse(buffer);
             break;
 
+        case InternalState::CALC_SERVER_KEY_EXCHANGE:
+        case InternalState::CALC_SRP_KEY:
+            // The client must wait for our reply.
+            finish(FROM_HERE, ErrorCode::PROTOCOL_ERROR);
+            break;
+
         default:
             NOTREACHED();
             break;
@@ -443,6 +495,8 @@ void ServerAuthenticator::onIdentify(const ByteArray& buffer)
 
     LOG(LS_INFO) << "Username: '" << user_name_ << "'";
 
+    std::shared_ptr<SrpData> data = std::make_shared<SrpData>();
+
     do
     {
         std::u16string user_name_utf16 = base::utf16FromUtf8(user_name_);
@@ -503,13 +557,49 @@ void ServerAuthenticator::onIdentify(const ByteArray& buffer)
         N_ = BigNum::fromStdString(kSrpNgPair_8192.first);
         g_ = BigNum::fromStdString(kSrpNgPair_8192.second);
         s_ = BigNum::fromByteArray(hash.result());
-        v_ = SrpMath::calc_v(user_name_utf16, seed_key, s_, N_, g_);
+
+        data->fake_user = true;
+        data->user_name = std::move(user_name_utf16);
+        data->seed_key = std::move(seed_key);
     }
     while (false);
 
     b_ = BigNum::fromByteArray(Random::byteArray(128)); // 1024 bits.
-    B_ = SrpMath::calc_B(b_, N_, g_, v_);
 
+    data->N = std::move(N_);
+    data->g = std::move(g_);
+    data->s = std::move(s_);
+    data->v = std::move(v_);
+    data->b = std::move(b_);
+
+    internal_state_ = InternalState::CALC_SERVER_KEY_EXCHANGE;
+
+    runSrpTask([data]()
+    {
+        if (data->fake_user)
+        {
+            data->v = SrpMath::calc_v(
+                data->user_name, data->seed_key, data->s, data->N, data->g);
+        }
+
+        data->B = SrpMath::calc_B(data->b, data->N, data->g, data->v);
+    },
+    [this, data]()
+    {
+        N_ = std::move(data->N);
+        g_ = std::move(data->g);
+        s_ = std::move(data->s);
+        v_ = std::move(data->v);
+        b_ = std::move(data->b);
+        B_ = std::move(data->B);
+
+        onServerKeyExchangeReady();
+    });
+}
+
+//--------------------------------------------------------------------------------------------------
+void ServerAuthenticator::onServerKeyExchangeReady()
+{
     if (!N_.isValid() || !g_.isValid() || !s_.isValid() || !B_.isValid())
     {
         finish(FROM_HERE, ErrorCode::PROTOCOL_ERROR);
@@ -554,7 +644,28 @@ void ServerAuthenticator::onClientKeyExchange(const ByteArray& buffer)
         return;
     }
 
-    ByteArray srp_key = createSrpKey();
+    std::shared_ptr<SrpData> data = std::make_shared<SrpData>();
+    data->N = std::move(N_);
+    data->v = std::move(v_);
+    data->b = std::move(b_);
+    data->B = std::move(B_);
+    data->A = std::move(A_);
+
+    internal_state_ = InternalState::CALC_SRP_KEY;
+
+    runSrpTask([data]()
+    {
+        data->srp_key = createSrpKey(*data);
+    },
+    [this, data]()
+    {
+        onSrpKeyReady(data->srp_key);
+    });
+}
+
+//--------------------------------------------------------------------------------------------------
+void ServerAuthenticator::onSrpKeyReady(const ByteArray& srp_key)
+{
     if (srp_key.empty())
     {
         finish(FROM_HERE, ErrorCode::UNKNOWN_ERROR);
@@ -694,18 +805,23 @@ void ServerAuthenticator::onSessionResponse(const ByteArray& buffer)
 }
 
 //--------------------------------------------------------------------------------------------------
-ByteArray ServerAuthenticator::createSrpKey()
+void ServerAuthenticator::runSrpTask(std::function<void()> task, std::function<void()> reply)
 {
-    if (!SrpMath::verify_A_mod_N(A_, N_))
+    if (!worker_pool_)
     {
-        LOG(LS_ERROR) << "SrpMath::verify_A_mod_N failed";
-        return ByteArray();
+        task();
+        reply();
+        return;
     }
 
-    BigNum u = SrpMath::calc_u(A_, B_, N_);
-    BigNum server_key = SrpMath::calcServerKey(A_, v_, u, b_, N_);
-
-    return server_key.toByteArray();
+    worker_pool_->postTaskAndReply(std::move(task), task_runner_,
+        [this, alive = alive_, reply = std::move(reply)]()
+    {
+        // The authenticator could be finished by timeout or disconnection while the task was
+        // running.
+        if (*alive && state() == State::PENDING)
+            reply();
+    });
 }
 
 } // namespace base
@@ -27,6 +27,7 @@
 
 namespace base {
 
+class CryptoWorkerPool;
 class UserListBase;
 
 class ServerAuthenticator final : public Authenticator
@@ -53,6 +54,10 @@ public:
     // By default, anonymous access is disabled.
     [[nodiscard]] bool setAnonymousAccess(AnonymousAccess anonymous_access, uint32_t session_types);
 
+    // Sets the pool for SRP calculations. If the pool is not set, calculations are performed on
+    // the authenticator thread.
+    void setWorkerPool(std::shared_ptr<CryptoWorkerPool> worker_pool);
+
 protected:
     // Authenticator implementation.
     [[nodiscard]] bool onStarted() final;
@@ -62,10 +67,18 @@ protected:
 private:
     void onClientHello(const ByteArray& buffer);
     void onIdentify(const ByteArray& buffer);
+    void onServerKeyExchangeReady();
     void onClientKeyExchange(const ByteArray& buffer);
+    void onSrpKeyReady(const ByteArray& srp_key);
     void doSessionChallenge();
     void onSessionResponse(const ByteArray& buffer);
-    [[nodiscard]] ByteArray createSrpKey();
+    void runSrpTask(std::function<void()> task, std::function<void()> reply);
+
+    std::shared_ptr<TaskRunner> task_runner_;
+    std::shared_ptr<CryptoWorkerPool> worker_pool_;
+
+    // Cleared in the destructor. Results of SRP calculations posted after that are ignored.
+    std::shared_ptr<bool> alive_;
 
     base::local_shared_ptr<UserListBase> user_list_;
 
@@ -74,8 +87,10 @@ private:
         READ_CLIENT_HELLO,
         SEND_SERVER_HELLO,
         READ_IDENTIFY,
+        CALC_SERVER_KEY_EXCHANGE,
         SEND_SERVER_KEY_EXCHANGE,
         READ_CLIENT_KEY_EXCHANGE,
+        CALC_SRP_KEY,
         SEND_SESSION_CHALLENGE,
         READ_SESSION_RESPONSE
     };
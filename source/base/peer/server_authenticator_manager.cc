@@ -20,6 +20,7 @@
 
 #include "base/logging.h"
 #include "base/task_runner.h"
+#include "base/crypto/crypto_worker_pool.h"
 #include "base/peer/user_list_base.h"
 
 namespace base {
@@ -61,14 +62,34 @@ void ServerAuthenticatorManager::setAnonymousAccess(
     anonymous_session_types_ = session_types;
 }
 
+//--------------------------------------------------------------------------------------------------
+void ServerAuthenticatorManager::setWorkerPool(std::shared_ptr<CryptoWorkerPool> worker_pool)
+{
+    worker_pool_ = std::move(worker_pool);
+}
+
+//--------------------------------------------------------------------------------------------------
+void ServerAuthenticatorManager::setMaxPendingChannels(size_t max_pending_channels)
+{
+    max_pending_channels_ = max_pending_channels;
+}
+
 //--------------------------------------------------------------------------------------------------
 void ServerAuthenticatorManager::addNewChannel(std::unique_ptr<TcpChannel> channel)
 {
     DCHECK(channel);
 
+    if (max_pending_channels_ && pending_.size() >= max_pending_channels_)
+    {
+        LOG(LS_ERROR) << "Too many pending authentications (" << pending_.size()
+                      << "). Connection rejected";
+        return;
+    }
+
     std::unique_ptr<ServerAuthenticator> authenticator =
         std::make_unique<ServerAuthenticator>(task_runner_);
     authenticator->setUserList(user_list_);
+    authenticator->setWorkerPool(worker_pool_);
 
     if (!private_key_.empty())
     {
@@ -23,6 +23,8 @@
 
 namespace base {
 
+class CryptoWorkerPool;
+
 class ServerAuthenticatorManager
 {
 public:
@@ -65,6 +67,13 @@ public:
     void setAnonymousAccess(
         ServerAuthenticator::AnonymousAccess anonymous_access, uint32_t session_types);
 
+    // Sets the pool on which SRP calculations of all authenticators are performed.
+    void setWorkerPool(std::shared_ptr<CryptoWorkerPool> worker_pool);
+
+    // Sets the maximum number of channels that are authenticated at the same time. Channels that
+    // exceed the limit are closed immediately. 0 means no limit (by default).
+    void setMaxPendingChannels(size_t max_pending_channels);
+
     // Adds a channel to the authentication queue. After success completion, a session will be
     // created (in a stopped state) and method Delegate::onNewSession will be called.
     // If authentication fails, the channel will be automatically deleted.
@@ -74,6 +83,7 @@ private:
     void onComplete();
 
     std::shared_ptr<TaskRunner> task_runner_;
+    std::shared_ptr<CryptoWorkerPool> worker_pool_;
     base::local_shared_ptr<UserListBase> user_list_;
     std::vector<std::unique_ptr<ServerAuthenticator>> pending_;
 
@@ -83,6 +93,7 @@ private:
         ServerAuthenticator::AnonymousAccess::DISABLE;
 
     uint32_t anonymous_session_types_ = 0;
+    size_t max_pending_channels_ = 0;
 
     Delegate* delegate_;
 
@@ -20,14 +20,40 @@
 
 #include "base/logging.h"
 #include "base/task_runner.h"
+#include "base/crypto/crypto_worker_pool.h"
 #include "client/status_window_proxy.h"
 
 #if defined(OS_MAC)
 #include "base/mac/app_nap_blocker.h"
 #endif // defined(OS_MAC)
 
+#include <mutex>
+
 namespace client {
 
+namespace {
+
+// Returns the worker pool shared by all client sessions. The pool is created with the first
+// session that uses it and destroyed with the last one.
+std::shared_ptr<base::CryptoWorkerPool> sharedWorkerPool()
+{
+    static std::mutex lock;
+    static std::weak_ptr<base::CryptoWorkerPool> weak_pool;
+
+    std::scoped_lock scoped_lock(lock);
+
+    std::shared_ptr<base::CryptoWorkerPool> pool = weak_pool.lock();
+    if (!pool)
+    {
+        pool = std::make_shared<base::CryptoWorkerPool>(1);
+        weak_pool = pool;
+    }
+
+    return pool;
+}
+
+} // namespace
+
 //--------------------------------------------------------------------------------------------------
 Client::Client(std::shared_ptr<base::TaskRunner> io_task_runner)
     : io_task_runner_(std::move(io_task_runner))
@@ -314,10 +340,8 @@ void Client::onTcpMessageReceived(uint8_t channel_id, const base::ByteArray& buf
 }
 
 //--------------------------------------------------------------------------------------------------
-void Client::onTcpMessageWritten(uint8_t channel_id, base::ByteArray&& buffer, size_t pending)
+void Client::onTcpMessageWritten(uint8_t channel_id, base::ByteArray&& /* buffer */, size_t pending)
 {
-    serializer_.addBuffer(std::move(buffer));
-
     if (channel_id == proto::HOST_CHANNEL_ID_SESSION)
     {
         onSessionMessageWritten(channel_id, pending);
@@ -396,6 +420,16 @@ void Client::startAuthentication()
     channel_->setNoDelay(true);
     channel_->setKeepAlive(true);
 
+    proto::SessionType session_type = session_state_->sessionType();
+    if (session_type == proto::SESSION_TYPE_DESKTOP_MANAGE ||
+        session_type == proto::SESSION_TYPE_DESKTOP_VIEW ||
+        session_type == proto::SESSION_TYPE_FILE_TRANSFER)
+    {
+        // Large messages (video key frames, file chunks) are decrypted on a separate thread, so
+        // that the I/O thread keeps handling other messages.
+        channel_->setWorkerPool(sharedWorkerPool());
+    }
+
     authenticator_ = std::make_unique<base::ClientAuthenticator>(io_task_runner_);
 
     authenticator_->setIdentify(proto::IDENTIFY_SRP);
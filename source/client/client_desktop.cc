@@ -24,13 +24,13 @@
 #include "base/codec/audio_decoder_opus.h"
 #include "base/codec/cursor_decoder.h"
 #include "base/codec/video_decoder.h"
-#include "base/codec/webm_file_writer.h"
-#include "base/codec/webm_video_encoder.h"
+#include "base/desktop/frame.h"
 #include "base/desktop/mouse_cursor.h"
 #include "client/desktop_control_proxy.h"
 #include "client/desktop_window.h"
 #include "client/desktop_window_proxy.h"
 #include "client/config_factory.h"
+#include "client/video_recorder.h"
 #include "common/desktop_session_constants.h"
 
 namespace client {
@@ -248,6 +248,9 @@ void ClientDesktop::setDesktopConfig(const proto::DesktopConfig& desktop_config)
     outgoing_message_->Clear();
     outgoing_message_->mutable_config()->CopyFrom(desktop_config_);
 
+    // Features of our video decoders.
+    outgoing_message_->mutable_config()->set_video_features(proto::VIDEO_FEATURE_ZSTD_REFERENCE);
+
     LOG(LS_INFO) << "Send new config to host";
     sendMessage(proto::HOST_CHANNEL_ID_SESSION, *outgoing_message_);
 }
@@ -354,32 +357,17 @@ void ClientDesktop::setVideoRecording(bool enable, const std::filesystem::path&
 
         video_recording.set_action(proto::VideoRecording::ACTION_STARTED);
 
-        webm_file_writer_ =
-            std::make_unique<base::WebmFileWriter>(file_path, sessionState()->computerName());
-        webm_video_encoder_ = std::make_unique<base::WebmVideoEncoder>();
-
-        webm_video_encode_timer_ = std::make_unique<base::WaitableTimer>(
-            base::WaitableTimer::Type::REPEATED, ioTaskRunner());
-        webm_video_encode_timer_->start(std::chrono::milliseconds(60), [this]()
-        {
-            if (!webm_video_encoder_ || !webm_file_writer_ || !desktop_frame_)
-                return;
-
-            proto::VideoPacket packet;
-
-            if (webm_video_encoder_->encode(*desktop_frame_, &packet))
-                webm_file_writer_->addVideoPacket(packet);
-        });
+        // The host sends a key frame with the video format when it receives the notification.
+        // VP8 and VP9 packets are written to the file from it without re-encoding.
+        video_recorder_ =
+            std::make_unique<VideoRecorder>(file_path, sessionState()->computerName());
     }
     else
     {
         LOG(LS_INFO) << "Video recording disabled";
 
         video_recording.set_action(proto::VideoRecording::ACTION_STOPPED);
-
-        webm_video_encode_timer_.reset();
-        webm_video_encoder_.reset();
-        webm_file_writer_.reset();
+        video_recorder_.reset();
     }
 
     outgoing_message_->Clear();
@@ -650,6 +638,35 @@ void ClientDesktop::readVideoPacket(const proto::VideoPacket& packet)
         return;
     }
 
+    if (video_recorder_)
+    {
+        if (VideoRecorder::isRemuxSupported(packet.encoding()))
+        {
+            video_recorder_->addVideoPacket(packet);
+        }
+        else
+        {
+            // Other encodings are encoded again. Only the changed part of the frame is copied.
+            base::Region dirty_region;
+
+            if (packet.has_format())
+            {
+                dirty_region.addRect(base::Rect::makeSize(desktop_frame_->size()));
+            }
+            else
+            {
+                for (int i = 0; i < packet.dirty_rect_size(); ++i)
+                {
+                    const proto::Rect& rect = packet.dirty_rect(i);
+                    dirty_region.addRect(
+                        base::Rect::makeXYWH(rect.x(), rect.y(), rect.width(), rect.height()));
+                }
+            }
+
+            video_recorder_->addFrame(*desktop_frame_, dirty_region);
+        }
+    }
+
     ++video_packet_count_;
     ++fps_frame_count_;
 
@@ -665,8 +682,8 @@ void ClientDesktop::readVideoPacket(const proto::VideoPacket& packet)
 //--------------------------------------------------------------------------------------------------
 void ClientDesktop::readAudioPacket(const proto::AudioPacket& packet)
 {
-    if (webm_file_writer_)
-        webm_file_writer_->addAudioPacket(packet);
+    if (video_recorder_)
+        video_recorder_->addAudioPacket(packet);
 
     if (!audio_player_)
     {
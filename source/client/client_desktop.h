@@ -31,9 +31,6 @@ class AudioPlayer;
 class CursorDecoder;
 class Frame;
 class VideoDecoder;
-class WaitableTimer;
-class WebmFileWriter;
-class WebmVideoEncoder;
 } // namespace base
 
 namespace client {
@@ -42,6 +39,7 @@ class AudioRenderer;
 class DesktopControlProxy;
 class DesktopWindow;
 class DesktopWindowProxy;
+class VideoRecorder;
 
 class ClientDesktop final
     : public Client,
@@ -109,9 +107,7 @@ private:
 
     InputEventFilter input_event_filter_;
 
-    std::unique_ptr<base::WaitableTimer> webm_video_encode_timer_;
-    std::unique_ptr<base::WebmVideoEncoder> webm_video_encoder_;
-    std::unique_ptr<base::WebmFileWriter> webm_file_writer_;
+    std::unique_ptr<VideoRecorder> video_recorder_;
 
     using Clock = std::chrono::high_resolution_clock;
     using TimePoint = std::chrono::time_point<Clock>;
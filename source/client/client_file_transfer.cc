@@ -99,9 +99,6 @@ void ClientFileTransfer::onSessionMessageReceived(
 
         // Remove the request from the queue.
         remote_task_queue_.pop();
-
-        // Execute the next request.
-        doNextRemoteTask();
     }
     else
     {
@@ -154,28 +151,14 @@ void ClientFileTransfer::doTask(std::shared_ptr<common::FileTask> task)
     }
     else
     {
-        const bool schedule = remote_task_queue_.empty();
+        // Send a request to the remote computer without waiting for replies to previous requests.
+        // The host processes requests in the order they are received, so replies come in the
+        // same order.
+        sendMessage(proto::HOST_CHANNEL_ID_SESSION, task->request());
 
-        // Add the request to the queue.
+        // Add the request to the queue of requests waiting for a reply.
         remote_task_queue_.emplace(std::move(task));
-
-        // If the request queue was empty, then run execution.
-        if (schedule)
-            doNextRemoteTask();
-    }
-}
-
-//--------------------------------------------------------------------------------------------------
-void ClientFileTransfer::doNextRemoteTask()
-{
-    if (remote_task_queue_.empty())
-    {
-        LOG(LS_INFO) << "No more tasks";
-        return;
     }
-
-    // Send a request to the remote computer.
-    sendMessage(proto::HOST_CHANNEL_ID_SESSION, remote_task_queue_.front()->request());
 }
 
 //--------------------------------------------------------------------------------------------------
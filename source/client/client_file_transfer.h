@@ -67,8 +67,6 @@ protected:
     void onTaskDone(std::shared_ptr<common::FileTask> task) final;
 
 private:
-    void doNextRemoteTask();
-
     common::FileTaskFactory* taskFactory(common::FileTask::Target target);
 
     // FileControl implementation.
@@ -25,7 +25,8 @@
 #include "common/file_task_factory.h"
 #include "common/file_task_consumer_proxy.h"
 #include "common/file_task_producer_proxy.h"
-#include "common/file_packet.h"
+
+#include <algorithm>
 
 namespace client {
 
@@ -279,13 +280,30 @@ void FileTransfer::targetReply(const proto::FileRequest& request, const proto::F
             return;
         }
 
-        task_consumer_proxy_->doTask(
-            task_factory_source_->packetRequest(proto::FilePacketRequest::NO_FLAGS));
+        // Peers without support of the windowed mode do not send the window in reply.
+        size_t target_window_size = 1;
+        if (reply.has_window())
+            target_window_size = std::max(reply.window().window_size(), 1U);
+
+        window_size_ = std::min(source_window_size_, target_window_size);
+        LOG(LS_INFO) << "Transfer window size: " << window_size_;
+
+        doPacketRequests();
     }
     else if (request.has_packet())
     {
+        if (target_skip_count_)
+        {
+            --target_skip_count_;
+            return;
+        }
+
+        DCHECK_NE(target_in_flight_, 0U);
+        --target_in_flight_;
+
         if (reply.error_code() != proto::FILE_ERROR_SUCCESS)
         {
+            dropPacketsInFlight();
             onError(Error::Type::WRITE_FILE, reply.error_code(), frontTask().targetPath());
             return;
         }
@@ -293,15 +311,12 @@ void FileTransfer::targetReply(const proto::FileRequest& request, const proto::F
         const int64_t full_task_size = frontTask().size();
         if (full_task_size && total_size_)
         {
-            int64_t packet_size = common::kMaxFilePacketSize;
+            int64_t packet_size = static_cast<int64_t>(request.packet().data().size());
 
-            task_transfered_size_ += packet_size;
+            if (task_transfered_size_ + packet_size > full_task_size)
+                packet_size = full_task_size - task_transfered_size_;
 
-            if (task_transfered_size_ > full_task_size)
-            {
-                packet_size = task_transfered_size_ - full_task_size;
-                task_transfered_size_ = full_task_size;
-            }
+            task_transfered_size_ += packet_size;
 
             total_transfered_size_ += packet_size;
             bytes_per_time_ += packet_size;
@@ -322,15 +337,12 @@ void FileTransfer::targetReply(const proto::FileRequest& request, const proto::F
 
         if (request.packet().flags() & proto::FilePacket::LAST_PACKET)
         {
+            DCHECK_EQ(target_in_flight_, 0U);
             doNextTask();
             return;
         }
 
-        uint32_t flags = proto::FilePacketRequest::NO_FLAGS;
-        if (is_canceled_)
-            flags = proto::FilePacketRequest::CANCEL;
-
-        task_consumer_proxy_->doTask(task_factory_source_->packetRequest(flags));
+        doPacketRequests();
     }
     else
     {
@@ -357,17 +369,41 @@ void FileTransfer::sourceReply(const proto::FileRequest& request, const proto::F
             return;
         }
 
-        task_consumer_proxy_->doTask(
-            task_factory_target_->upload(front_task.targetPath(), front_task.overwrite()));
+        // Peers without support of the windowed mode do not send the window in reply.
+        source_window_size_ = 1;
+        if (reply.has_window())
+            source_window_size_ = std::max(reply.window().window_size(), 1U);
+
+        task_consumer_proxy_->doTask(task_factory_target_->upload(
+            front_task.targetPath(), front_task.overwrite(), true));
     }
     else if (request.has_packet_request())
     {
+        if (source_skip_count_)
+        {
+            --source_skip_count_;
+            return;
+        }
+
+        DCHECK_NE(source_in_flight_, 0U);
+        --source_in_flight_;
+
         if (reply.error_code() != proto::FILE_ERROR_SUCCESS)
         {
+            dropPacketsInFlight();
             onError(Error::Type::READ_FILE, reply.error_code(), frontTask().sourcePath());
             return;
         }
 
+        if (reply.packet().flags() & proto::FilePacket::LAST_PACKET)
+        {
+            // Replies to the remaining requests do not contain data.
+            source_finished_ = true;
+            source_skip_count_ += source_in_flight_;
+            source_in_flight_ = 0;
+        }
+
+        ++target_in_flight_;
         task_consumer_proxy_->doTask(task_factory_target_->packet(reply.packet()));
     }
     else
@@ -420,6 +456,10 @@ void FileTransfer::doFrontTask(bool overwrite)
     task_percentage_ = 0;
     task_transfered_size_ = 0;
 
+    source_window_size_ = 1;
+    window_size_ = 1;
+    source_finished_ = false;
+
     Task& front_task = frontTask();
     front_task.setOverwrite(overwrite);
 
@@ -433,10 +473,36 @@ void FileTransfer::doFrontTask(bool overwrite)
     else
     {
         task_consumer_proxy_->doTask(
-            task_factory_source_->download(front_task.sourcePath()));
+            task_factory_source_->download(front_task.sourcePath(), true));
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+void FileTransfer::doPacketRequests()
+{
+    while (!source_finished_ && source_in_flight_ + target_in_flight_ < window_size_)
+    {
+        uint32_t flags = proto::FilePacketRequest::NO_FLAGS;
+        if (is_canceled_)
+            flags = proto::FilePacketRequest::CANCEL;
+
+        ++source_in_flight_;
+        task_consumer_proxy_->doTask(task_factory_source_->packetRequest(flags));
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+void FileTransfer::dropPacketsInFlight()
+{
+    source_skip_count_ += source_in_flight_;
+    target_skip_count_ += target_in_flight_;
+
+    source_in_flight_ = 0;
+    target_in_flight_ = 0;
+
+    source_finished_ = true;
+}
+
 //--------------------------------------------------------------------------------------------------
 void FileTransfer::doNextTask()
 {
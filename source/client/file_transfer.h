@@ -184,6 +184,8 @@ private:
     void sourceReply(const proto::FileRequest& request, const proto::FileReply& reply);
     void doFrontTask(bool overwrite);
     void doNextTask();
+    void doPacketRequests();
+    void dropPacketsInFlight();
     void doUpdateSpeed();
     void onError(Error::Type type, proto::FileError code, const std::string& path = std::string());
     void setActionForErrorType(Error::Type error_type, Error::Action action);
@@ -217,6 +219,17 @@ private:
 
     bool is_canceled_ = false;
 
+    // Windowed transfer state of the current file. Packets are requested from the source until
+    // the number of packets in flight reaches the window size. Replies to requests sent before an
+    // error or after the last packet are skipped.
+    size_t source_window_size_ = 1;
+    size_t window_size_ = 1;
+    size_t source_in_flight_ = 0;
+    size_t target_in_flight_ = 0;
+    size_t source_skip_count_ = 0;
+    size_t target_skip_count_ = 0;
+    bool source_finished_ = false;
+
     base::WaitableTimer speed_update_timer_;
     TimePoint begin_time_;
     int64_t bytes_per_time_ = 0;
@@ -29,8 +29,11 @@ namespace client {
 
 namespace {
 
-const size_t kNumberOfParallelTasks = 30;
-const std::chrono::seconds kTimeout { 15 };
+// Maximum number of computers checked at the same time.
+const size_t kNumberOfParallelTasks = 64;
+
+// A host that is online answers ClientHello within a few round trips.
+const std::chrono::seconds kTimeout { 5 };
 
 } // namespace
 
@@ -227,28 +230,33 @@ void OnlineCheckerDirect::start(const ComputerList& computers, Delegate* delegat
     size_t count = std::min(pending_queue_.size(), kNumberOfParallelTasks);
     while (count != 0)
     {
-        const Computer& computer = pending_queue_.front();
+        startNextInstance();
+        --count;
+    }
+}
 
-        uint16_t port = computer.port;
-        if (port == 0)
-            port = DEFAULT_HOST_TCP_PORT;
+//--------------------------------------------------------------------------------------------------
+void OnlineCheckerDirect::startNextInstance()
+{
+    DCHECK(!pending_queue_.empty());
 
-        std::unique_ptr<Instance> instance = std::make_unique<Instance>(
-            computer.computer_id, computer.address, port, task_runner_);
+    const Computer& computer = pending_queue_.front();
 
-        LOG(LS_INFO) << "Instance for '" << computer.computer_id << "' is created (address: "
-                     << computer.address << " port: " << port << ")";
-        work_queue_.emplace_back(std::move(instance));
-        pending_queue_.pop_front();
+    uint16_t port = computer.port;
+    if (port == 0)
+        port = DEFAULT_HOST_TCP_PORT;
 
-        --count;
-    }
+    std::unique_ptr<Instance> instance = std::make_unique<Instance>(
+        computer.computer_id, computer.address, port, task_runner_);
 
-    for (const auto& task : work_queue_)
-    {
-        task->start(std::bind(&OnlineCheckerDirect::onChecked, this,
-                              std::placeholders::_1, std::placeholders::_2));
-    }
+    LOG(LS_INFO) << "Instance for '" << computer.computer_id << "' is created (address: "
+                 << computer.address << " port: " << port << ")";
+
+    pending_queue_.pop_front();
+
+    work_queue_.emplace_back(std::move(instance));
+    work_queue_.back()->start(std::bind(&OnlineCheckerDirect::onChecked, this,
+                                        std::placeholders::_1, std::placeholders::_2));
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -264,38 +272,28 @@ void OnlineCheckerDirect::onChecked(int computer_id, bool online)
         return;
     }
 
-    if (!pending_queue_.empty())
-    {
-        const Computer& computer = pending_queue_.front();
-        std::unique_ptr<Instance> instance = std::make_unique<Instance>(
-            computer.computer_id, computer.address, computer.port, task_runner_);
-
-        LOG(LS_INFO) << "Instance for '" << computer.computer_id << "' is created (address: "
-                     << computer.address << " port: " << computer.port << ")";
-
-        work_queue_.emplace_back(std::move(instance));
-        work_queue_.back()->start(std::bind(&OnlineCheckerDirect::onChecked, this,
-                                            std::placeholders::_1, std::placeholders::_2));
-        pending_queue_.pop_front();
-    }
-    else
+    // The finished instance releases its connection, so that the number of open connections does
+    // not exceed the number of parallel tasks.
+    for (auto it = work_queue_.begin(); it != work_queue_.end(); ++it)
     {
-        for (auto it = work_queue_.begin(); it != work_queue_.end(); ++it)
+        if (it->get()->computerId() == computer_id)
         {
-            if (it->get()->computerId() == computer_id)
-            {
-                task_runner_->deleteSoon(std::move(*it));
-                work_queue_.erase(it);
-                break;
-            }
+            task_runner_->deleteSoon(std::move(*it));
+            work_queue_.erase(it);
+            break;
         }
+    }
 
-        if (work_queue_.empty())
-        {
-            LOG(LS_INFO) << "No more items in queue";
-            onFinished(FROM_HERE);
-            return;
-        }
+    if (!pending_queue_.empty())
+    {
+        startNextInstance();
+        return;
+    }
+
+    if (work_queue_.empty())
+    {
+        LOG(LS_INFO) << "No more items in queue";
+        onFinished(FROM_HERE);
     }
 }
 
@@ -29,6 +29,7 @@ namespace client {
 namespace {
 
 const std::chrono::seconds kTimeout { 30 };
+const size_t kMaxHostStatusListSize = 1000;
 
 } // namespace
 
@@ -110,8 +111,7 @@ void OnlineCheckerRouter::onTcpConnected()
 
             // Now the session will receive incoming messages.
             channel_->resume();
-
-            checkNextComputer();
+            probeHostStatusList();
         }
         else
         {
@@ -148,6 +148,39 @@ void OnlineCheckerRouter::onTcpMessageReceived(
         return;
     }
 
+    if (message.has_host_status_list())
+    {
+        const proto::HostStatusList& host_status_list = message.host_status_list();
+        if (static_cast<size_t>(host_status_list.status_size()) != pending_count_)
+        {
+            LOG(LS_ERROR) << "Unexpected number of statuses: " << host_status_list.status_size()
+                          << " (expected: " << pending_count_ << ")";
+        }
+
+        for (size_t i = 0; i < pending_count_ && !computers_.empty(); ++i)
+        {
+            // Hosts without status are considered offline.
+            bool online = i < static_cast<size_t>(host_status_list.status_size()) &&
+                host_status_list.status(static_cast<int>(i)) == proto::HostStatus::STATUS_ONLINE;
+
+            delegate_->onRouterCheckerResult(computers_.front().computer_id, online);
+            computers_.pop_front();
+        }
+
+        pending_count_ = 0;
+
+        if (host_status_list_probe_)
+        {
+            // The reply to the single host request of the probe is still expected.
+            LOG(LS_INFO) << "Router supports host status lists";
+            host_status_list_supported_ = true;
+            return;
+        }
+
+        checkNextComputers();
+        return;
+    }
+
     if (!message.has_host_status())
     {
         LOG(LS_ERROR) << "HostStatus not present in message";
@@ -155,6 +188,21 @@ void OnlineCheckerRouter::onTcpMessageReceived(
         return;
     }
 
+    if (host_status_list_probe_)
+    {
+        host_status_list_probe_ = false;
+
+        if (host_status_list_supported_)
+        {
+            // The host is already reported by the list reply.
+            checkNextComputers();
+            return;
+        }
+
+        LOG(LS_INFO) << "Router does not support host status lists";
+        pending_count_ = 0;
+    }
+
     bool online = message.host_status().status() == proto::HostStatus::STATUS_ONLINE;
     const Computer& computer = computers_.front();
 
@@ -191,6 +239,38 @@ void OnlineCheckerRouter::checkNextComputer()
     channel_->send(proto::ROUTER_CHANNEL_ID_SESSION, base::serialize(message));
 }
 
+//--------------------------------------------------------------------------------------------------
+void OnlineCheckerRouter::checkNextComputers()
+{
+    if (computers_.empty())
+    {
+        LOG(LS_INFO) << "No more computers";
+        onFinished(FROM_HERE);
+        return;
+    }
+
+    pending_count_ = std::min(computers_.size(), kMaxHostStatusListSize);
+
+    LOG(LS_INFO) << "Checking status for " << pending_count_ << " hosts (remaining: "
+                 << computers_.size() << ")";
+
+    proto::PeerToRouter message;
+    proto::CheckHostStatusList* check_host_status_list = message.mutable_check_host_status_list();
+
+    for (size_t i = 0; i < pending_count_; ++i)
+        check_host_status_list->add_host_id(computers_[i].host_id);
+
+    channel_->send(proto::ROUTER_CHANNEL_ID_SESSION, base::serialize(message));
+}
+
+//--------------------------------------------------------------------------------------------------
+void OnlineCheckerRouter::probeHostStatusList()
+{
+    host_status_list_probe_ = true;
+    checkNextComputers();
+    checkNextComputer();
+}
+
 //--------------------------------------------------------------------------------------------------
 void OnlineCheckerRouter::onFinished(const base::Location& location)
 {
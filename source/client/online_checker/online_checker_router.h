@@ -67,6 +67,8 @@ protected:
 
 private:
     void checkNextComputer();
+    void checkNextComputers();
+    void probeHostStatusList();
     void onFinished(const base::Location& location);
 
     std::shared_ptr<base::TaskRunner> task_runner_;
@@ -77,6 +79,15 @@ private:
 
     ComputerList computers_;
     Delegate* delegate_ = nullptr;
+
+    // The router checks a list of hosts in one request. Routers without support ignore the list
+    // request, so it is followed by a single host request: if the list reply does not come before
+    // the single reply, the router does not support it.
+    bool host_status_list_supported_ = false;
+    bool host_status_list_probe_ = false;
+
+    // Number of computers at the front of |computers_| for which a reply is expected.
+    size_t pending_count_ = 0;
 };
 
 } // namespace client
@@ -0,0 +1,180 @@
+//
+// Aspia Project
+// Copyright (C) 2016-2025 Dmitry Chapyshev <dmitry@aspia.ru>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "client/video_recorder.h"
+
+#include "base/logging.h"
+#include "base/task_runner.h"
+#include "base/codec/webm_file_writer.h"
+#include "base/codec/webm_video_encoder.h"
+#include "base/desktop/frame_simple.h"
+
+namespace client {
+
+namespace {
+
+// Frames are encoded not more often than this interval.
+const std::chrono::milliseconds kEncodeInterval { 60 };
+
+//--------------------------------------------------------------------------------------------------
+// Copies the pixels of |region| from |source| to |target|. If the size of the frames differs,
+// |target| is recreated and the whole frame is copied. Returns the copied region.
+base::Region copyFrame(const base::Frame& source,
+                       const base::Region& region,
+                       std::unique_ptr<base::Frame>* target)
+{
+    const base::Rect frame_rect = base::Rect::makeSize(source.size());
+    base::Region copy_region(region);
+
+    if (!*target || (*target)->size() != source.size())
+    {
+        *target = base::FrameSimple::create(source.size(), source.format());
+        if (!*target)
+        {
+            LOG(LS_ERROR) << "Unable to create frame: " << source.size();
+            return base::Region();
+        }
+
+        copy_region = base::Region(frame_rect);
+    }
+    else
+    {
+        copy_region.intersectWith(frame_rect);
+    }
+
+    for (base::Region::Iterator it(copy_region); !it.isAtEnd(); it.advance())
+        (*target)->copyPixelsFrom(source, it.rect().topLeft(), it.rect());
+
+    return copy_region;
+}
+
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+VideoRecorder::VideoRecorder(const std::filesystem::path& path, std::u16string_view name)
+    : file_writer_(std::make_unique<base::WebmFileWriter>(path, name))
+{
+    LOG(LS_INFO) << "Ctor";
+    thread_.start(base::MessageLoop::Type::DEFAULT);
+}
+
+//--------------------------------------------------------------------------------------------------
+VideoRecorder::~VideoRecorder()
+{
+    LOG(LS_INFO) << "Dtor";
+
+    // The thread no longer uses the writer after it is stopped. The file is closed here.
+    thread_.stop();
+    file_writer_.reset();
+}
+
+//--------------------------------------------------------------------------------------------------
+// static
+bool VideoRecorder::isRemuxSupported(proto::VideoEncoding encoding)
+{
+    return encoding == proto::VIDEO_ENCODING_VP8 || encoding == proto::VIDEO_ENCODING_VP9;
+}
+
+//--------------------------------------------------------------------------------------------------
+void VideoRecorder::addVideoPacket(const proto::VideoPacket& packet)
+{
+    DCHECK(isRemuxSupported(packet.encoding()));
+
+    thread_.taskRunner()->postTask([this, packet]()
+    {
+        // The next encoded frame starts a new file with its own key frame.
+        video_encoder_.reset();
+        file_writer_->addVideoPacket(packet);
+    });
+}
+
+//--------------------------------------------------------------------------------------------------
+void VideoRecorder::addFrame(const base::Frame& frame, const base::Region& dirty_region)
+{
+    {
+        std::scoped_lock lock(frame_lock_);
+
+        dirty_region_.addRegion(copyFrame(frame, dirty_region, &frame_));
+
+        if (dirty_region_.isEmpty() || encode_scheduled_)
+            return;
+
+        encode_scheduled_ = true;
+    }
+
+    thread_.taskRunner()->postTask(std::bind(&VideoRecorder::encodeFrame, this));
+}
+
+//--------------------------------------------------------------------------------------------------
+void VideoRecorder::addAudioPacket(const proto::AudioPacket& packet)
+{
+    thread_.taskRunner()->postTask([this, packet]()
+    {
+        file_writer_->addAudioPacket(packet);
+    });
+}
+
+//--------------------------------------------------------------------------------------------------
+void VideoRecorder::encodeFrame()
+{
+    const Clock::time_point current_time = Clock::now();
+    const Clock::duration elapsed = current_time - last_encode_time_;
+
+    if (elapsed < kEncodeInterval)
+    {
+        // The changes made until the interval expires are encoded in one frame.
+        thread_.taskRunner()->postDelayedTask(
+            std::bind(&VideoRecorder::encodeFrame, this),
+            std::chrono::duration_cast<std::chrono::milliseconds>(kEncodeInterval - elapsed));
+        return;
+    }
+
+    base::Region region;
+
+    {
+        std::scoped_lock lock(frame_lock_);
+
+        encode_scheduled_ = false;
+
+        if (!frame_)
+            return;
+
+        region = copyFrame(*frame_, dirty_region_, &encode_frame_);
+        dirty_region_.clear();
+    }
+
+    if (region.isEmpty())
+        return;
+
+    last_encode_time_ = current_time;
+
+    if (!video_encoder_)
+        video_encoder_ = std::make_unique<base::WebmVideoEncoder>();
+
+    proto::VideoPacket packet;
+
+    if (!video_encoder_->encode(*encode_frame_, region, &packet))
+    {
+        LOG(LS_ERROR) << "Unable to encode video frame";
+        return;
+    }
+
+    file_writer_->addVideoPacket(packet);
+}
+
+} // namespace client
@@ -0,0 +1,84 @@
+//
+// Aspia Project
+// Copyright (C) 2016-2025 Dmitry Chapyshev <dmitry@aspia.ru>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef CLIENT_VIDEO_RECORDER_H
+#define CLIENT_VIDEO_RECORDER_H
+
+#include "base/macros_magic.h"
+#include "base/desktop/region.h"
+#include "base/threading/thread.h"
+#include "proto/desktop.pb.h"
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+
+namespace base {
+class Frame;
+class WebmFileWriter;
+class WebmVideoEncoder;
+} // namespace base
+
+namespace client {
+
+// Writes the video and the audio of a desktop session to WebM files on a separate thread.
+// VP8 and VP9 packets received from the host are written as is. Frames of other encodings are
+// encoded to VP8 on the recorder thread, only when their content has changed.
+class VideoRecorder
+{
+public:
+    VideoRecorder(const std::filesystem::path& path, std::u16string_view name);
+    ~VideoRecorder();
+
+    // Returns true if packets of |encoding| can be written without re-encoding.
+    static bool isRemuxSupported(proto::VideoEncoding encoding);
+
+    // Queues the packet for writing. The packet must be VP8 or VP9.
+    void addVideoPacket(const proto::VideoPacket& packet);
+
+    // Queues the decoded frame for encoding. Only the pixels in |dirty_region| are copied.
+    void addFrame(const base::Frame& frame, const base::Region& dirty_region);
+
+    void addAudioPacket(const proto::AudioPacket& packet);
+
+private:
+    void encodeFrame();
+
+    using Clock = std::chrono::steady_clock;
+
+    base::Thread thread_;
+
+    // Used only on the recorder thread.
+    std::unique_ptr<base::WebmFileWriter> file_writer_;
+    std::unique_ptr<base::WebmVideoEncoder> video_encoder_;
+    std::unique_ptr<base::Frame> encode_frame_;
+    Clock::time_point last_encode_time_;
+
+    // Copy of the decoded frame and its region changed since the last encoding.
+    std::mutex frame_lock_;
+    std::unique_ptr<base::Frame> frame_;
+    base::Region dirty_region_;
+    bool encode_scheduled_ = false;
+
+    DISALLOW_COPY_AND_ASSIGN(VideoRecorder);
+};
+
+} // namespace client
+
+#endif // CLIENT_VIDEO_RECORDER_H
@@ -19,12 +19,22 @@
 #ifndef COMMON_FILE_PACKET_H
 #define COMMON_FILE_PACKET_H
 
+#include <cstddef>
+
 namespace common {
 
 // When transferring a file is divided into parts and each part is transmitted separately.
 // This parameter specifies the size of the part.
 static const size_t kMaxFilePacketSize = 64 * 1024; // 64 kB
 
+// Limits for the windowed transfer mode. The packet size is in the range from kMaxFilePacketSize
+// to kMaxWindowedFilePacketSize. The window size is the maximum number of packets that were sent
+// but not yet written by the target.
+static const size_t kMaxWindowedFilePacketSize = 1024 * 1024; // 1 MB
+static const size_t kDefaultWindowedFilePacketSize = 512 * 1024; // 512 kB
+static const size_t kDefaultFileWindowSize = 16;
+static const size_t kMaxFileWindowSize = 32;
+
 } // namespace common
 
 #endif // COMMON_FILE_PACKET_H
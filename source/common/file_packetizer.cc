@@ -35,17 +35,31 @@ char* outputBuffer(proto::FilePacket* packet, size_t size)
 } // namespace
 
 //--------------------------------------------------------------------------------------------------
-FilePacketizer::FilePacketizer(std::ifstream&& file_stream)
-    : file_stream_(std::move(file_stream))
+FilePacketizer::FilePacketizer(std::ifstream&& file_stream, size_t packet_size, size_t read_ahead)
+    : file_stream_(std::move(file_stream)),
+      packet_size_(packet_size),
+      read_ahead_(read_ahead)
 {
+    DCHECK_NE(packet_size_, 0U);
+
     file_stream_.seekg(0, file_stream_.end);
     file_size_ = static_cast<uint64_t>(file_stream_.tellg());
     file_stream_.seekg(0);
     left_size_ = file_size_;
+
+    if (read_ahead_)
+        read_ahead_thread_ = std::thread(&FilePacketizer::readAheadThread, this);
 }
 
 //--------------------------------------------------------------------------------------------------
-std::unique_ptr<FilePacketizer> FilePacketizer::create(const std::filesystem::path& file_path)
+FilePacketizer::~FilePacketizer()
+{
+    stopReadAhead();
+}
+
+//--------------------------------------------------------------------------------------------------
+std::unique_ptr<FilePacketizer> FilePacketizer::create(
+    const std::filesystem::path& file_path, size_t packet_size, size_t read_ahead)
 {
     std::ifstream file_stream;
 
@@ -53,27 +67,47 @@ std::unique_ptr<FilePacketizer> FilePacketizer::create(const std::filesystem::pa
     if (!file_stream.is_open())
         return nullptr;
 
-    return std::unique_ptr<FilePacketizer>(new FilePacketizer(std::move(file_stream)));
+    return std::unique_ptr<FilePacketizer>(
+        new FilePacketizer(std::move(file_stream), packet_size, read_ahead));
 }
 
 //--------------------------------------------------------------------------------------------------
 std::unique_ptr<proto::FilePacket> FilePacketizer::readNextPacket(
     const proto::FilePacketRequest& request)
 {
-    DCHECK(file_stream_.is_open());
-
-    // Create a new file packet.
-    std::unique_ptr<proto::FilePacket> packet = std::make_unique<proto::FilePacket>();
-
     if (request.flags() & proto::FilePacketRequest::CANCEL)
     {
+        stopReadAhead();
+        finished_ = true;
+    }
+
+    if (finished_)
+    {
+        std::unique_ptr<proto::FilePacket> packet = std::make_unique<proto::FilePacket>();
         packet->set_flags(proto::FilePacket::LAST_PACKET);
         return packet;
     }
 
-    size_t packet_buffer_size = kMaxFilePacketSize;
+    std::unique_ptr<proto::FilePacket> packet =
+        read_ahead_ ? takeReadAheadPacket() : readPacket();
 
-    if (left_size_ < kMaxFilePacketSize)
+    if (!packet || (packet->flags() & proto::FilePacket::LAST_PACKET))
+        finished_ = true;
+
+    return packet;
+}
+
+//--------------------------------------------------------------------------------------------------
+std::unique_ptr<proto::FilePacket> FilePacketizer::readPacket()
+{
+    DCHECK(file_stream_.is_open());
+
+    // Create a new file packet.
+    std::unique_ptr<proto::FilePacket> packet = std::make_unique<proto::FilePacket>();
+
+    size_t packet_buffer_size = packet_size_;
+
+    if (left_size_ < packet_size_)
         packet_buffer_size = static_cast<size_t>(left_size_);
 
     char* packet_buffer = outputBuffer(packet.get(), packet_buffer_size);
@@ -109,4 +143,66 @@ std::unique_ptr<proto::FilePacket> FilePacketizer::readNextPacket(
     return packet;
 }
 
+//--------------------------------------------------------------------------------------------------
+std::unique_ptr<proto::FilePacket> FilePacketizer::takeReadAheadPacket()
+{
+    std::unique_lock lock(read_ahead_lock_);
+
+    // The thread always puts the last packet or nullptr (in case of an error) before exiting.
+    read_ahead_event_.wait(lock, [this]() { return !read_ahead_queue_.empty(); });
+
+    std::unique_ptr<proto::FilePacket> packet = std::move(read_ahead_queue_.front());
+    read_ahead_queue_.pop_front();
+
+    read_ahead_event_.notify_all();
+    return packet;
+}
+
+//--------------------------------------------------------------------------------------------------
+void FilePacketizer::stopReadAhead()
+{
+    if (!read_ahead_thread_.joinable())
+        return;
+
+    {
+        std::scoped_lock lock(read_ahead_lock_);
+        read_ahead_stop_ = true;
+    }
+
+    read_ahead_event_.notify_all();
+    read_ahead_thread_.join();
+}
+
+//--------------------------------------------------------------------------------------------------
+void FilePacketizer::readAheadThread()
+{
+    for (;;)
+    {
+        {
+            std::unique_lock lock(read_ahead_lock_);
+
+            read_ahead_event_.wait(lock, [this]()
+            {
+                return read_ahead_stop_ || read_ahead_queue_.size() < read_ahead_;
+            });
+
+            if (read_ahead_stop_)
+                return;
+        }
+
+        std::unique_ptr<proto::FilePacket> packet = readPacket();
+        const bool is_last = !packet || (packet->flags() & proto::FilePacket::LAST_PACKET);
+
+        {
+            std::scoped_lock lock(read_ahead_lock_);
+            read_ahead_queue_.emplace_back(std::move(packet));
+        }
+
+        read_ahead_event_.notify_all();
+
+        if (is_last)
+            return;
+    }
+}
+
 } // namespace common
@@ -20,34 +20,59 @@
 #define COMMON_FILE_PACKETIZER_H
 
 #include "base/macros_magic.h"
+#include "common/file_packet.h"
 #include "proto/file_transfer.pb.h"
 
+#include <condition_variable>
+#include <deque>
 #include <filesystem>
 #include <fstream>
 #include <memory>
+#include <mutex>
+#include <thread>
 
 namespace common {
 
 class FilePacketizer
 {
 public:
-    ~FilePacketizer() = default;
+    ~FilePacketizer();
 
     // Creates an instance of the class.
     // Parameter |file_path| contains the full path to the file.
+    // Parameter |packet_size| contains the size of data in each packet.
+    // If |read_ahead| is not 0, then packets are read in a separate thread and up to |read_ahead|
+    // packets are read in advance.
     // If the specified file can not be opened for reading, then returns nullptr.
-    static std::unique_ptr<FilePacketizer> create(const std::filesystem::path& file_path);
+    static std::unique_ptr<FilePacketizer> create(const std::filesystem::path& file_path,
+                                                  size_t packet_size = kMaxFilePacketSize,
+                                                  size_t read_ahead = 0);
 
     // Creates a packet for transferring.
+    // After the last packet, an empty packet with LAST_PACKET flag is returned for each request.
     std::unique_ptr<proto::FilePacket> readNextPacket(const proto::FilePacketRequest& request);
 
 private:
-    explicit FilePacketizer(std::ifstream&& file_stream);
+    FilePacketizer(std::ifstream&& file_stream, size_t packet_size, size_t read_ahead);
+
+    std::unique_ptr<proto::FilePacket> readPacket();
+    std::unique_ptr<proto::FilePacket> takeReadAheadPacket();
+    void stopReadAhead();
+    void readAheadThread();
 
     std::ifstream file_stream_;
+    const size_t packet_size_;
+    const size_t read_ahead_;
 
     uint64_t file_size_ = 0;
     uint64_t left_size_ = 0;
+    bool finished_ = false;
+
+    std::thread read_ahead_thread_;
+    std::mutex read_ahead_lock_;
+    std::condition_variable read_ahead_event_;
+    std::deque<std::unique_ptr<proto::FilePacket>> read_ahead_queue_;
+    bool read_ahead_stop_ = false;
 
     DISALLOW_COPY_AND_ASSIGN(FilePacketizer);
 };
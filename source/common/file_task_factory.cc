@@ -19,10 +19,22 @@
 #include "common/file_task_factory.h"
 
 #include "base/logging.h"
+#include "common/file_packet.h"
 #include "proto/file_transfer.pb.h"
 
 namespace common {
 
+namespace {
+
+//--------------------------------------------------------------------------------------------------
+void setDefaultWindow(proto::FileTransferWindow* window)
+{
+    window->set_window_size(static_cast<uint32_t>(kDefaultFileWindowSize));
+    window->set_packet_size(static_cast<uint32_t>(kDefaultWindowedFilePacketSize));
+}
+
+} // namespace
+
 //--------------------------------------------------------------------------------------------------
 FileTaskFactory::FileTaskFactory(
     std::shared_ptr<FileTaskProducerProxy> producer_proxy, FileTask::Target target)
@@ -82,15 +94,22 @@ std::shared_ptr<FileTask> FileTaskFactory::remove(const std::string& path)
 }
 
 //--------------------------------------------------------------------------------------------------
-std::shared_ptr<FileTask> FileTaskFactory::download(const std::string& file_path)
+std::shared_ptr<FileTask> FileTaskFactory::download(const std::string& file_path, bool windowed)
 {
     auto request = std::make_unique<proto::FileRequest>();
-    request->mutable_download_request()->set_path(file_path);
+
+    proto::DownloadRequest* download_request = request->mutable_download_request();
+    download_request->set_path(file_path);
+
+    if (windowed)
+        setDefaultWindow(download_request->mutable_window());
+
     return makeTask(std::move(request));
 }
 
 //--------------------------------------------------------------------------------------------------
-std::shared_ptr<FileTask> FileTaskFactory::upload(const std::string& file_path, bool overwrite)
+std::shared_ptr<FileTask> FileTaskFactory::upload(
+    const std::string& file_path, bool overwrite, bool windowed)
 {
     auto request = std::make_unique<proto::FileRequest>();
 
@@ -98,6 +117,9 @@ std::shared_ptr<FileTask> FileTaskFactory::upload(const std::string& file_path,
     upload_request->set_path(file_path);
     upload_request->set_overwrite(overwrite);
 
+    if (windowed)
+        setDefaultWindow(upload_request->mutable_window());
+
     return makeTask(std::move(request));
 }
 
@@ -42,8 +42,10 @@ public:
     std::shared_ptr<FileTask> createDirectory(const std::string& path);
     std::shared_ptr<FileTask> rename(const std::string& old_name, const std::string& new_name);
     std::shared_ptr<FileTask> remove(const std::string& path);
-    std::shared_ptr<FileTask> download(const std::string& file_path);
-    std::shared_ptr<FileTask> upload(const std::string& file_path, bool overwrite);
+    // If |windowed| is true, then the request offers the windowed transfer mode to the peer.
+    std::shared_ptr<FileTask> download(const std::string& file_path, bool windowed = false);
+    std::shared_ptr<FileTask> upload(
+        const std::string& file_path, bool overwrite, bool windowed = false);
     std::shared_ptr<FileTask> packetRequest(uint32_t flags);
     std::shared_ptr<FileTask> packet(const proto::FilePacket& packet);
     std::shared_ptr<FileTask> packet(std::unique_ptr<proto::FilePacket> packet);
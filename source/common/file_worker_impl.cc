@@ -26,13 +26,33 @@
 #include "common/file_packetizer.h"
 #include "common/file_enumerator.h"
 #include "common/file_platform_util.h"
+#include "common/file_packet.h"
 
 #if defined(OS_WIN)
 #include "base/win/drive_enumerator.h"
 #endif // defined(OS_WIN)
 
+#include <algorithm>
+
 namespace common {
 
+namespace {
+
+//--------------------------------------------------------------------------------------------------
+size_t acceptedWindowSize(const proto::FileTransferWindow& window)
+{
+    return std::clamp(static_cast<size_t>(window.window_size()), size_t(1), kMaxFileWindowSize);
+}
+
+//--------------------------------------------------------------------------------------------------
+size_t acceptedPacketSize(const proto::FileTransferWindow& window)
+{
+    return std::clamp(static_cast<size_t>(window.packet_size()),
+                      kMaxFilePacketSize, kMaxWindowedFilePacketSize);
+}
+
+} // namespace
+
 //--------------------------------------------------------------------------------------------------
 FileWorkerImpl::FileWorkerImpl()
 {
@@ -175,6 +195,8 @@ void FileWorkerImpl::doDriveListRequest(proto::FileReply* reply)
 void FileWorkerImpl::doFileListRequest(
     const proto::FileListRequest& request, proto::FileReply* reply)
 {
+    closeDownload();
+
     std::filesystem::path path = base::filePathFromUtf8(request.path());
 
     std::error_code ignored_code;
@@ -237,6 +259,8 @@ void FileWorkerImpl::doCreateDirectoryRequest(
 void FileWorkerImpl::doRenameRequest(
     const proto::RenameRequest& request, proto::FileReply* reply)
 {
+    closeDownload();
+
     std::filesystem::path old_name = base::filePathFromUtf8(request.old_name());
     std::filesystem::path new_name = base::filePathFromUtf8(request.new_name());
 
@@ -286,6 +310,8 @@ void FileWorkerImpl::doRenameRequest(
 void FileWorkerImpl::doRemoveRequest(
     const proto::RemoveRequest& request, proto::FileReply* reply)
 {
+    closeDownload();
+
     std::filesystem::path path = base::filePathFromUtf8(request.path());
 
     std::error_code error_code;
@@ -319,7 +345,29 @@ void FileWorkerImpl::doRemoveRequest(
 void FileWorkerImpl::doDownloadRequest(
     const proto::DownloadRequest& request, proto::FileReply* reply)
 {
-    packetizer_ = FilePacketizer::create(base::filePathFromUtf8(request.path()));
+    std::filesystem::path file_path = base::filePathFromUtf8(request.path());
+
+    closeDownload();
+
+    if (request.has_window())
+    {
+        const size_t packet_size = acceptedPacketSize(request.window());
+        window_size_ = acceptedWindowSize(request.window());
+
+        // Packets that are not requested yet are read in advance.
+        packetizer_ = FilePacketizer::create(file_path, packet_size, window_size_);
+        if (packetizer_)
+        {
+            proto::FileTransferWindow* window = reply->mutable_window();
+            window->set_window_size(static_cast<uint32_t>(window_size_));
+            window->set_packet_size(static_cast<uint32_t>(packet_size));
+        }
+    }
+    else
+    {
+        packetizer_ = FilePacketizer::create(file_path);
+    }
+
     if (!packetizer_)
         reply->set_error_code(proto::FILE_ERROR_FILE_OPEN_ERROR);
     else
@@ -330,6 +378,8 @@ void FileWorkerImpl::doDownloadRequest(
 void FileWorkerImpl::doUploadRequest(
     const proto::UploadRequest& request, proto::FileReply* reply)
 {
+    closeDownload();
+
     std::filesystem::path file_path = base::filePathFromUtf8(request.path());
 
     do
@@ -351,6 +401,14 @@ void FileWorkerImpl::doUploadRequest(
             break;
         }
 
+        if (request.has_window())
+        {
+            // The target accepts packets of any size.
+            proto::FileTransferWindow* window = reply->mutable_window();
+            window->set_window_size(static_cast<uint32_t>(acceptedWindowSize(request.window())));
+            window->set_packet_size(static_cast<uint32_t>(kMaxWindowedFilePacketSize));
+        }
+
         reply->set_error_code(proto::FILE_ERROR_SUCCESS);
     }
     while (false);
@@ -362,6 +420,17 @@ void FileWorkerImpl::doPacketRequest(
 {
     if (!packetizer_)
     {
+        if (trailing_requests_)
+        {
+            // The request was sent before the client received the last packet.
+            --trailing_requests_;
+
+            proto::FilePacket* packet = reply->mutable_packet();
+            packet->set_flags(proto::FilePacket::LAST_PACKET);
+            reply->set_error_code(proto::FILE_ERROR_SUCCESS);
+            return;
+        }
+
         // Set the unknown status of the request. The connection will be closed.
         reply->set_error_code(proto::FILE_ERROR_UNKNOWN);
         LOG(LS_ERROR) << "Unexpected file packet request";
@@ -372,12 +441,18 @@ void FileWorkerImpl::doPacketRequest(
         if (!packet)
         {
             reply->set_error_code(proto::FILE_ERROR_FILE_READ_ERROR);
-            packetizer_.reset();
+            closeDownload();
         }
         else
         {
             if (packet->flags() & proto::FilePacket::LAST_PACKET)
-                packetizer_.reset();
+            {
+                // Release the file right away. In the windowed mode, the remaining requests of the
+                // window are answered without it.
+                size_t trailing_requests = window_size_ ? window_size_ - 1 : 0;
+                closeDownload();
+                trailing_requests_ = trailing_requests;
+            }
 
             reply->set_error_code(proto::FILE_ERROR_SUCCESS);
             reply->set_allocated_packet(packet.release());
@@ -411,4 +486,12 @@ void FileWorkerImpl::doPacket(const proto::FilePacket& packet, proto::FileReply*
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+void FileWorkerImpl::closeDownload()
+{
+    packetizer_.reset();
+    window_size_ = 0;
+    trailing_requests_ = 0;
+}
+
 } // namespace common
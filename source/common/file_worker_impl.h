@@ -45,9 +45,16 @@ private:
     void doUploadRequest(const proto::UploadRequest& request, proto::FileReply* reply);
     void doPacketRequest(const proto::FilePacketRequest& request, proto::FileReply* reply);
     void doPacket(const proto::FilePacket& packet, proto::FileReply* reply);
+    void closeDownload();
 
     std::unique_ptr<FileDepacketizer> depacketizer_;
     std::unique_ptr<FilePacketizer> packetizer_;
+    size_t window_size_ = 0;
+
+    // In the windowed mode, the client can request packets after the last one, up to the window
+    // size minus one. They are answered without the packetizer, so the file is closed as soon as
+    // the last packet is sent.
+    size_t trailing_requests_ = 0;
 
     DISALLOW_COPY_AND_ASSIGN(FileWorkerImpl);
 };
@@ -0,0 +1,156 @@
+//
+// Aspia Project
+// Copyright (C) 2016-2025 Dmitry Chapyshev <dmitry@aspia.ru>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "common/file_worker_impl.h"
+
+#include "base/files/file_path.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <fstream>
+
+namespace common {
+
+namespace {
+
+const size_t kFileSize = kMaxFilePacketSize * 2 + 100;
+const uint32_t kWindowSize = 4;
+
+class FileWorkerImplTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        dir_path_ = std::filesystem::temp_directory_path();
+        dir_path_.append("aspia_common_unittest_" +
+            std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+
+        std::error_code error_code;
+        ASSERT_TRUE(std::filesystem::create_directories(dir_path_, error_code));
+
+        file_path_ = dir_path_;
+        file_path_.append("file.bin");
+
+        std::ofstream file(file_path_, std::ofstream::binary);
+        std::string data(kFileSize, 'a');
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+        ASSERT_TRUE(file.good());
+    }
+
+    void TearDown() override
+    {
+        std::error_code ignored_code;
+        std::filesystem::remove_all(dir_path_, ignored_code);
+    }
+
+    proto::FileReply download()
+    {
+        proto::FileRequest request;
+        proto::DownloadRequest* download_request = request.mutable_download_request();
+        download_request->set_path(base::utf8FromFilePath(file_path_));
+        download_request->mutable_window()->set_window_size(kWindowSize);
+        download_request->mutable_window()->set_packet_size(kMaxFilePacketSize);
+
+        proto::FileReply reply;
+        worker_.doRequest(request, &reply);
+        return reply;
+    }
+
+    proto::FileReply nextPacket()
+    {
+        proto::FileRequest request;
+        request.mutable_packet_request();
+
+        proto::FileReply reply;
+        worker_.doRequest(request, &reply);
+        return reply;
+    }
+
+    proto::FileReply remove()
+    {
+        proto::FileRequest request;
+        request.mutable_remove_request()->set_path(base::utf8FromFilePath(file_path_));
+
+        proto::FileReply reply;
+        worker_.doRequest(request, &reply);
+        return reply;
+    }
+
+    FileWorkerImpl worker_;
+    std::filesystem::path dir_path_;
+    std::filesystem::path file_path_;
+};
+
+} // namespace
+
+TEST_F(FileWorkerImplTest, RemoveAfterWindowedDownload)
+{
+    proto::FileReply reply = download();
+    ASSERT_EQ(reply.error_code(), proto::FILE_ERROR_SUCCESS);
+    ASSERT_EQ(reply.window().window_size(), kWindowSize);
+
+    size_t received = 0;
+    for (;;)
+    {
+        reply = nextPacket();
+        ASSERT_EQ(reply.error_code(), proto::FILE_ERROR_SUCCESS);
+        received += reply.packet().data().size();
+
+        if (reply.packet().flags() & proto::FilePacket::LAST_PACKET)
+            break;
+    }
+
+    EXPECT_EQ(received, kFileSize);
+
+    // The file is closed with the last packet. On Windows an open file cannot be removed.
+    std::error_code error_code;
+    EXPECT_TRUE(std::filesystem::remove(file_path_, error_code));
+
+    // The rest of the window is still answered.
+    for (uint32_t i = 1; i < kWindowSize; ++i)
+    {
+        reply = nextPacket();
+        EXPECT_EQ(reply.error_code(), proto::FILE_ERROR_SUCCESS);
+        EXPECT_TRUE(reply.packet().flags() & proto::FilePacket::LAST_PACKET);
+        EXPECT_TRUE(reply.packet().data().empty());
+    }
+
+    // No more requests are expected.
+    reply = nextPacket();
+    EXPECT_EQ(reply.error_code(), proto::FILE_ERROR_UNKNOWN);
+}
+
+TEST_F(FileWorkerImplTest, RemoveDuringWindowedDownload)
+{
+    ASSERT_EQ(download().error_code(), proto::FILE_ERROR_SUCCESS);
+
+    proto::FileReply reply = nextPacket();
+    ASSERT_EQ(reply.error_code(), proto::FILE_ERROR_SUCCESS);
+    ASSERT_FALSE(reply.packet().flags() & proto::FilePacket::LAST_PACKET);
+
+    // The download is abandoned. The remove request closes the file first.
+    EXPECT_EQ(remove().error_code(), proto::FILE_ERROR_SUCCESS);
+
+    std::error_code ignored_code;
+    EXPECT_FALSE(std::filesystem::exists(file_path_, ignored_code));
+
+    EXPECT_EQ(nextPacket().error_code(), proto::FILE_ERROR_UNKNOWN);
+}
+
+} // namespace common
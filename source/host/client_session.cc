@@ -101,7 +101,18 @@ void ClientSession::start(Delegate* delegate)
     DCHECK(delegate_);
 
     channel_->setListener(this);
-    channel_->setKeepAlive(true);
+
+    if (session_type_ == proto::SESSION_TYPE_DESKTOP_MANAGE ||
+        session_type_ == proto::SESSION_TYPE_DESKTOP_VIEW)
+    {
+        // Desktop sessions use the round-trip times of keep alive packets to control the video
+        // bitrate. We send them as often as allowed.
+        channel_->setKeepAlive(true, std::chrono::seconds(15));
+    }
+    else
+    {
+        channel_->setKeepAlive(true);
+    }
     channel_->resume();
 
     onStarted();
@@ -210,10 +221,9 @@ void ClientSession::onTcpMessageReceived(uint8_t channel_id, const base::ByteArr
 }
 
 //--------------------------------------------------------------------------------------------------
-void ClientSession::onTcpMessageWritten(uint8_t channel_id, base::ByteArray&& buffer, size_t pending)
+void ClientSession::onTcpMessageWritten(
+    uint8_t channel_id, base::ByteArray&& /* buffer */, size_t pending)
 {
-    serializer_.addBuffer(std::move(buffer));
-
     if (channel_id == proto::HOST_CHANNEL_ID_SESSION)
     {
         onWritten(channel_id, pending);
@@ -234,4 +244,10 @@ size_t ClientSession::pendingMessages() const
     return channel_->pendingMessages();
 }
 
+//--------------------------------------------------------------------------------------------------
+const base::BandwidthEstimator& ClientSession::bandwidthEstimator() const
+{
+    return channel_->bandwidthEstimator();
+}
+
 } // namespace host
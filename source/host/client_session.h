@@ -108,6 +108,7 @@ protected:
     void onTcpMessageWritten(uint8_t channel_id, base::ByteArray&& buffer, size_t pending) final;
 
     size_t pendingMessages() const;
+    const base::BandwidthEstimator& bandwidthEstimator() const;
 
     Delegate* delegate_ = nullptr;
 
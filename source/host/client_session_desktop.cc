@@ -23,9 +23,7 @@
 #include "base/power_controller.h"
 #include "base/codec/audio_encoder_opus.h"
 #include "base/codec/cursor_encoder.h"
-#include "base/codec/scale_reducer.h"
 #include "base/codec/video_encoder_vpx.h"
-#include "base/codec/video_encoder_zstd.h"
 #include "base/desktop/frame.h"
 #include "base/desktop/screen_capturer.h"
 #include "common/desktop_session_constants.h"
@@ -88,6 +86,14 @@ void ClientSessionDesktop::setDesktopSessionProxy(
     DCHECK(desktop_session_proxy_);
 }
 
+//--------------------------------------------------------------------------------------------------
+void ClientSessionDesktop::setVideoEncoderPool(
+    base::local_shared_ptr<VideoEncoderPool> video_encoder_pool)
+{
+    video_encoder_pool_ = std::move(video_encoder_pool);
+    DCHECK(video_encoder_pool_);
+}
+
 //--------------------------------------------------------------------------------------------------
 void ClientSessionDesktop::onStarted()
 {
@@ -183,18 +189,18 @@ void ClientSessionDesktop::onReceived(uint8_t /* channel_id */, const base::Byte
             return;
         }
 
-        if (!scale_reducer_)
+        if (scale_x_ <= 0 || scale_y_ <= 0)
         {
-            LOG(LS_ERROR) << "Scale reducer NOT initialized";
+            LOG(LS_ERROR) << "Scale factors NOT initialized";
             return;
         }
 
         const proto::MouseEvent& mouse_event = incoming_message_->mouse_event();
 
         int pos_x = static_cast<int>(
-            static_cast<double>(mouse_event.x() * 100) / scale_reducer_->scaleFactorX());
+            static_cast<double>(mouse_event.x() * 100) / scale_x_);
         int pos_y = static_cast<int>(
-            static_cast<double>(mouse_event.y() * 100) / scale_reducer_->scaleFactorY());
+            static_cast<double>(mouse_event.y() * 100) / scale_y_);
 
         proto::MouseEvent out_mouse_event;
         out_mouse_event.set_mask(mouse_event.mask());
@@ -288,63 +294,106 @@ void ClientSessionDesktop::onTaskManagerMessage(const proto::task_manager::HostT
 #endif // defined(OS_WIN)
 
 //--------------------------------------------------------------------------------------------------
-void ClientSessionDesktop::encodeScreen(const base::Frame* frame, const base::MouseCursor* cursor)
+void ClientSessionDesktop::prepareEncode(const base::Frame* frame)
 {
-    if (critical_overflow_)
+    video_group_id_ = VideoEncoderPool::kInvalidGroupId;
+
+    if (critical_overflow_ || is_video_paused_ || !frame || !video_encoder_pool_)
         return;
 
-    outgoing_message_->Clear();
+    if (video_params_.encoding == proto::VIDEO_ENCODING_UNKNOWN)
+        return;
 
-    if (!is_video_paused_ && frame && video_encoder_)
+    if (source_size_ != frame->size())
     {
-        DCHECK(scale_reducer_);
+        // Every time we change the resolution, we have to reset the preferred size.
+        source_size_ = frame->size();
+        preferred_size_ = base::Size();
+        forced_size_ = base::Size();
+    }
 
-        if (source_size_ != frame->size())
-        {
-            // Every time we change the resolution, we have to reset the preferred size.
-            source_size_ = frame->size();
-            preferred_size_ = base::Size();
-            forced_size_ = base::Size();
-        }
+    if (source_size_.isEmpty())
+    {
+        LOG(LS_ERROR) << "Invalid source frame size: " << source_size_;
+        return;
+    }
 
-        base::Size current_size = preferred_size_;
+    base::Size current_size = preferred_size_;
 
-        // If the preferred size is larger than the original, then we use the original size.
-        if (current_size.width() > source_size_.width() ||
-            current_size.height() > source_size_.height())
-        {
-            current_size = source_size_;
-        }
+    // If the preferred size is larger than the original, then we use the original size.
+    if (current_size.width() > source_size_.width() ||
+        current_size.height() > source_size_.height())
+    {
+        current_size = source_size_;
+    }
 
-        // If we don't have a preferred size, then we use the original frame size.
-        if (current_size.isEmpty())
-            current_size = source_size_;
+    // If we don't have a preferred size, then we use the original frame size.
+    if (current_size.isEmpty())
+        current_size = source_size_;
 
-        if (!forced_size_.isEmpty())
-        {
-            int forced = forced_size_.width() * forced_size_.height();
-            int current = current_size.width() * current_size.height();
+    if (!forced_size_.isEmpty())
+    {
+        int forced = forced_size_.width() * forced_size_.height();
+        int current = current_size.width() * current_size.height();
 
-            if (forced < current)
-                current_size = forced_size_;
-        }
+        if (forced < current)
+            current_size = forced_size_;
+    }
 
-        const base::Frame* scaled_frame = scale_reducer_->scaleFrame(frame, current_size);
-        if (!scaled_frame)
-        {
-            LOG(LS_ERROR) << "No scaled frame";
-            return;
-        }
+    scale_x_ = static_cast<double>(current_size.width() * 100.0) /
+        static_cast<double>(source_size_.width());
+    scale_y_ = static_cast<double>(current_size.height() * 100.0) /
+        static_cast<double>(source_size_.height());
+
+    video_params_.size = current_size;
+
+    video_group_id_ = video_encoder_pool_->join(video_params_);
+    if (video_group_id_ == VideoEncoderPool::kInvalidGroupId)
+        return;
+
+    if (video_group_id_ != last_video_group_id_)
+    {
+        // The encoder of the new group has a state unknown to the client. We need a key frame and
+        // the video format.
+        last_video_group_id_ = video_group_id_;
+        key_frame_required_ = true;
+        format_required_ = true;
+    }
+
+    if (key_frame_required_)
+    {
+        video_encoder_pool_->setKeyFrameRequired(video_group_id_);
+        key_frame_required_ = false;
+    }
+
+    video_encoder_pool_->setTargetBitrate(video_group_id_, video_bitrate_);
+}
 
+//--------------------------------------------------------------------------------------------------
+void ClientSessionDesktop::encodeScreen(const base::Frame* frame, const base::MouseCursor* cursor)
+{
+    VideoEncoderPool::GroupId group_id = VideoEncoderPool::kInvalidGroupId;
+    if (frame)
+        group_id = std::exchange(video_group_id_, VideoEncoderPool::kInvalidGroupId);
+
+    if (critical_overflow_)
+        return;
+
+    outgoing_message_->Clear();
+
+    if (frame && group_id != VideoEncoderPool::kInvalidGroupId)
+    {
         proto::VideoPacket* packet = outgoing_message_->mutable_video_packet();
 
-        // Encode the frame into a video packet.
-        if (!video_encoder_->encode(scaled_frame, packet))
+        // The frame is encoded once for all clients of the group.
+        if (!video_encoder_pool_->encode(group_id, format_required_, packet))
         {
             LOG(LS_ERROR) << "Unable to encode video packet";
             return;
         }
 
+        format_required_ = false;
+
         if (packet->has_format())
         {
             proto::VideoPacketFormat* format = packet->mutable_format();
@@ -379,8 +428,8 @@ void ClientSessionDesktop::encodeScreen(const base::Frame* frame, const base::Mo
 
         if (outgoing_message_->has_video_packet())
         {
-            video_encoder_->setEncodeBuffer(
-                std::move(*outgoing_message_->mutable_video_packet()->mutable_data()));
+            video_encoder_pool_->setEncodeBuffer(
+                group_id, std::move(*outgoing_message_->mutable_video_packet()->mutable_data()));
             stat_counter_.addVideoPacket();
         }
     }
@@ -430,9 +479,9 @@ void ClientSessionDesktop::setCursorPosition(const proto::CursorPosition& cursor
     outgoing_message_->Clear();
 
     int pos_x = static_cast<int>(
-        static_cast<double>(cursor_position.x()) * scale_reducer_->scaleFactorX() / 100.0);
+        static_cast<double>(cursor_position.x()) * scale_x_ / 100.0);
     int pos_y = static_cast<int>(
-        static_cast<double>(cursor_position.y()) * scale_reducer_->scaleFactorY() / 100.0);
+        static_cast<double>(cursor_position.y()) * scale_y_ / 100.0);
 
     proto::CursorPosition* position = outgoing_message_->mutable_cursor_position();
     position->set_x(pos_x);
@@ -532,33 +581,24 @@ void ClientSessionDesktop::readExtension(const proto::DesktopExtension& extensio
 //--------------------------------------------------------------------------------------------------
 void ClientSessionDesktop::readConfig(const proto::DesktopConfig& config)
 {
-    switch (config.video_encoding())
+    if (!VideoEncoderPool::isSupportedEncoding(config.video_encoding()))
     {
-        case proto::VIDEO_ENCODING_VP8:
-            video_encoder_ = base::VideoEncoderVPX::createVP8();
-            break;
-
-        case proto::VIDEO_ENCODING_VP9:
-            video_encoder_ = base::VideoEncoderVPX::createVP9();
-            break;
-
-        case proto::VIDEO_ENCODING_ZSTD:
-            video_encoder_ = base::VideoEncoderZstd::create(
-                parsePixelFormat(config.pixel_format()), static_cast<int>(config.compress_ratio()));
-            break;
-
-        default:
-        {
-            // No supported video encoding.
-            LOG(LS_ERROR) << "Unsupported video encoding: " << config.video_encoding();
-        }
-        break;
+        // No supported video encoding.
+        LOG(LS_ERROR) << "Unsupported video encoding: " << config.video_encoding();
+        return;
     }
 
-    if (!video_encoder_)
+    video_params_ = VideoEncoderPool::Params();
+    video_params_.encoding = config.video_encoding();
+
+    // Pixel format and compression ratio only apply to Zstd. Leaving them at defaults for VPX lets
+    // clients with different unused settings share the same encoder.
+    if (config.video_encoding() == proto::VIDEO_ENCODING_ZSTD)
     {
-        LOG(LS_ERROR) << "Video encoder not initialized!";
-        return;
+        video_params_.pixel_format = parsePixelFormat(config.pixel_format());
+        video_params_.compress_ratio = static_cast<int>(config.compress_ratio());
+        video_params_.zstd_reference =
+            (config.video_features() & proto::VIDEO_FEATURE_ZSTD_REFERENCE);
     }
 
     switch (config.audio_encoding())
@@ -582,8 +622,6 @@ void ClientSessionDesktop::readConfig(const proto::DesktopConfig& config)
         cursor_encoder_ = std::make_unique<base::CursorEncoder>();
     }
 
-    scale_reducer_ = std::make_unique<base::ScaleReducer>();
-
     desktop_session_config_.disable_font_smoothing =
         (config.flags() & proto::DISABLE_FONT_SMOOTHING);
     desktop_session_config_.disable_effects =
@@ -601,6 +639,7 @@ void ClientSessionDesktop::readConfig(const proto::DesktopConfig& config)
 
     LOG(LS_INFO) << "Client configuration changed";
     LOG(LS_INFO) << "Video encoding: " << config.video_encoding();
+    LOG(LS_INFO) << "Video features: " << config.video_features();
     LOG(LS_INFO) << "Enable cursor shape: " << (cursor_encoder_ != nullptr);
     LOG(LS_INFO) << "Disable font smoothing: " << desktop_session_config_.disable_font_smoothing;
     LOG(LS_INFO) << "Disable desktop effects: " << desktop_session_config_.disable_effects;
@@ -674,13 +713,13 @@ void ClientSessionDesktop::readVideoPauseExtension(const std::string& data)
 
     if (!is_video_paused_)
     {
-        if (!video_encoder_)
+        if (video_params_.encoding == proto::VIDEO_ENCODING_UNKNOWN)
         {
             LOG(LS_ERROR) << "Video encoder not initialized";
             return;
         }
 
-        video_encoder_->setKeyFrameRequired(true);
+        key_frame_required_ = true;
     }
 }
 
@@ -853,7 +892,17 @@ void ClientSessionDesktop::readVideoRecordingExtension(const std::string& data)
     switch (video_recording.action())
     {
         case proto::VideoRecording::ACTION_STARTED:
+        {
             started = true;
+
+            // The client writes the received packets to the file. The file must start with a key
+            // frame and the video format.
+            if (video_params_.encoding != proto::VIDEO_ENCODING_UNKNOWN)
+            {
+                key_frame_required_ = true;
+                format_required_ = true;
+            }
+        }
         break;
 
         case proto::VideoRecording::ACTION_STOPPED:
@@ -897,6 +946,9 @@ void ClientSessionDesktop::onOverflowDetectionTimer()
     static const size_t kWarningPendingCount = 2;
 
     size_t pending = pendingMessages();
+
+    updateVideoBitrate(pending > kWarningPendingCount, pending == 0);
+
     if (pending > kCriticalPendingCount)
     {
         critical_overflow_ = true;
@@ -914,15 +966,19 @@ void ClientSessionDesktop::onOverflowDetectionTimer()
 
         LOG(LS_INFO) << "Overflow: " << pending << " (" << write_overflow_count_ << ")";
 
-        if (pending > last_pending_count_ || write_overflow_count_ > 10)
+        // The bitrate is lowered first. The frame rate is lowered when the bitrate can not be
+        // lowered any more.
+        if ((pending > last_pending_count_ || write_overflow_count_ > 10) &&
+            !isVideoBitrateAdjustable())
+        {
             downStepOverflow();
+        }
     }
     else if (write_overflow_count_ > 0 && pending == 0)
     {
         if (critical_overflow_)
         {
-            if (video_encoder_)
-                video_encoder_->setKeyFrameRequired(true);
+            key_frame_required_ = true;
         }
 
         critical_overflow_ = false;
@@ -954,6 +1010,71 @@ void ClientSessionDesktop::onOverflowDetectionTimer()
     last_pending_count_ = pending;
 }
 
+//--------------------------------------------------------------------------------------------------
+void ClientSessionDesktop::updateVideoBitrate(bool overflow, bool idle)
+{
+    // Part of the measured bandwidth that is given to the video. The rest is left for audio, cursor
+    // and other channels.
+    static const int64_t kVideoBandwidthPercent = 80;
+
+    // Bandwidth samples older than this are not used.
+    static const std::chrono::seconds kMaxSampleAge { 10 };
+
+    const base::BandwidthEstimator& estimator = bandwidthEstimator();
+
+    uint32_t estimated_bitrate = 0;
+    if (estimator.bandwidth() &&
+        base::BandwidthEstimator::Clock::now() - estimator.lastSampleTime() < kMaxSampleAge)
+    {
+        int64_t kbps = estimator.bandwidth() * 8 / 1000 * kVideoBandwidthPercent / 100;
+        estimated_bitrate = static_cast<uint32_t>(
+            std::min(kbps, static_cast<int64_t>(base::VideoEncoderVPX::kMaxTargetBitrate)));
+    }
+
+    uint32_t bitrate = video_bitrate_;
+
+    if (overflow || estimator.isQueueing())
+    {
+        // The network does not keep up with us. Lower the bitrate to the video part (80%) of the
+        // measured bandwidth or by 30% if there is no measurement. It is never raised here.
+        if (estimated_bitrate)
+            bitrate = std::min(estimated_bitrate, bitrate);
+        else
+            bitrate = bitrate * 70 / 100;
+    }
+    else if (idle)
+    {
+        // Everything is sent. The link may be able to carry more: probe the bandwidth by 10% per
+        // second, or jump straight to the measured value.
+        bitrate = std::max(bitrate * 110 / 100, estimated_bitrate);
+    }
+
+    bitrate = std::clamp(bitrate,
+                         base::VideoEncoderVPX::kMinTargetBitrate,
+                         base::VideoEncoderVPX::kMaxTargetBitrate);
+
+    if (bitrate != video_bitrate_)
+    {
+        DLOG(LS_INFO) << "Video bitrate: " << video_bitrate_ << " to " << bitrate << " kbps"
+                      << " (estimated: " << estimated_bitrate << " kbps, RTT: "
+                      << estimator.rtt().count() << " us, min RTT: "
+                      << estimator.minRtt().count() << " us)";
+        video_bitrate_ = bitrate;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+bool ClientSessionDesktop::isVideoBitrateAdjustable() const
+{
+    if (video_params_.encoding != proto::VIDEO_ENCODING_VP8 &&
+        video_params_.encoding != proto::VIDEO_ENCODING_VP9)
+    {
+        return false;
+    }
+
+    return video_bitrate_ > base::VideoEncoderVPX::kMinTargetBitrate;
+}
+
 //--------------------------------------------------------------------------------------------------
 void ClientSessionDesktop::downStepOverflow()
 {
@@ -27,6 +27,7 @@
 #include "host/client_session.h"
 #include "host/desktop_session.h"
 #include "host/stat_counter.h"
+#include "host/video_encoder_pool.h"
 
 #if defined(OS_WIN)
 #include "host/task_manager.h"
@@ -37,8 +38,6 @@ class AudioEncoder;
 class CursorEncoder;
 class Frame;
 class MouseCursor;
-class ScaleReducer;
-class VideoEncoder;
 } // namespace base
 
 namespace host {
@@ -58,7 +57,11 @@ public:
     ~ClientSessionDesktop() final;
 
     void setDesktopSessionProxy(base::local_shared_ptr<DesktopSessionProxy> desktop_session_proxy);
+    void setVideoEncoderPool(base::local_shared_ptr<VideoEncoderPool> video_encoder_pool);
 
+    // Joins the group of the video encoder pool for the frame. Must be called for all clients
+    // before encodeScreen() is called for any of them.
+    void prepareEncode(const base::Frame* frame);
     void encodeScreen(const base::Frame* frame, const base::MouseCursor* cursor);
     void encodeAudio(const proto::AudioPacket& audio_packet);
     void setVideoErrorCode(proto::VideoErrorCode error_code);
@@ -93,12 +96,20 @@ private:
     void readVideoRecordingExtension(const std::string& data);
     void readTaskManagerExtension(const std::string& data);
     void onOverflowDetectionTimer();
+    void updateVideoBitrate(bool overflow, bool idle);
+    bool isVideoBitrateAdjustable() const;
     void downStepOverflow();
     void upStepOverflow();
 
     base::local_shared_ptr<DesktopSessionProxy> desktop_session_proxy_;
-    std::unique_ptr<base::ScaleReducer> scale_reducer_;
-    std::unique_ptr<base::VideoEncoder> video_encoder_;
+    base::local_shared_ptr<VideoEncoderPool> video_encoder_pool_;
+    VideoEncoderPool::Params video_params_;
+    VideoEncoderPool::GroupId video_group_id_ = VideoEncoderPool::kInvalidGroupId;
+    VideoEncoderPool::GroupId last_video_group_id_ = VideoEncoderPool::kInvalidGroupId;
+    bool key_frame_required_ = false;
+    bool format_required_ = false;
+    double scale_x_ = 0;
+    double scale_y_ = 0;
     std::unique_ptr<base::CursorEncoder> cursor_encoder_;
     std::unique_ptr<base::AudioEncoder> audio_encoder_;
     DesktopSession::Config desktop_session_config_;
@@ -115,6 +126,9 @@ private:
     bool critical_overflow_ = false;
     int max_fps_ = 0;
 
+    // Target bitrate of the video in kilobits per second.
+    uint32_t video_bitrate_ = 1000;
+
 #if defined(OS_WIN)
     std::unique_ptr<TaskManager> task_manager_;
 #endif // defined(OS_WIN)
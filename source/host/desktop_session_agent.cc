@@ -43,6 +43,10 @@ namespace host {
 
 namespace {
 
+// Audio packets, cursor shapes and clipboard data are sent to the service through a shared memory
+// ring of this capacity.
+const size_t kIpcRingCapacity = 4 * 1024 * 1024; // 4MB
+
 //--------------------------------------------------------------------------------------------------
 const char* controlActionToString(proto::internal::DesktopControl::Action action)
 {
@@ -121,6 +125,11 @@ void DesktopSessionAgent::start(std::u16string_view channel_id)
         return;
     }
 
+    // The ring is created only by the agent. The service is able to open it for any user of the
+    // agent. If the ring is not created, then all messages are sent through the channel.
+    if (!channel_->enableSharedMemoryRing(kIpcRingCapacity))
+        LOG(LS_ERROR) << "Unable to enable shared memory ring for IPC channel";
+
     channel_->setListener(this);
     channel_->resume();
 }
@@ -307,9 +316,9 @@ void DesktopSessionAgent::onIpcMessageReceived(const base::ByteArray& buffer)
 }
 
 //--------------------------------------------------------------------------------------------------
-void DesktopSessionAgent::onIpcMessageWritten(base::ByteArray&& buffer)
+void DesktopSessionAgent::onIpcMessageWritten(base::ByteArray&& /* buffer */)
 {
-    serializer_.addBuffer(std::move(buffer));
+    // Nothing
 }
 
 //--------------------------------------------------------------------------------------------------
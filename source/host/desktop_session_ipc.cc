@@ -325,9 +325,9 @@ void DesktopSessionIpc::onIpcMessageReceived(const base::ByteArray& buffer)
 }
 
 //--------------------------------------------------------------------------------------------------
-void DesktopSessionIpc::onIpcMessageWritten(base::ByteArray&& buffer)
+void DesktopSessionIpc::onIpcMessageWritten(base::ByteArray&& /* buffer */)
 {
-    serializer_.addBuffer(std::move(buffer));
+    // Nothing
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -77,9 +77,9 @@ void FileTransferAgent::onIpcMessageReceived(const base::ByteArray& buffer)
 }
 
 //--------------------------------------------------------------------------------------------------
-void FileTransferAgent::onIpcMessageWritten(base::ByteArray&& buffer)
+void FileTransferAgent::onIpcMessageWritten(base::ByteArray&& /* buffer */)
 {
-    serializer_.addBuffer(std::move(buffer));
+    // Nothing
 }
 
 } // namespace host
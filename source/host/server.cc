@@ -21,6 +21,7 @@
 #include "base/logging.h"
 #include "base/task_runner.h"
 #include "base/waitable_timer.h"
+#include "base/crypto/crypto_worker_pool.h"
 #include "base/crypto/random.h"
 #include "base/files/base_paths.h"
 #include "base/files/file_path_watcher.h"
@@ -209,8 +210,20 @@ void Server::onNewSession(base::ServerAuthenticatorManager::SessionInfo&& sessio
                       << " client: " << session_info.version.toString() << ")";
     }
 
+    proto::SessionType session_type = static_cast<proto::SessionType>(session_info.session_type);
+    if (session_type == proto::SESSION_TYPE_DESKTOP_MANAGE ||
+        session_type == proto::SESSION_TYPE_DESKTOP_VIEW ||
+        session_type == proto::SESSION_TYPE_FILE_TRANSFER)
+    {
+        // The pool is shared by all sessions and created with the first one that uses it.
+        if (!crypto_worker_pool_)
+            crypto_worker_pool_ = std::make_shared<base::CryptoWorkerPool>();
+
+        session_info.channel->setWorkerPool(crypto_worker_pool_);
+    }
+
     std::unique_ptr<ClientSession> session = ClientSession::create(
-        static_cast<proto::SessionType>(session_info.session_type),
+        session_type,
         std::move(session_info.channel),
         task_runner_);
 
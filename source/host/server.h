@@ -29,6 +29,7 @@
 #include "host/system_settings.h"
 
 namespace base {
+class CryptoWorkerPool;
 class FilePathWatcher;
 class TaskRunner;
 class WaitableTimer;
@@ -99,6 +100,10 @@ private:
     std::unique_ptr<base::ServerAuthenticatorManager> authenticator_manager_;
     std::unique_ptr<UserSessionManager> user_session_manager_;
 
+    // Encrypts and decrypts large messages (video key frames, file chunks) of the desktop and file
+    // transfer sessions.
+    std::shared_ptr<base::CryptoWorkerPool> crypto_worker_pool_;
+
     std::unique_ptr<common::UpdateChecker> update_checker_;
     std::unique_ptr<common::HttpFileDownloader> update_downloader_;
 
@@ -74,6 +74,9 @@ UserSession::UserSession(std::shared_ptr<base::TaskRunner> task_runner,
       desktop_dettach_timer_(base::WaitableTimer::Type::SINGLE_SHOT, task_runner),
       session_id_(session_id),
       password_expire_timer_(base::WaitableTimer::Type::SINGLE_SHOT, task_runner),
+      video_encoder_pool_(base::make_local_shared<VideoEncoderPool>()),
+      video_encode_worker_(
+          std::make_unique<VideoEncodeWorker>(task_runner, video_encoder_pool_, this)),
       delegate_(delegate)
 {
     type_ = UserSession::Type::CONSOLE;
@@ -794,9 +797,9 @@ void UserSession::onIpcMessageReceived(const base::ByteArray& buffer)
 }
 
 //--------------------------------------------------------------------------------------------------
-void UserSession::onIpcMessageWritten(base::ByteArray&& buffer)
+void UserSession::onIpcMessageWritten(base::ByteArray&& /* buffer */)
 {
-    serializer_.addBuffer(std::move(buffer));
+    // Nothing
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -840,8 +843,15 @@ void UserSession::onDesktopSessionStopped()
 //--------------------------------------------------------------------------------------------------
 void UserSession::onScreenCaptured(const base::Frame* frame, const base::MouseCursor* cursor)
 {
-    for (const auto& client : desktop_clients_)
-        static_cast<ClientSessionDesktop*>(client.get())->encodeScreen(frame, cursor);
+    // The cursor is cheap to encode and is sent without waiting for the video encoder.
+    if (cursor)
+    {
+        for (const auto& client : desktop_clients_)
+            static_cast<ClientSessionDesktop*>(client.get())->encodeScreen(nullptr, cursor);
+    }
+
+    if (frame)
+        video_encode_worker_->encodeFrame(frame);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1052,6 +1062,22 @@ void UserSession::onClientSessionTextChat(uint32_t id, const proto::TextChat& te
 
 }
 
+//--------------------------------------------------------------------------------------------------
+void UserSession::onBeforeVideoEncode(const base::Frame* frame)
+{
+    // All clients join their encoder groups before the frame is encoded, so a key frame request
+    // from any member applies to the packet of the whole group.
+    for (const auto& client : desktop_clients_)
+        static_cast<ClientSessionDesktop*>(client.get())->prepareEncode(frame);
+}
+
+//--------------------------------------------------------------------------------------------------
+void UserSession::onAfterVideoEncode(const base::Frame* frame)
+{
+    for (const auto& client : desktop_clients_)
+        static_cast<ClientSessionDesktop*>(client.get())->encodeScreen(frame, nullptr);
+}
+
 //--------------------------------------------------------------------------------------------------
 void UserSession::onSessionDettached(const base::Location& location)
 {
@@ -1336,6 +1362,7 @@ void UserSession::addNewClientSession(std::unique_ptr<ClientSession> client_sess
                 static_cast<ClientSessionDesktop*>(client_session_ptr);
 
             desktop_client_session->setDesktopSessionProxy(desktop_session_proxy_);
+            desktop_client_session->setVideoEncoderPool(video_encoder_pool_);
 
             if (enable_required)
             {
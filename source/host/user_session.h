@@ -31,6 +31,8 @@
 #include "host/desktop_session_manager.h"
 #include "host/system_settings.h"
 #include "host/unconfirmed_client_session.h"
+#include "host/video_encode_worker.h"
+#include "host/video_encoder_pool.h"
 #include "proto/host_internal.pb.h"
 
 namespace base {
@@ -43,7 +45,8 @@ class UserSession final
     : public base::IpcChannel::Listener,
       public DesktopSession::Delegate,
       public UnconfirmedClientSession::Delegate,
-      public ClientSession::Delegate
+      public ClientSession::Delegate,
+      public VideoEncodeWorker::Delegate
 {
 public:
     enum class Type
@@ -125,6 +128,10 @@ protected:
         const std::string& computer_name, const std::string& user_name, bool started) final;
     void onClientSessionTextChat(uint32_t id, const proto::TextChat& text_chat) final;
 
+    // VideoEncodeWorker::Delegate implementation.
+    void onBeforeVideoEncode(const base::Frame* frame) final;
+    void onAfterVideoEncode(const base::Frame* frame) final;
+
 private:
     void onSessionDettached(const base::Location& location);
     void sendConnectEvent(const ClientSession& client_session);
@@ -180,6 +187,8 @@ private:
 
     std::unique_ptr<DesktopSessionManager> desktop_session_;
     base::local_shared_ptr<DesktopSessionProxy> desktop_session_proxy_;
+    base::local_shared_ptr<VideoEncoderPool> video_encoder_pool_;
+    std::unique_ptr<VideoEncodeWorker> video_encode_worker_;
 
     Delegate* delegate_ = nullptr;
 
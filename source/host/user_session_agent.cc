@@ -159,9 +159,9 @@ void UserSessionAgent::onIpcMessageReceived(const base::ByteArray& buffer)
 }
 
 //--------------------------------------------------------------------------------------------------
-void UserSessionAgent::onIpcMessageWritten(base::ByteArray&& buffer)
+void UserSessionAgent::onIpcMessageWritten(base::ByteArray&& /* buffer */)
 {
-    serializer_.addBuffer(std::move(buffer));
+    // Nothing
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -0,0 +1,170 @@
+//
+// Aspia Project
+// Copyright (C) 2016-2025 Dmitry Chapyshev <dmitry@aspia.ru>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "host/video_encode_worker.h"
+
+#include "base/logging.h"
+#include "base/task_runner.h"
+#include "base/desktop/frame_simple.h"
+#include "host/video_encoder_pool.h"
+
+namespace host {
+
+//--------------------------------------------------------------------------------------------------
+VideoEncodeWorker::VideoEncodeWorker(std::shared_ptr<base::TaskRunner> task_runner,
+                                     base::local_shared_ptr<VideoEncoderPool> pool,
+                                     Delegate* delegate)
+    : task_runner_(std::move(task_runner)),
+      pool_(std::move(pool)),
+      delegate_(delegate),
+      alive_(std::make_shared<bool>(true))
+{
+    LOG(LS_INFO) << "Ctor";
+
+    DCHECK(task_runner_);
+    DCHECK(pool_);
+    DCHECK(delegate_);
+
+    thread_.start(base::MessageLoop::Type::DEFAULT);
+}
+
+//--------------------------------------------------------------------------------------------------
+VideoEncodeWorker::~VideoEncodeWorker()
+{
+    LOG(LS_INFO) << "Dtor";
+    DCHECK(task_runner_->belongsToCurrentThread());
+
+    *alive_ = false;
+    thread_.stop();
+
+    // The pool may still contain the frame that was being encoded.
+    if (is_encoding_)
+        pool_->endFrame();
+}
+
+//--------------------------------------------------------------------------------------------------
+void VideoEncodeWorker::encodeFrame(const base::Frame* frame)
+{
+    DCHECK(task_runner_->belongsToCurrentThread());
+    DCHECK(frame);
+
+    if (frame->constUpdatedRegion().isEmpty())
+        return;
+
+    if (is_encoding_)
+    {
+        // The encoder is busy. Merge the frame into the pending frame.
+        copyFrame(*frame, &pending_frame_);
+        return;
+    }
+
+    if (frame_)
+        frame_->updatedRegion()->clear();
+
+    if (!copyFrame(*frame, &frame_))
+        return;
+
+    startEncoding();
+}
+
+//--------------------------------------------------------------------------------------------------
+void VideoEncodeWorker::startEncoding()
+{
+    DCHECK(!is_encoding_);
+    DCHECK(frame_);
+
+    is_encoding_ = true;
+
+    pool_->beginFrame(frame_.get());
+    delegate_->onBeforeVideoEncode(frame_.get());
+
+    // While the frame is being encoded, the pool and the frame are used only by the worker thread.
+    thread_.taskRunner()->postTask(
+        [pool = pool_.get(), task_runner = task_runner_, alive = alive_, this]()
+    {
+        pool->encodeFrame();
+
+        task_runner->postTask([alive, this]()
+        {
+            if (*alive)
+                onEncodingFinished();
+        });
+    });
+}
+
+//--------------------------------------------------------------------------------------------------
+void VideoEncodeWorker::onEncodingFinished()
+{
+    DCHECK(task_runner_->belongsToCurrentThread());
+    DCHECK(is_encoding_);
+
+    delegate_->onAfterVideoEncode(frame_.get());
+    pool_->endFrame();
+
+    is_encoding_ = false;
+
+    if (!pending_frame_ || pending_frame_->constUpdatedRegion().isEmpty())
+        return;
+
+    frame_->updatedRegion()->clear();
+
+    bool copied = copyFrame(*pending_frame_, &frame_);
+    pending_frame_->updatedRegion()->clear();
+
+    if (copied)
+        startEncoding();
+}
+
+//--------------------------------------------------------------------------------------------------
+// static
+bool VideoEncodeWorker::copyFrame(const base::Frame& source, std::unique_ptr<base::Frame>* target)
+{
+    const base::Size& size = source.size();
+
+    if (!*target || (*target)->size() != size || (*target)->format() != source.format())
+    {
+        // The size has changed. Only the whole frame can be copied.
+        *target = base::FrameSimple::create(size, source.format());
+        if (!*target)
+        {
+            LOG(LS_ERROR) << "Unable to create frame: " << size;
+            return false;
+        }
+
+        const base::Rect frame_rect = base::Rect::makeSize(size);
+
+        (*target)->copyPixelsFrom(source, base::Point(0, 0), frame_rect);
+        (*target)->updatedRegion()->addRect(frame_rect);
+    }
+    else
+    {
+        const base::Region& source_region = source.constUpdatedRegion();
+
+        for (base::Region::Iterator it(source_region); !it.isAtEnd(); it.advance())
+            (*target)->copyPixelsFrom(source, it.rect().topLeft(), it.rect());
+
+        (*target)->updatedRegion()->addRegion(source_region);
+    }
+
+    (*target)->setTopLeft(source.topLeft());
+    (*target)->setDpi(source.dpi());
+    (*target)->setCapturerType(source.capturerType());
+    return true;
+}
+
+} // namespace host
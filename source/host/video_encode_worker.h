@@ -0,0 +1,96 @@
+//
+// Aspia Project
+// Copyright (C) 2016-2025 Dmitry Chapyshev <dmitry@aspia.ru>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef HOST_VIDEO_ENCODE_WORKER_H
+#define HOST_VIDEO_ENCODE_WORKER_H
+
+#include "base/macros_magic.h"
+#include "base/memory/local_memory.h"
+#include "base/threading/thread.h"
+
+#include <memory>
+
+namespace base {
+class Frame;
+class TaskRunner;
+} // namespace base
+
+namespace host {
+
+class VideoEncoderPool;
+
+// Runs the video encoders of VideoEncoderPool on a dedicated thread, so that scaling and encoding
+// do not block the network thread. Only one frame is encoded at a time. Frames captured while the
+// encoder is busy are merged into a single pending frame: their updated pixels are copied and
+// their updated regions are united.
+class VideoEncodeWorker
+{
+public:
+    class Delegate
+    {
+    public:
+        virtual ~Delegate() = default;
+
+        // Called on the owner thread before the frame is encoded. Clients join the groups of
+        // the pool here.
+        virtual void onBeforeVideoEncode(const base::Frame* frame) = 0;
+
+        // Called on the owner thread when all groups have been encoded. Clients take their packets
+        // from the pool here.
+        virtual void onAfterVideoEncode(const base::Frame* frame) = 0;
+    };
+
+    VideoEncodeWorker(std::shared_ptr<base::TaskRunner> task_runner,
+                      base::local_shared_ptr<VideoEncoderPool> pool,
+                      Delegate* delegate);
+    ~VideoEncodeWorker();
+
+    // Queues the frame for encoding. The frame is copied, so it may be reused after the call.
+    void encodeFrame(const base::Frame* frame);
+
+    bool isEncoding() const { return is_encoding_; }
+
+private:
+    void startEncoding();
+    void onEncodingFinished();
+
+    static bool copyFrame(const base::Frame& source, std::unique_ptr<base::Frame>* target);
+
+    std::shared_ptr<base::TaskRunner> task_runner_;
+    base::local_shared_ptr<VideoEncoderPool> pool_;
+    Delegate* delegate_;
+
+    base::Thread thread_;
+
+    // Cleared in the destructor. Finished encodings posted after that are ignored.
+    std::shared_ptr<bool> alive_;
+
+    // Frame being encoded. Holds a full copy of the screen.
+    std::unique_ptr<base::Frame> frame_;
+
+    // Merged frame waiting for encoding. Only the pixels in its updated region are valid.
+    std::unique_ptr<base::Frame> pending_frame_;
+
+    bool is_encoding_ = false;
+
+    DISALLOW_COPY_AND_ASSIGN(VideoEncodeWorker);
+};
+
+} // namespace host
+
+#endif // HOST_VIDEO_ENCODE_WORKER_H
@@ -0,0 +1,354 @@
+//
+// Aspia Project
+// Copyright (C) 2016-2025 Dmitry Chapyshev <dmitry@aspia.ru>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "host/video_encoder_pool.h"
+
+#include "base/logging.h"
+#include "base/codec/scale_reducer.h"
+#include "base/codec/video_encoder_vpx.h"
+#include "base/codec/video_encoder_zstd.h"
+#include "base/desktop/frame.h"
+
+#include <algorithm>
+
+namespace host {
+
+namespace {
+
+//--------------------------------------------------------------------------------------------------
+std::unique_ptr<base::VideoEncoder> createEncoder(const VideoEncoderPool::Params& params)
+{
+    switch (params.encoding)
+    {
+        case proto::VIDEO_ENCODING_VP8:
+            return base::VideoEncoderVPX::createVP8();
+
+        case proto::VIDEO_ENCODING_VP9:
+            return base::VideoEncoderVPX::createVP9();
+
+        case proto::VIDEO_ENCODING_ZSTD:
+        {
+            std::unique_ptr<base::VideoEncoderZstd> encoder =
+                base::VideoEncoderZstd::create(params.pixel_format, params.compress_ratio);
+            if (encoder)
+                encoder->setReferenceEnabled(params.zstd_reference);
+            return encoder;
+        }
+
+        default:
+            LOG(LS_ERROR) << "Unsupported video encoding: " << params.encoding;
+            return nullptr;
+    }
+}
+
+} // namespace
+
+struct VideoEncoderPool::Group
+{
+    GroupId id = kInvalidGroupId;
+    Params params;
+
+    std::unique_ptr<base::ScaleReducer> scale_reducer;
+    std::unique_ptr<base::VideoEncoder> encoder;
+
+    // Packet for the current frame and the last video format sent by the encoder.
+    proto::VideoPacket packet;
+    proto::VideoPacketFormat format;
+    bool has_format = false;
+
+    bool is_encoded = false;
+    bool is_failed = false;
+
+    // Lowest target bitrate requested by the members for the current frame (0 if none).
+    uint32_t target_bitrate = 0;
+
+    // Number of members in the current frame and number of members which received the packet.
+    size_t members = 0;
+    size_t delivered = 0;
+};
+
+//--------------------------------------------------------------------------------------------------
+bool VideoEncoderPool::Params::operator==(const Params& other) const
+{
+    return encoding == other.encoding &&
+           pixel_format == other.pixel_format &&
+           compress_ratio == other.compress_ratio &&
+           zstd_reference == other.zstd_reference &&
+           size == other.size;
+}
+
+//--------------------------------------------------------------------------------------------------
+VideoEncoderPool::VideoEncoderPool()
+{
+    LOG(LS_INFO) << "Ctor";
+}
+
+//--------------------------------------------------------------------------------------------------
+VideoEncoderPool::~VideoEncoderPool()
+{
+    LOG(LS_INFO) << "Dtor";
+}
+
+//--------------------------------------------------------------------------------------------------
+// static
+bool VideoEncoderPool::isSupportedEncoding(proto::VideoEncoding encoding)
+{
+    return encoding == proto::VIDEO_ENCODING_VP8 ||
+           encoding == proto::VIDEO_ENCODING_VP9 ||
+           encoding == proto::VIDEO_ENCODING_ZSTD;
+}
+
+//--------------------------------------------------------------------------------------------------
+void VideoEncoderPool::beginFrame(const base::Frame* frame)
+{
+    DCHECK(frame);
+    DCHECK(!frame_);
+
+    frame_ = frame;
+
+    for (const auto& group : groups_)
+    {
+        group->packet.Clear();
+        group->is_encoded = false;
+        group->is_failed = false;
+        group->target_bitrate = 0;
+        group->members = 0;
+        group->delivered = 0;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+VideoEncoderPool::GroupId VideoEncoderPool::join(const Params& params)
+{
+    DCHECK(frame_);
+
+    for (const auto& group : groups_)
+    {
+        if (group->params == params)
+        {
+            DCHECK(!group->is_encoded);
+            ++group->members;
+            return group->id;
+        }
+    }
+
+    std::unique_ptr<base::VideoEncoder> encoder = createEncoder(params);
+    if (!encoder)
+        return kInvalidGroupId;
+
+    std::unique_ptr<Group> group = std::make_unique<Group>();
+    group->id = ++last_group_id_;
+    group->params = params;
+    group->scale_reducer = std::make_unique<base::ScaleReducer>();
+    group->encoder = std::move(encoder);
+    group->members = 1;
+
+    LOG(LS_INFO) << "Video encoder group " << group->id << " created (encoding: "
+                 << params.encoding << ", size: " << params.size << ", groups: "
+                 << groups_.size() + 1 << ")";
+
+    GroupId group_id = group->id;
+    groups_.emplace_back(std::move(group));
+    return group_id;
+}
+
+//--------------------------------------------------------------------------------------------------
+void VideoEncoderPool::setKeyFrameRequired(GroupId group_id)
+{
+    Group* group = groupById(group_id);
+    if (!group)
+        return;
+
+    DCHECK(!group->is_encoded);
+    group->encoder->setKeyFrameRequired(true);
+}
+
+//--------------------------------------------------------------------------------------------------
+void VideoEncoderPool::setTargetBitrate(GroupId group_id, uint32_t target_bitrate)
+{
+    Group* group = groupById(group_id);
+    if (!group)
+        return;
+
+    DCHECK(!group->is_encoded);
+
+    if (!group->target_bitrate || target_bitrate < group->target_bitrate)
+        group->target_bitrate = target_bitrate;
+}
+
+//--------------------------------------------------------------------------------------------------
+void VideoEncoderPool::encodeFrame()
+{
+    for (const auto& group : groups_)
+    {
+        if (!group->members || group->is_encoded)
+            continue;
+
+        group->is_encoded = true;
+        group->is_failed = !encodeGroup(group.get());
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+bool VideoEncoderPool::encode(GroupId group_id, bool format_required, proto::VideoPacket* packet)
+{
+    DCHECK(packet);
+
+    Group* group = groupById(group_id);
+    if (!group)
+        return false;
+
+    // The groups are encoded by encodeFrame() on the worker thread before the packets are
+    // delivered. The packet is never encoded on the calling thread.
+    DCHECK(group->is_encoded);
+
+    if (!group->is_encoded || group->is_failed)
+        return false;
+
+    DCHECK_LT(group->delivered, group->members);
+    ++group->delivered;
+
+    // The last member takes the packet without copying.
+    if (group->delivered == group->members)
+        packet->Swap(&group->packet);
+    else
+        packet->CopyFrom(group->packet);
+
+    if (format_required && !packet->has_format() && group->has_format)
+        packet->mutable_format()->CopyFrom(group->format);
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+void VideoEncoderPool::setEncodeBuffer(GroupId group_id, std::string&& buffer)
+{
+    Group* group = groupById(group_id);
+    if (!group)
+        return;
+
+    group->encoder->setEncodeBuffer(std::move(buffer));
+}
+
+//--------------------------------------------------------------------------------------------------
+void VideoEncoderPool::endFrame()
+{
+    frame_ = nullptr;
+
+    for (auto it = groups_.begin(); it != groups_.end();)
+    {
+        Group* group = it->get();
+
+        // The encoder of a group without members has skipped the frame and can no longer produce
+        // delta frames.
+        if (!group->members)
+        {
+            LOG(LS_INFO) << "Video encoder group " << group->id << " destroyed";
+            it = groups_.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+VideoEncoderPool::Group* VideoEncoderPool::groupById(GroupId group_id)
+{
+    for (const auto& group : groups_)
+    {
+        if (group->id == group_id)
+            return group.get();
+    }
+
+    return nullptr;
+}
+
+//--------------------------------------------------------------------------------------------------
+bool VideoEncoderPool::encodeGroup(Group* group)
+{
+    DCHECK(frame_);
+
+    applyTargetBitrate(group);
+
+    const base::Frame* scaled_frame = group->scale_reducer->scaleFrame(frame_, group->params.size);
+    if (!scaled_frame)
+    {
+        LOG(LS_ERROR) << "No scaled frame";
+        return false;
+    }
+
+    // Encode the frame into a video packet.
+    if (!group->encoder->encode(scaled_frame, &group->packet))
+    {
+        LOG(LS_ERROR) << "Unable to encode video packet";
+        return false;
+    }
+
+    if (group->packet.has_format())
+    {
+        group->format = group->packet.format();
+        group->has_format = true;
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+// static
+void VideoEncoderPool::applyTargetBitrate(Group* group)
+{
+    if (!group->target_bitrate)
+        return;
+
+    if (group->params.encoding != proto::VIDEO_ENCODING_VP8 &&
+        group->params.encoding != proto::VIDEO_ENCODING_VP9)
+    {
+        return;
+    }
+
+    base::VideoEncoderVPX* encoder = static_cast<base::VideoEncoderVPX*>(group->encoder.get());
+
+    uint32_t target_bitrate = std::clamp(group->target_bitrate,
+                                         base::VideoEncoderVPX::kMinTargetBitrate,
+                                         base::VideoEncoderVPX::kMaxTargetBitrate);
+    if (encoder->targetBitrate() == target_bitrate)
+        return;
+
+    // On slow links the quality is allowed to drop further so that the bitrate can be met. On fast
+    // links the quality is kept higher.
+    uint32_t max_quantizer;
+    if (target_bitrate < 300)
+        max_quantizer = 56;
+    else if (target_bitrate < 1000)
+        max_quantizer = 45;
+    else if (target_bitrate < 8000)
+        max_quantizer = 30;
+    else
+        max_quantizer = 24;
+
+    LOG(LS_INFO) << "Video encoder group " << group->id << ": target bitrate "
+                 << encoder->targetBitrate() << " to " << target_bitrate << " kbps (max quantizer: "
+                 << max_quantizer << ")";
+
+    encoder->setTargetBitrate(target_bitrate);
+    encoder->setMaxQuantizer(max_quantizer);
+}
+
+} // namespace host
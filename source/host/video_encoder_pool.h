@@ -0,0 +1,110 @@
+//
+// Aspia Project
+// Copyright (C) 2016-2025 Dmitry Chapyshev <dmitry@aspia.ru>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef HOST_VIDEO_ENCODER_POOL_H
+#define HOST_VIDEO_ENCODER_POOL_H
+
+#include "base/macros_magic.h"
+#include "base/desktop/geometry.h"
+#include "base/desktop/pixel_format.h"
+#include "proto/desktop.pb.h"
+
+#include <memory>
+#include <vector>
+
+namespace base {
+class Frame;
+class ScaleReducer;
+class VideoEncoder;
+} // namespace base
+
+namespace host {
+
+// Shares video encoders between desktop clients with the same encoding parameters. Clients are
+// grouped by their effective parameters for each frame. The frame is scaled and encoded once per
+// group and the packet is delivered to every member of the group.
+class VideoEncoderPool
+{
+public:
+    using GroupId = uint64_t;
+    static const GroupId kInvalidGroupId = 0;
+
+    struct Params
+    {
+        proto::VideoEncoding encoding = proto::VIDEO_ENCODING_UNKNOWN;
+        base::PixelFormat pixel_format;
+        int compress_ratio = 0;
+        bool zstd_reference = false;
+        base::Size size;
+
+        bool operator==(const Params& other) const;
+    };
+
+    VideoEncoderPool();
+    ~VideoEncoderPool();
+
+    static bool isSupportedEncoding(proto::VideoEncoding encoding);
+
+    // Starts a new frame. Packets encoded for the previous frame are discarded.
+    void beginFrame(const base::Frame* frame);
+
+    // Adds a member to the group with parameters |params| for the current frame. If there is no
+    // such group, it is created. All members must join before the first call to encode().
+    GroupId join(const Params& params);
+
+    // The next packet of the group will be a key frame for all of its members.
+    void setKeyFrameRequired(GroupId group_id);
+
+    // Sets the target bitrate (kbps) requested by a member for the current frame. The group uses
+    // the lowest bitrate of its members. Only VPX encoders have the rate control.
+    void setTargetBitrate(GroupId group_id, uint32_t target_bitrate);
+
+    // Encodes the current frame for all groups which have members. May be called on another thread
+    // while the pool is not used by the owner thread.
+    void encodeFrame();
+
+    // Fills |packet| with the packet of the group for the current frame. The frame must be encoded
+    // by encodeFrame() before. If |format_required| is true, the packet always contains the video
+    // format (for members which have just joined the group).
+    bool encode(GroupId group_id, bool format_required, proto::VideoPacket* packet);
+
+    // Returns the buffer of a sent packet to the encoder of the group for reuse.
+    void setEncodeBuffer(GroupId group_id, std::string&& buffer);
+
+    // Finishes the current frame. Groups without members are destroyed.
+    void endFrame();
+
+    size_t groupCount() const { return groups_.size(); }
+
+private:
+    struct Group;
+
+    Group* groupById(GroupId group_id);
+    bool encodeGroup(Group* group);
+    static void applyTargetBitrate(Group* group);
+
+    const base::Frame* frame_ = nullptr;
+    GroupId last_group_id_ = kInvalidGroupId;
+    std::vector<std::unique_ptr<Group>> groups_;
+
+    DISALLOW_COPY_AND_ASSIGN(VideoEncoderPool);
+};
+
+} // namespace host
+
+#endif // HOST_VIDEO_ENCODER_POOL_H
@@ -86,6 +86,9 @@ Controller::Controller(std::shared_ptr<base::TaskRunner> task_runner)
     max_peer_count_ = settings.maxPeerCount();
     statistics_enabled_ = settings.isStatisticsEnabled();
     statistics_interval_ = settings.statisticsInterval();
+    zero_copy_enabled_ = settings.isZeroCopyEnabled();
+    worker_thread_count_ = settings.workerThreadCount();
+    weight_ = settings.weight();
 
     LOG(LS_INFO) << "Listen interface: " << listen_interface_;
     LOG(LS_INFO) << "Peer address: " << peer_address_;
@@ -94,6 +97,9 @@ Controller::Controller(std::shared_ptr<base::TaskRunner> task_runner)
     LOG(LS_INFO) << "Max peer count: " << max_peer_count_;
     LOG(LS_INFO) << "Statistics enabled: " << statistics_enabled_;
     LOG(LS_INFO) << "Statistics interval: " << statistics_interval_.count();
+    LOG(LS_INFO) << "Zero copy enabled: " << zero_copy_enabled_;
+    LOG(LS_INFO) << "Worker thread count: " << worker_thread_count_;
+    LOG(LS_INFO) << "Weight: " << weight_;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -157,7 +163,7 @@ bool Controller::start()
 
     sessions_worker_ = std::make_unique<SessionsWorker>(
         listen_interface_, peer_port_, peer_idle_timeout_, statistics_enabled_, statistics_interval_,
-        shared_pool_->share());
+        zero_copy_enabled_, worker_thread_count_, shared_pool_->share());
     sessions_worker_->start(task_runner_, this);
 
     connectToRouter();
@@ -346,6 +352,7 @@ void Controller::sendKeyPool(uint32_t key_count)
 
     relay_key_pool->set_peer_host(base::utf8FromUtf16(peer_address_));
     relay_key_pool->set_peer_port(peer_port_);
+    relay_key_pool->set_weight(weight_);
 
     // Add the requested number of keys to the pool.
     for (uint32_t i = 0; i < key_count; ++i)
@@ -34,7 +34,7 @@ namespace relay {
 
 class Controller final
     : public base::TcpChannel::Listener,
-      public SessionManager::Delegate,
+      public SessionsWorker::Delegate,
       public SharedPool::Delegate
 {
 public:
@@ -50,7 +50,7 @@ protected:
     void onTcpMessageReceived(uint8_t channel_id, const base::ByteArray& buffer) final;
     void onTcpMessageWritten(uint8_t channel_id, base::ByteArray&& buffer, size_t pending) final;
 
-    // SessionManager::Delegate implementation.
+    // SessionsWorker::Delegate implementation.
     void onSessionStarted() final;
     void onSessionStatistics(const proto::RelayStat& relay_stat) final;
     void onSessionFinished() final;
@@ -76,6 +76,9 @@ private:
     uint32_t max_peer_count_ = 0;
     bool statistics_enabled_ = false;
     std::chrono::seconds statistics_interval_;
+    bool zero_copy_enabled_ = false;
+    uint32_t worker_thread_count_ = 0;
+    uint32_t weight_ = 1;
 
     std::shared_ptr<base::TaskRunner> task_runner_;
     base::WaitableTimer reconnect_timer_;
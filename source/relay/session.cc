@@ -25,16 +25,34 @@
 
 #include <asio/write.hpp>
 
+#include <atomic>
+
+#if defined(OS_LINUX)
+#include "base/posix/eintr_wrapper.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#endif // defined(OS_LINUX)
+
 namespace relay {
 
+namespace {
+
+#if defined(OS_LINUX)
+// Maximum number of bytes moved by one splice() call. Matches the default pipe capacity.
+const size_t kSpliceSize = 64 * 1024;
+#endif // defined(OS_LINUX)
+
+} // namespace
+
 //--------------------------------------------------------------------------------------------------
 Session::Session(std::pair<asio::ip::tcp::socket, asio::ip::tcp::socket>&& sockets,
                  const base::ByteArray& secret)
     : socket_{ std::move(sockets.first), std::move(sockets.second) }
 {
-    static uint64_t session_id = 0;
-    ++session_id;
-    session_id_ = session_id;
+    // Sessions are created on different threads.
+    static std::atomic<uint64_t> last_session_id { 0 };
+    session_id_ = ++last_session_id;
 
     proto::PeerToRelay::Secret secret_message;
     if (secret_message.ParseFromArray(secret.data(), static_cast<int>(secret.size())))
@@ -56,13 +74,34 @@ Session::~Session()
 }
 
 //--------------------------------------------------------------------------------------------------
-void Session::start(Delegate* delegate)
+void Session::start(bool zero_copy, Delegate* delegate)
 {
     LOG(LS_INFO) << "Starting peers session";
 
     start_time_ = Clock::now();
     delegate_ = delegate;
 
+#if defined(OS_LINUX)
+    if (zero_copy)
+    {
+        if (initZeroCopy())
+        {
+            LOG(LS_INFO) << "Zero copy mode is used";
+
+            for (int i = 0; i < kNumberOfSides; ++i)
+                Session::doSpliceRead(this, i);
+            return;
+        }
+
+        LOG(LS_ERROR) << "Unable to initialize zero copy mode. Fallback to default mode";
+    }
+#else
+    if (zero_copy)
+    {
+        LOG(LS_INFO) << "Zero copy mode is not supported on this platform";
+    }
+#endif // defined(OS_LINUX)
+
     for (int i = 0; i < kNumberOfSides; ++i)
         Session::doReadSome(this, i);
 }
@@ -90,6 +129,10 @@ void Session::disconnect()
         socket_[i].close(ignored_code);
     }
 
+#if defined(OS_LINUX)
+    closeZeroCopy();
+#endif // defined(OS_LINUX)
+
     if (delegate_)
         delegate_->onSessionFinished(this);
 }
@@ -149,6 +192,163 @@ void Session::doReadSome(Session* session, int source)
     });
 }
 
+#if defined(OS_LINUX)
+
+//--------------------------------------------------------------------------------------------------
+bool Session::initZeroCopy()
+{
+    for (int i = 0; i < kNumberOfSides; ++i)
+    {
+        int fds[2];
+
+        if (pipe2(fds, O_NONBLOCK | O_CLOEXEC) != 0)
+        {
+            PLOG(LS_ERROR) << "pipe2 failed";
+            closeZeroCopy();
+            return false;
+        }
+
+        pipe_[i].read_fd = fds[0];
+        pipe_[i].write_fd = fds[1];
+        pipe_[i].pending = 0;
+
+        // splice() with sockets requires a non-blocking socket, otherwise the call can block
+        // the thread when the other side is slow.
+        std::error_code error_code;
+        socket_[i].native_non_blocking(true, error_code);
+        if (error_code)
+        {
+            LOG(LS_ERROR) << "Unable to set non-blocking mode: "
+                          << base::utf16FromLocal8Bit(error_code.message());
+            closeZeroCopy();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+void Session::closeZeroCopy()
+{
+    for (int i = 0; i < kNumberOfSides; ++i)
+    {
+        if (pipe_[i].read_fd != -1)
+        {
+            IGNORE_EINTR(close(pipe_[i].read_fd));
+            pipe_[i].read_fd = -1;
+        }
+
+        if (pipe_[i].write_fd != -1)
+        {
+            IGNORE_EINTR(close(pipe_[i].write_fd));
+            pipe_[i].write_fd = -1;
+        }
+
+        pipe_[i].pending = 0;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+// static
+void Session::doSpliceRead(Session* session, int source)
+{
+    session->socket_[source].async_wait(asio::ip::tcp::socket::wait_read,
+        [session, source](const std::error_code& error_code)
+    {
+        if (error_code)
+        {
+            if (error_code != asio::error::operation_aborted)
+                session->onErrorOccurred(FROM_HERE, error_code);
+            return;
+        }
+
+        session->onSpliceReadable(source);
+    });
+}
+
+//--------------------------------------------------------------------------------------------------
+void Session::onSpliceReadable(int source)
+{
+    Pipe& pipe = pipe_[source];
+    DCHECK_EQ(pipe.pending, 0U);
+
+    // Move the data from the socket to the pipe. The data stays in the kernel.
+    ssize_t ret = HANDLE_EINTR(splice(socket_[source].native_handle(), nullptr,
+                                      pipe.write_fd, nullptr,
+                                      kSpliceSize, SPLICE_F_MOVE | SPLICE_F_NONBLOCK));
+    if (ret == 0)
+    {
+        onErrorOccurred(FROM_HERE, asio::error::eof);
+        return;
+    }
+
+    if (ret < 0)
+    {
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+        {
+            // Spurious wakeup.
+            doSpliceRead(this, source);
+            return;
+        }
+
+        onErrorOccurred(FROM_HERE, std::error_code(errno, std::system_category()));
+        return;
+    }
+
+    bytes_transferred_ += ret;
+    start_idle_time_ = TimePoint();
+
+    pipe.pending = static_cast<size_t>(ret);
+    doSpliceWrite(this, source);
+}
+
+//--------------------------------------------------------------------------------------------------
+// static
+void Session::doSpliceWrite(Session* session, int source)
+{
+    const int target = (source + kNumberOfSides - 1) % kNumberOfSides;
+    Pipe& pipe = session->pipe_[source];
+
+    while (pipe.pending != 0)
+    {
+        // Move the data from the pipe to the opposite socket.
+        ssize_t ret = HANDLE_EINTR(splice(pipe.read_fd, nullptr,
+                                          session->socket_[target].native_handle(), nullptr,
+                                          pipe.pending, SPLICE_F_MOVE | SPLICE_F_NONBLOCK));
+        if (ret < 0)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                // The send buffer of the socket is full. Wait until it becomes writable.
+                session->socket_[target].async_wait(asio::ip::tcp::socket::wait_write,
+                    [session, source](const std::error_code& error_code)
+                {
+                    if (error_code)
+                    {
+                        if (error_code != asio::error::operation_aborted)
+                            session->onErrorOccurred(FROM_HERE, error_code);
+                        return;
+                    }
+
+                    doSpliceWrite(session, source);
+                });
+                return;
+            }
+
+            session->onErrorOccurred(FROM_HERE, std::error_code(errno, std::system_category()));
+            return;
+        }
+
+        pipe.pending -= static_cast<size_t>(ret);
+    }
+
+    // All data is written. Waiting for the next portion.
+    doSpliceRead(session, source);
+}
+
+#endif // defined(OS_LINUX)
+
 //--------------------------------------------------------------------------------------------------
 void Session::onErrorOccurred(const base::Location& location, const std::error_code& error_code)
 {
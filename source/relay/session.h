@@ -22,6 +22,7 @@
 #include "base/macros_magic.h"
 #include "base/memory/byte_array.h"
 #include "base/peer/host_id.h"
+#include "build/build_config.h"
 
 #include <asio/ip/tcp.hpp>
 
@@ -49,7 +50,9 @@ public:
         virtual void onSessionFinished(Session* session) = 0;
     };
 
-    void start(Delegate* delegate);
+    // If |zero_copy| is true and the platform supports it, data is transferred between sockets
+    // without copying to user space.
+    void start(bool zero_copy, Delegate* delegate);
     void stop();
     void disconnect();
 
@@ -64,6 +67,14 @@ public:
 
 private:
     static void doReadSome(Session* session, int source);
+
+#if defined(OS_LINUX)
+    bool initZeroCopy();
+    void closeZeroCopy();
+    static void doSpliceRead(Session* session, int source);
+    static void doSpliceWrite(Session* session, int source);
+    void onSpliceReadable(int source);
+#endif // defined(OS_LINUX)
     void onErrorOccurred(const base::Location& location, const std::error_code& error_code);
 
     uint64_t session_id_ = 0;
@@ -82,6 +93,21 @@ private:
     asio::ip::tcp::socket socket_[kNumberOfSides];
     std::array<uint8_t, kBufferSize> buffer_[kNumberOfSides];
 
+#if defined(OS_LINUX)
+    // Pipe for each direction. Data from |socket_[i]| is moved to |pipe_[i]| and then from the
+    // pipe to the opposite socket.
+    struct Pipe
+    {
+        int read_fd = -1;
+        int write_fd = -1;
+
+        // Number of bytes in the pipe that has not yet been written to the opposite socket.
+        size_t pending = 0;
+    };
+
+    Pipe pipe_[kNumberOfSides];
+#endif // defined(OS_LINUX)
+
     Delegate* delegate_ = nullptr;
 
     DISALLOW_COPY_AND_ASSIGN(Session);
@@ -123,20 +123,13 @@ std::u16string peerAddress(const asio::ip::tcp::socket& socket)
 
 //--------------------------------------------------------------------------------------------------
 SessionManager::SessionManager(std::shared_ptr<base::TaskRunner> task_runner,
-                               const asio::ip::address& address,
-                               uint16_t port,
                                const std::chrono::minutes& idle_timeout,
-                               bool statistics_enabled,
-                               const std::chrono::seconds& statistics_interval)
+                               bool zero_copy_enabled)
     : task_runner_(std::move(task_runner)),
       acceptor_(base::MessageLoop::current()->pumpAsio()->ioContext()),
-      address_(address),
-      port_(port),
       idle_timeout_(idle_timeout),
       idle_timer_(base::MessageLoop::current()->pumpAsio()->ioContext()),
-      stat_timer_(base::MessageLoop::current()->pumpAsio()->ioContext()),
-      statistics_enabled_(statistics_enabled),
-      statistics_interval_(statistics_interval)
+      zero_copy_enabled_(zero_copy_enabled)
 {
     LOG(LS_INFO) << "Ctor";
     DCHECK(task_runner_);
@@ -154,11 +147,25 @@ SessionManager::~SessionManager()
 }
 
 //--------------------------------------------------------------------------------------------------
-void SessionManager::start(std::unique_ptr<SharedPool> shared_pool, Delegate* delegate)
+void SessionManager::start(Delegate* delegate)
 {
     LOG(LS_INFO) << "Starting session manager";
 
-    asio::ip::tcp::endpoint endpoint(address_, port_);
+    delegate_ = delegate;
+    DCHECK(delegate_);
+
+    idle_timer_.expires_after(kIdleTimerInterval);
+    idle_timer_.async_wait(std::bind(&SessionManager::doIdleTimeout, this, std::placeholders::_1));
+}
+
+//--------------------------------------------------------------------------------------------------
+bool SessionManager::startListening(const asio::ip::address& address,
+                                    uint16_t port,
+                                    std::unique_ptr<SharedPool> shared_pool)
+{
+    LOG(LS_INFO) << "Starting listening";
+
+    asio::ip::tcp::endpoint endpoint(address, port);
 
     std::error_code error_code;
     acceptor_.open(endpoint.protocol(), error_code);
@@ -166,7 +173,7 @@ void SessionManager::start(std::unique_ptr<SharedPool> shared_pool, Delegate* de
     {
         LOG(LS_ERROR) << "acceptor_.open failed: "
                       << base::utf16FromLocal8Bit(error_code.message());
-        return;
+        return false;
     }
 
     acceptor_.set_option(asio::ip::tcp::acceptor::reuse_address(true), error_code);
@@ -174,7 +181,7 @@ void SessionManager::start(std::unique_ptr<SharedPool> shared_pool, Delegate* de
     {
         LOG(LS_ERROR) << "acceptor_.set_option failed: "
                       << base::utf16FromLocal8Bit(error_code.message());
-        return;
+        return false;
     }
 
     acceptor_.bind(endpoint, error_code);
@@ -182,7 +189,7 @@ void SessionManager::start(std::unique_ptr<SharedPool> shared_pool, Delegate* de
     {
         LOG(LS_ERROR) << "acceptor_.bind failed: "
                       << base::utf16FromLocal8Bit(error_code.message());
-        return;
+        return false;
     }
 
     acceptor_.listen(asio::ip::tcp::socket::max_listen_connections, error_code);
@@ -190,43 +197,64 @@ void SessionManager::start(std::unique_ptr<SharedPool> shared_pool, Delegate* de
     {
         LOG(LS_ERROR) << "acceptor_.listen failed: "
                       << base::utf16FromLocal8Bit(error_code.message());
-        return;
+        return false;
     }
 
-    start_time_ = Clock::now();
-
     shared_pool_ = std::move(shared_pool);
-    delegate_ = delegate;
-
-    DCHECK(delegate_ && shared_pool_);
-
-    idle_timer_.expires_after(kIdleTimerInterval);
-    idle_timer_.async_wait(std::bind(&SessionManager::doIdleTimeout, this, std::placeholders::_1));
-
-    if (statistics_enabled_)
-    {
-        stat_timer_.expires_after(statistics_interval_);
-        stat_timer_.async_wait(std::bind(&SessionManager::doStatTimeout, this, std::placeholders::_1));
-    }
+    DCHECK(shared_pool_);
 
     SessionManager::doAccept(this);
+    return true;
 }
 
 //--------------------------------------------------------------------------------------------------
-void SessionManager::disconnectSession(uint64_t session_id)
+void SessionManager::addSession(asio::ip::tcp::socket&& first,
+                                asio::ip::tcp::socket&& second,
+                                const base::ByteArray& secret)
 {
-    LOG(LS_INFO) << "Disconnect session by session id: " << session_id;
+    active_sessions_.emplace_back(std::make_unique<Session>(
+        std::make_pair(std::move(first), std::move(second)), secret));
+    active_sessions_.back()->start(zero_copy_enabled_, this);
 
+    if (delegate_)
+        delegate_->onSessionStarted();
+}
+
+//--------------------------------------------------------------------------------------------------
+bool SessionManager::disconnectSession(uint64_t session_id)
+{
     for (const auto& session : active_sessions_)
     {
         if (session->sessionId() == session_id)
         {
+            LOG(LS_INFO) << "Disconnect session by session id: " << session_id;
             session->disconnect();
-            return;
+            return true;
         }
     }
 
-    LOG(LS_ERROR) << "Session with id " << session_id << " not found";
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+void SessionManager::collectStatistics(proto::RelayStat* relay_stat) const
+{
+    Session::TimePoint now = Session::Clock::now();
+
+    for (const auto& session : active_sessions_)
+    {
+        proto::PeerConnection* peer_connection = relay_stat->add_peer_connection();
+
+        peer_connection->set_session_id(session->sessionId());
+        peer_connection->set_status(proto::PeerConnection::PEER_STATUS_ACTIVE);
+        peer_connection->set_client_address(session->clientAddress());
+        peer_connection->set_client_user_name(session->clientUserName());
+        peer_connection->set_host_address(session->hostAddress());
+        peer_connection->set_host_id(session->hostId());
+        peer_connection->set_bytes_transferred(session->bytesTransferred());
+        peer_connection->set_idle_time(session->idleTime(now).count());
+        peer_connection->set_duration(session->duration(now).count());
+    }
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -257,12 +285,11 @@ void SessionManager::onPendingSessionReady(
                     shared_pool_->removeKey(message.key_id());
 
                     // Now the opposite peer is found, start the data transfer between them.
-                    active_sessions_.emplace_back(std::make_unique<Session>(
-                        std::make_pair(session->takeSocket(), other_session->takeSocket()), secret));
-                    active_sessions_.back()->start(this);
-
                     if (delegate_)
-                        delegate_->onSessionStarted();
+                    {
+                        delegate_->onPeersConnected(
+                            session->takeSocket(), other_session->takeSocket(), secret);
+                    }
 
                     // Pending sessions are no longer needed, remove them.
                     removePendingSession(other_session.get());
@@ -358,6 +385,9 @@ void SessionManager::doIdleTimeoutImpl(const std::error_code& error_code)
             {
                 it = active_sessions_.erase(it);
                 ++count;
+
+                if (delegate_)
+                    delegate_->onSessionFinished();
             }
             else
             {
@@ -376,63 +406,6 @@ void SessionManager::doIdleTimeoutImpl(const std::error_code& error_code)
     idle_timer_.async_wait(std::bind(&SessionManager::doIdleTimeout, this, std::placeholders::_1));
 }
 
-//--------------------------------------------------------------------------------------------------
-// static
-void SessionManager::doStatTimeout(SessionManager* self, const std::error_code& error_code)
-{
-    if (error_code == asio::error::operation_aborted)
-    {
-        LOG(LS_ERROR) << "Operation aborted";
-        return;
-    }
-
-    self->doStatTimeoutImpl(error_code);
-}
-
-//--------------------------------------------------------------------------------------------------
-void SessionManager::doStatTimeoutImpl(const std::error_code& error_code)
-{
-    if (!error_code)
-    {
-        collectAndSendStatistics();
-    }
-    else
-    {
-        LOG(LS_ERROR) << "Error in stat timer: " << base::utf16FromLocal8Bit(error_code.message());
-    }
-
-    stat_timer_.expires_after(statistics_interval_);
-    stat_timer_.async_wait(std::bind(&SessionManager::doStatTimeout, this, std::placeholders::_1));
-}
-
-//--------------------------------------------------------------------------------------------------
-void SessionManager::collectAndSendStatistics()
-{
-    Session::TimePoint now = Session::Clock::now();
-
-    proto::RelayStat relay_stat;
-    relay_stat.set_uptime(
-        std::chrono::duration_cast<std::chrono::seconds>(now - start_time_).count());
-
-    for (const auto& session : active_sessions_)
-    {
-        proto::PeerConnection* peer_connection = relay_stat.add_peer_connection();
-
-        peer_connection->set_session_id(session->sessionId());
-        peer_connection->set_status(proto::PeerConnection::PEER_STATUS_ACTIVE);
-        peer_connection->set_client_address(session->clientAddress());
-        peer_connection->set_client_user_name(session->clientUserName());
-        peer_connection->set_host_address(session->hostAddress());
-        peer_connection->set_host_id(session->hostId());
-        peer_connection->set_bytes_transferred(session->bytesTransferred());
-        peer_connection->set_idle_time(session->idleTime(now).count());
-        peer_connection->set_duration(session->duration(now).count());
-    }
-
-    if (delegate_)
-        delegate_->onSessionStatistics(relay_stat);
-}
-
 //--------------------------------------------------------------------------------------------------
 void SessionManager::removePendingSession(PendingSession* session)
 {
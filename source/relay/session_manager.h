@@ -33,6 +33,9 @@ class TaskRunner;
 
 namespace relay {
 
+// Serves the sessions of one thread. The manager can also accept the connections from peers and
+// pair them (see startListening()). Paired peers are passed to the delegate which decides on
+// which thread the session will be served.
 class SessionManager final
     : public PendingSession::Delegate,
       public Session::Delegate
@@ -44,20 +47,34 @@ public:
         virtual ~Delegate() = default;
 
         virtual void onSessionStarted() = 0;
-        virtual void onSessionStatistics(const proto::RelayStat& relay_stat) = 0;
         virtual void onSessionFinished() = 0;
+
+        // Called when both peers are connected.
+        virtual void onPeersConnected(asio::ip::tcp::socket&& first,
+                                      asio::ip::tcp::socket&& second,
+                                      const base::ByteArray& secret) = 0;
     };
 
     SessionManager(std::shared_ptr<base::TaskRunner> task_runner,
-                   const asio::ip::address& address,
-                   uint16_t port,
                    const std::chrono::minutes& idle_timeout,
-                   bool statistics_enabled,
-                   const std::chrono::seconds& statistics_interval);
+                   bool zero_copy_enabled);
     ~SessionManager() final;
 
-    void start(std::unique_ptr<SharedPool> shared_pool, Delegate* delegate);
-    void disconnectSession(uint64_t session_id);
+    void start(Delegate* delegate);
+    bool startListening(const asio::ip::address& address,
+                        uint16_t port,
+                        std::unique_ptr<SharedPool> shared_pool);
+
+    // Starts data transfer between peers. The sockets must belong to the thread of the manager.
+    void addSession(asio::ip::tcp::socket&& first,
+                    asio::ip::tcp::socket&& second,
+                    const base::ByteArray& secret);
+
+    // Returns true if the session was found and disconnected.
+    bool disconnectSession(uint64_t session_id);
+
+    // Adds information about active sessions to |relay_stat|.
+    void collectStatistics(proto::RelayStat* relay_stat) const;
 
 protected:
     // PendingSession::Delegate implementation.
@@ -72,9 +89,6 @@ private:
     static void doAccept(SessionManager* self);
     static void doIdleTimeout(SessionManager* self, const std::error_code& error_code);
     void doIdleTimeoutImpl(const std::error_code& error_code);
-    static void doStatTimeout(SessionManager* self, const std::error_code& error_code);
-    void doStatTimeoutImpl(const std::error_code& error_code);
-    void collectAndSendStatistics();
 
     void removePendingSession(PendingSession* sessions);
     void removeSession(Session* session);
@@ -85,24 +99,13 @@ private:
     std::vector<std::unique_ptr<PendingSession>> pending_sessions_;
     std::vector<std::unique_ptr<Session>> active_sessions_;
 
-    const asio::ip::address address_;
-    const uint16_t port_;
-
     const std::chrono::minutes idle_timeout_;
     asio::high_resolution_timer idle_timer_;
 
-    asio::high_resolution_timer stat_timer_;
-
     std::unique_ptr<SharedPool> shared_pool_;
     Delegate* delegate_ = nullptr;
 
-    using Clock = std::chrono::high_resolution_clock;
-    using TimePoint = std::chrono::time_point<Clock>;
-
-    TimePoint start_time_;
-
-    bool statistics_enabled_ = false;
-    std::chrono::seconds statistics_interval_;
+    bool zero_copy_enabled_ = false;
 
     DISALLOW_COPY_AND_ASSIGN(SessionManager);
 };
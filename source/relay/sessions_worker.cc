@@ -19,39 +19,320 @@
 #include "relay/sessions_worker.h"
 
 #include "base/logging.h"
+#include "base/task_runner.h"
+#include "base/message_loop/message_loop.h"
+#include "base/message_loop/message_pump_asio.h"
 #include "base/strings/unicode.h"
+#include "base/threading/thread.h"
+#include "build/build_config.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#if defined(OS_POSIX)
+#include <unistd.h>
+#endif // defined(OS_POSIX)
 
 namespace relay {
 
+namespace {
+
+#if defined(OS_POSIX)
+
+// Socket detached from its io_context. It is used to pass a socket to another thread.
+struct NativeSocket
+{
+    asio::ip::tcp protocol = asio::ip::tcp::v4();
+    asio::ip::tcp::socket::native_handle_type handle;
+};
+
+//--------------------------------------------------------------------------------------------------
+bool releaseSocket(asio::ip::tcp::socket* socket, NativeSocket* native_socket)
+{
+    std::error_code error_code;
+
+    asio::ip::tcp::endpoint endpoint = socket->local_endpoint(error_code);
+    if (error_code)
+    {
+        LOG(LS_ERROR) << "Unable to get local endpoint: "
+                      << base::utf16FromLocal8Bit(error_code.message());
+        return false;
+    }
+
+    native_socket->protocol = endpoint.protocol();
+    native_socket->handle = socket->release(error_code);
+    if (error_code)
+    {
+        LOG(LS_ERROR) << "Unable to release socket: "
+                      << base::utf16FromLocal8Bit(error_code.message());
+        return false;
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+bool assignSocket(const NativeSocket& native_socket, asio::ip::tcp::socket* socket)
+{
+    std::error_code error_code;
+    socket->assign(native_socket.protocol, native_socket.handle, error_code);
+    if (error_code)
+    {
+        LOG(LS_ERROR) << "Unable to assign socket: "
+                      << base::utf16FromLocal8Bit(error_code.message());
+        return false;
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+void closeNativeSocket(const NativeSocket& native_socket)
+{
+    close(native_socket.handle);
+}
+
+#endif // defined(OS_POSIX)
+
+} // namespace
+
+class SessionsWorker::Worker final
+    : public base::Thread::Delegate,
+      public SessionManager::Delegate
+{
+public:
+    Worker(SessionsWorker* owner, size_t index);
+    ~Worker() final;
+
+    void start();
+    void stop();
+
+    size_t index() const { return index_; }
+    std::shared_ptr<base::TaskRunner> taskRunner() const { return task_runner_; }
+    SessionManager* sessionManager() const { return session_manager_.get(); }
+
+    // Number of active sessions including the sessions that are being passed to the worker.
+    int sessionCount() const { return session_count_; }
+
+    // Each session is reserved before it is passed to the worker and released exactly once: when
+    // the session is finished or when it could not be added to the worker.
+    void reserveSession();
+    void releaseSession();
+
+    // Methods below are called on the worker thread.
+#if defined(OS_POSIX)
+    void addSession(const NativeSocket& first,
+                    const NativeSocket& second,
+                    const base::ByteArray& secret);
+#endif // defined(OS_POSIX)
+    void disconnectSession(uint64_t session_id);
+    void collectStatistics();
+
+protected:
+    // base::Thread::Delegate implementation.
+    void onBeforeThreadRunning() final;
+    void onAfterThreadRunning() final;
+
+    // SessionManager::Delegate implementation.
+    void onSessionStarted() final;
+    void onSessionFinished() final;
+    void onPeersConnected(asio::ip::tcp::socket&& first,
+                          asio::ip::tcp::socket&& second,
+                          const base::ByteArray& secret) final;
+
+private:
+    SessionsWorker* owner_;
+    const size_t index_;
+
+    base::Thread thread_;
+    std::shared_ptr<base::TaskRunner> task_runner_;
+    std::unique_ptr<SessionManager> session_manager_;
+    std::atomic<int> session_count_ { 0 };
+
+    DISALLOW_COPY_AND_ASSIGN(Worker);
+};
+
+//--------------------------------------------------------------------------------------------------
+SessionsWorker::Worker::Worker(SessionsWorker* owner, size_t index)
+    : owner_(owner),
+      index_(index)
+{
+    DCHECK(owner_);
+}
+
+//--------------------------------------------------------------------------------------------------
+SessionsWorker::Worker::~Worker()
+{
+    stop();
+}
+
+//--------------------------------------------------------------------------------------------------
+void SessionsWorker::Worker::start()
+{
+    thread_.start(base::MessageLoop::Type::ASIO, this);
+}
+
+//--------------------------------------------------------------------------------------------------
+void SessionsWorker::Worker::stop()
+{
+    thread_.stop();
+}
+
+//--------------------------------------------------------------------------------------------------
+void SessionsWorker::Worker::reserveSession()
+{
+    ++session_count_;
+}
+
+//--------------------------------------------------------------------------------------------------
+void SessionsWorker::Worker::releaseSession()
+{
+    const int count = --session_count_;
+    DCHECK_GE(count, 0);
+}
+
+#if defined(OS_POSIX)
+//--------------------------------------------------------------------------------------------------
+void SessionsWorker::Worker::addSession(const NativeSocket& first,
+                                        const NativeSocket& second,
+                                        const base::ByteArray& secret)
+{
+    asio::io_context& io_context = base::MessageLoop::current()->pumpAsio()->ioContext();
+
+    asio::ip::tcp::socket first_socket(io_context);
+    asio::ip::tcp::socket second_socket(io_context);
+
+    if (!assignSocket(first, &first_socket))
+    {
+        closeNativeSocket(first);
+        closeNativeSocket(second);
+        releaseSession();
+        return;
+    }
+
+    if (!assignSocket(second, &second_socket))
+    {
+        closeNativeSocket(second);
+        releaseSession();
+        return;
+    }
+
+    session_manager_->addSession(std::move(first_socket), std::move(second_socket), secret);
+}
+#endif // defined(OS_POSIX)
+
+//--------------------------------------------------------------------------------------------------
+void SessionsWorker::Worker::disconnectSession(uint64_t session_id)
+{
+    if (session_manager_)
+        session_manager_->disconnectSession(session_id);
+}
+
+//--------------------------------------------------------------------------------------------------
+void SessionsWorker::Worker::collectStatistics()
+{
+    proto::RelayStat relay_stat;
+
+    if (session_manager_)
+        session_manager_->collectStatistics(&relay_stat);
+
+    owner_->onWorkerStatistics(relay_stat);
+}
+
+//--------------------------------------------------------------------------------------------------
+void SessionsWorker::Worker::onBeforeThreadRunning()
+{
+    LOG(LS_INFO) << "Before thread running (worker: " << index_ << ")";
+
+    task_runner_ = thread_.taskRunner();
+    DCHECK(task_runner_);
+
+    session_manager_ = std::make_unique<SessionManager>(
+        task_runner_, owner_->peer_idle_timeout_, owner_->zero_copy_enabled_);
+    session_manager_->start(this);
+}
+
+//--------------------------------------------------------------------------------------------------
+void SessionsWorker::Worker::onAfterThreadRunning()
+{
+    LOG(LS_INFO) << "After thread running (worker: " << index_ << ")";
+    session_manager_.reset();
+}
+
+//--------------------------------------------------------------------------------------------------
+void SessionsWorker::Worker::onSessionStarted()
+{
+    owner_->onSessionStarted();
+}
+
+//--------------------------------------------------------------------------------------------------
+void SessionsWorker::Worker::onSessionFinished()
+{
+    releaseSession();
+    owner_->onSessionFinished();
+}
+
+//--------------------------------------------------------------------------------------------------
+void SessionsWorker::Worker::onPeersConnected(asio::ip::tcp::socket&& first,
+                                              asio::ip::tcp::socket&& second,
+                                              const base::ByteArray& secret)
+{
+    owner_->onPeersConnected(this, std::move(first), std::move(second), secret);
+}
+
 //--------------------------------------------------------------------------------------------------
 SessionsWorker::SessionsWorker(std::u16string_view listen_interface,
                                uint16_t peer_port,
                                const std::chrono::minutes& peer_idle_timeout,
                                bool statistics_enabled,
                                const std::chrono::seconds& statistics_interval,
+                               bool zero_copy_enabled,
+                               uint32_t thread_count,
                                std::unique_ptr<SharedPool> shared_pool)
     : listen_interface_(listen_interface),
       peer_port_(peer_port),
       peer_idle_timeout_(peer_idle_timeout),
       statistics_enabled_(statistics_enabled),
       statistics_interval_(statistics_interval),
-      shared_pool_(std::move(shared_pool)),
-      thread_(std::make_unique<base::Thread>())
+      zero_copy_enabled_(zero_copy_enabled),
+      shared_pool_(std::move(shared_pool))
 {
     LOG(LS_INFO) << "Ctor";
     DCHECK(peer_port_ && shared_pool_);
+
+    if (!thread_count)
+        thread_count = std::max(std::thread::hardware_concurrency(), 1U);
+
+#if !defined(OS_POSIX)
+    // On Windows a socket stays bound to the completion port of its io_context and can not be
+    // passed to another thread. All sessions are served by the thread that accepts them.
+    if (thread_count != 1)
+    {
+        LOG(LS_INFO) << "Multiple worker threads are not supported on this platform";
+        thread_count = 1;
+    }
+#endif // !defined(OS_POSIX)
+
+    LOG(LS_INFO) << "Worker threads: " << thread_count;
+
+    for (uint32_t i = 0; i < thread_count; ++i)
+        workers_.emplace_back(std::make_unique<Worker>(this, i));
 }
 
 //--------------------------------------------------------------------------------------------------
 SessionsWorker::~SessionsWorker()
 {
     LOG(LS_INFO) << "Dtor";
-    thread_->stop();
+
+    stat_timer_.reset();
+
+    for (auto& worker : workers_)
+        worker->stop();
 }
 
 //--------------------------------------------------------------------------------------------------
-void SessionsWorker::start(std::shared_ptr<base::TaskRunner> caller_task_runner,
-                           SessionManager::Delegate* delegate)
+void SessionsWorker::start(std::shared_ptr<base::TaskRunner> caller_task_runner, Delegate* delegate)
 {
     LOG(LS_INFO) << "Starting session worker";
 
@@ -61,29 +342,6 @@ void SessionsWorker::start(std::shared_ptr<base::TaskRunner> caller_task_runner,
     DCHECK(caller_task_runner_);
     DCHECK(delegate_);
 
-    thread_->start(base::MessageLoop::Type::ASIO, this);
-}
-
-//--------------------------------------------------------------------------------------------------
-void SessionsWorker::disconnectSession(uint64_t session_id)
-{
-    if (!self_task_runner_->belongsToCurrentThread())
-    {
-        self_task_runner_->postTask(std::bind(&SessionsWorker::disconnectSession, this, session_id));
-        return;
-    }
-
-    session_manager_->disconnectSession(session_id);
-}
-
-//--------------------------------------------------------------------------------------------------
-void SessionsWorker::onBeforeThreadRunning()
-{
-    LOG(LS_INFO) << "Before thread running";
-
-    self_task_runner_ = thread_->taskRunner();
-    DCHECK(self_task_runner_);
-
     asio::ip::address listen_address;
 
     if (!listen_interface_.empty())
@@ -106,17 +364,95 @@ void SessionsWorker::onBeforeThreadRunning()
     LOG(LS_INFO) << "Listen interface: "
                  << (listen_interface_.empty() ? u"ANY" : listen_interface_) << ":" << peer_port_;
 
-    session_manager_ = std::make_unique<SessionManager>(
-        self_task_runner_, listen_address, peer_port_, peer_idle_timeout_, statistics_enabled_,
-        statistics_interval_);
-    session_manager_->start(std::move(shared_pool_), this);
+    for (auto& worker : workers_)
+        worker->start();
+
+    start_time_ = Clock::now();
+
+    // The first worker accepts incoming connections. All workers must be started before that
+    // because accepted sessions can be passed to any of them.
+    Worker* listener = workers_.front().get();
+    listener->taskRunner()->postTask([this, listener, listen_address]()
+    {
+        listener->sessionManager()->startListening(
+            listen_address, peer_port_, std::move(shared_pool_));
+    });
+
+    if (statistics_enabled_)
+    {
+        stat_timer_ = std::make_unique<base::WaitableTimer>(
+            base::WaitableTimer::Type::REPEATED, caller_task_runner_);
+        stat_timer_->start(statistics_interval_,
+                           std::bind(&SessionsWorker::onStatisticsTimeout, this));
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+void SessionsWorker::disconnectSession(uint64_t session_id)
+{
+    LOG(LS_INFO) << "Disconnect session by session id: " << session_id;
+
+    // The session can be served by any worker.
+    for (auto& worker : workers_)
+    {
+        worker->taskRunner()->postTask(
+            std::bind(&Worker::disconnectSession, worker.get(), session_id));
+    }
 }
 
 //--------------------------------------------------------------------------------------------------
-void SessionsWorker::onAfterThreadRunning()
+void SessionsWorker::onPeersConnected(Worker* source,
+                                      asio::ip::tcp::socket&& first,
+                                      asio::ip::tcp::socket&& second,
+                                      const base::ByteArray& secret)
 {
-    LOG(LS_INFO) << "After thread running";
-    session_manager_.reset();
+#if defined(OS_POSIX)
+    Worker* target = leastLoadedWorker();
+    if (target != source)
+    {
+        NativeSocket native_first;
+        NativeSocket native_second;
+
+        if (releaseSocket(&first, &native_first))
+        {
+            if (releaseSocket(&second, &native_second))
+            {
+                target->reserveSession();
+
+                LOG(LS_INFO) << "Session is passed to worker " << target->index()
+                             << " (sessions: " << target->sessionCount() << ")";
+
+                target->taskRunner()->postTask(std::bind(
+                    &Worker::addSession, target, native_first, native_second, secret));
+                return;
+            }
+
+            // Return the first socket back.
+            if (!assignSocket(native_first, &first))
+                closeNativeSocket(native_first);
+        }
+
+        LOG(LS_ERROR) << "Unable to pass session to worker " << target->index()
+                      << ". Session will be served by worker " << source->index();
+    }
+#endif // defined(OS_POSIX)
+
+    source->reserveSession();
+    source->sessionManager()->addSession(std::move(first), std::move(second), secret);
+}
+
+//--------------------------------------------------------------------------------------------------
+SessionsWorker::Worker* SessionsWorker::leastLoadedWorker() const
+{
+    Worker* result = workers_.front().get();
+
+    for (const auto& worker : workers_)
+    {
+        if (worker->sessionCount() < result->sessionCount())
+            result = worker.get();
+    }
+
+    return result;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -133,30 +469,56 @@ void SessionsWorker::onSessionStarted()
 }
 
 //--------------------------------------------------------------------------------------------------
-void SessionsWorker::onSessionStatistics(const proto::RelayStat& relay_stat)
+void SessionsWorker::onSessionFinished()
 {
     if (!caller_task_runner_->belongsToCurrentThread())
     {
-        caller_task_runner_->postTask(
-            std::bind(&SessionsWorker::onSessionStatistics, this, relay_stat));
+        caller_task_runner_->postTask(std::bind(&SessionsWorker::onSessionFinished, this));
         return;
     }
 
     if (delegate_)
-        delegate_->onSessionStatistics(relay_stat);
+        delegate_->onSessionFinished();
 }
 
 //--------------------------------------------------------------------------------------------------
-void SessionsWorker::onSessionFinished()
+void SessionsWorker::onStatisticsTimeout()
+{
+    if (pending_statistics_ != 0)
+    {
+        LOG(LS_INFO) << "Previous statistics are not collected yet";
+        return;
+    }
+
+    relay_stat_.Clear();
+    relay_stat_.set_uptime(
+        std::chrono::duration_cast<std::chrono::seconds>(Clock::now() - start_time_).count());
+
+    pending_statistics_ = workers_.size();
+
+    for (auto& worker : workers_)
+        worker->taskRunner()->postTask(std::bind(&Worker::collectStatistics, worker.get()));
+}
+
+//--------------------------------------------------------------------------------------------------
+void SessionsWorker::onWorkerStatistics(const proto::RelayStat& relay_stat)
 {
     if (!caller_task_runner_->belongsToCurrentThread())
     {
-        caller_task_runner_->postTask(std::bind(&SessionsWorker::onSessionFinished, this));
+        caller_task_runner_->postTask(
+            std::bind(&SessionsWorker::onWorkerStatistics, this, relay_stat));
         return;
     }
 
+    DCHECK_NE(pending_statistics_, 0U);
+
+    relay_stat_.mutable_peer_connection()->MergeFrom(relay_stat.peer_connection());
+
+    if (--pending_statistics_ != 0)
+        return;
+
     if (delegate_)
-        delegate_->onSessionFinished();
+        delegate_->onSessionStatistics(relay_stat_);
 }
 
 } // namespace relay
@@ -19,54 +19,82 @@
 #ifndef RELAY_SESSIONS_WORKER_H
 #define RELAY_SESSIONS_WORKER_H
 
-#include "base/threading/thread.h"
+#include "base/waitable_timer.h"
+#include "proto/router_relay.pb.h"
 #include "relay/session_manager.h"
 
 namespace relay {
 
 class SharedPool;
 
-class SessionsWorker final
-    : public base::Thread::Delegate,
-      public SessionManager::Delegate
+// Runs the pool of threads that serve the sessions. Each thread has its own asio loop and its own
+// SessionManager. The first thread also accepts incoming connections. When both peers are
+// connected, the session is passed to the thread with the smallest number of active sessions.
+// Sockets can be passed between threads only on POSIX systems, on other systems one thread is used.
+class SessionsWorker
 {
 public:
+    class Delegate
+    {
+    public:
+        virtual ~Delegate() = default;
+
+        virtual void onSessionStarted() = 0;
+        virtual void onSessionStatistics(const proto::RelayStat& relay_stat) = 0;
+        virtual void onSessionFinished() = 0;
+    };
+
+    // If |thread_count| is 0, then the number of threads is equal to the number of processors.
     SessionsWorker(std::u16string_view listen_interface,
                    uint16_t peer_port,
                    const std::chrono::minutes& peer_idle_timeout,
                    bool statistics_enabled,
                    const std::chrono::seconds& statistics_interval,
+                   bool zero_copy_enabled,
+                   uint32_t thread_count,
                    std::unique_ptr<SharedPool> shared_pool);
-    ~SessionsWorker() final;
+    ~SessionsWorker();
 
-    void start(std::shared_ptr<base::TaskRunner> caller_task_runner,
-               SessionManager::Delegate* delegate);
+    void start(std::shared_ptr<base::TaskRunner> caller_task_runner, Delegate* delegate);
     void disconnectSession(uint64_t session_id);
 
-protected:
-    // base::Thread::Delegate implementation.
-    void onBeforeThreadRunning() final;
-    void onAfterThreadRunning() final;
+private:
+    class Worker;
+    friend class Worker;
 
-    // SessionManager::Delegate implementation.
-    void onSessionStarted() final;
-    void onSessionStatistics(const proto::RelayStat& relay_stat) final;
-    void onSessionFinished() final;
+    void onPeersConnected(Worker* source,
+                          asio::ip::tcp::socket&& first,
+                          asio::ip::tcp::socket&& second,
+                          const base::ByteArray& secret);
+    Worker* leastLoadedWorker() const;
+
+    void onSessionStarted();
+    void onSessionFinished();
+    void onStatisticsTimeout();
+    void onWorkerStatistics(const proto::RelayStat& relay_stat);
 
-private:
     const std::u16string listen_interface_;
     const uint16_t peer_port_;
     const std::chrono::minutes peer_idle_timeout_;
     const bool statistics_enabled_;
     const std::chrono::seconds statistics_interval_;
+    const bool zero_copy_enabled_;
 
     std::unique_ptr<SharedPool> shared_pool_;
 
-    std::unique_ptr<base::Thread> thread_;
+    std::vector<std::unique_ptr<Worker>> workers_;
     std::shared_ptr<base::TaskRunner> caller_task_runner_;
-    std::shared_ptr<base::TaskRunner> self_task_runner_;
-    std::unique_ptr<SessionManager> session_manager_;
-    SessionManager::Delegate* delegate_ = nullptr;
+    Delegate* delegate_ = nullptr;
+
+    using Clock = std::chrono::high_resolution_clock;
+    using TimePoint = std::chrono::time_point<Clock>;
+
+    TimePoint start_time_;
+    std::unique_ptr<base::WaitableTimer> stat_timer_;
+
+    // Statistics collected from the workers.
+    proto::RelayStat relay_stat_;
+    size_t pending_statistics_ = 0;
 
     DISALLOW_COPY_AND_ASSIGN(SessionsWorker);
 };
@@ -60,6 +60,9 @@ void Settings::reset()
     setMaxPeerCount(100);
     setStatisticsEnabled(false);
     setStatisticsInterval(std::chrono::seconds(5));
+    setZeroCopyEnabled(false);
+    setWorkerThreadCount(0);
+    setWeight(1);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -188,4 +191,40 @@ std::chrono::seconds Settings::statisticsInterval() const
     return std::chrono::seconds(impl_.get<int>("StatisticsInterval", 5));
 }
 
+//--------------------------------------------------------------------------------------------------
+void Settings::setZeroCopyEnabled(bool enable)
+{
+    impl_.set<bool>("ZeroCopy", enable);
+}
+
+//--------------------------------------------------------------------------------------------------
+bool Settings::isZeroCopyEnabled() const
+{
+    return impl_.get<bool>("ZeroCopy", false);
+}
+
+//--------------------------------------------------------------------------------------------------
+void Settings::setWorkerThreadCount(uint32_t count)
+{
+    impl_.set<uint32_t>("WorkerThreads", count);
+}
+
+//--------------------------------------------------------------------------------------------------
+uint32_t Settings::workerThreadCount() const
+{
+    return impl_.get<uint32_t>("WorkerThreads", 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+void Settings::setWeight(uint32_t weight)
+{
+    impl_.set<uint32_t>("Weight", weight);
+}
+
+//--------------------------------------------------------------------------------------------------
+uint32_t Settings::weight() const
+{
+    return impl_.get<uint32_t>("Weight", 1);
+}
+
 } // namespace relay
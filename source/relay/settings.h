@@ -66,6 +66,21 @@ public:
     void setStatisticsInterval(const std::chrono::seconds& interval);
     std::chrono::seconds statisticsInterval() const;
 
+    // If enabled, data between peers is transferred with splice() without copying to user space.
+    // Supported only on Linux.
+    void setZeroCopyEnabled(bool enable);
+    bool isZeroCopyEnabled() const;
+
+    // Number of threads that serve the sessions. If 0, then the number of threads is equal to the
+    // number of processors.
+    void setWorkerThreadCount(uint32_t count);
+    uint32_t workerThreadCount() const;
+
+    // Relative capacity of the relay reported to the router. The router gives a relay with weight 2
+    // twice as many sessions as a relay with weight 1.
+    void setWeight(uint32_t weight);
+    uint32_t weight() const;
+
 private:
     base::JsonSettings impl_;
 };
@@ -22,6 +22,61 @@
 
 namespace router {
 
+namespace {
+
+class SharedDatabase final : public Database
+{
+public:
+    explicit SharedDatabase(base::local_shared_ptr<DatabaseSqlite> connection)
+        : connection_(std::move(connection))
+    {
+        // Nothing
+    }
+
+    // Database implementation.
+    std::vector<base::User> userList() const final
+    {
+        return connection_->userList();
+    }
+
+    bool addUser(const base::User& user) final
+    {
+        return connection_->addUser(user);
+    }
+
+    bool modifyUser(const base::User& user) final
+    {
+        return connection_->modifyUser(user);
+    }
+
+    bool removeUser(int64_t entry_id) final
+    {
+        return connection_->removeUser(entry_id);
+    }
+
+    base::User findUser(std::u16string_view username) final
+    {
+        return connection_->findUser(username);
+    }
+
+    ErrorCode hostId(const base::ByteArray& key_hash, base::HostId* host_id) const final
+    {
+        return connection_->hostId(key_hash, host_id);
+    }
+
+    bool addHost(const base::ByteArray& key_hash) final
+    {
+        return connection_->addHost(key_hash);
+    }
+
+private:
+    base::local_shared_ptr<DatabaseSqlite> connection_;
+
+    DISALLOW_COPY_AND_ASSIGN(SharedDatabase);
+};
+
+} // namespace
+
 //--------------------------------------------------------------------------------------------------
 DatabaseFactorySqlite::DatabaseFactorySqlite() = default;
 
@@ -37,7 +92,16 @@ std::unique_ptr<Database> DatabaseFactorySqlite::createDatabase() const
 //--------------------------------------------------------------------------------------------------
 std::unique_ptr<Database> DatabaseFactorySqlite::openDatabase() const
 {
-    return DatabaseSqlite::open();
+    if (!connection_)
+    {
+        std::unique_ptr<DatabaseSqlite> connection = DatabaseSqlite::open();
+        if (!connection)
+            return nullptr;
+
+        connection_.reset(connection.release());
+    }
+
+    return std::make_unique<SharedDatabase>(connection_);
 }
 
 } // namespace router
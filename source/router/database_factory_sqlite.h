@@ -20,10 +20,13 @@
 #define ROUTER_DATABASE_FACTORY_SQLITE_H
 
 #include "base/macros_magic.h"
+#include "base/memory/local_memory.h"
 #include "router/database_factory.h"
 
 namespace router {
 
+class DatabaseSqlite;
+
 class DatabaseFactorySqlite final : public DatabaseFactory
 {
 public:
@@ -31,9 +34,14 @@ public:
     ~DatabaseFactorySqlite() final;
 
     std::unique_ptr<Database> createDatabase() const final;
+
+    // All databases opened by the factory share one connection. The prepared statements and the
+    // in-memory indexes of the connection are kept between calls.
     std::unique_ptr<Database> openDatabase() const final;
 
 private:
+    mutable base::local_shared_ptr<DatabaseSqlite> connection_;
+
     DISALLOW_COPY_AND_ASSIGN(DatabaseFactorySqlite);
 };
 
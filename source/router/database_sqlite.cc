@@ -30,6 +30,52 @@ namespace router {
 
 namespace {
 
+// Must be in the same order as DatabaseSqlite::Query.
+const char* const kQueries[] =
+{
+    // USER_LIST
+    "SELECT * FROM users",
+
+    // ADD_USER
+    "INSERT INTO users ('id', 'name', 'group', 'salt', 'verifier', 'sessions', 'flags') "
+    "VALUES (NULL, ?, ?, ?, ?, ?, ?)",
+
+    // MODIFY_USER
+    "UPDATE users SET ('name', 'group', 'salt', 'verifier', 'sessions', 'flags') = "
+    "(?, ?, ?, ?, ?, ?) WHERE id=?",
+
+    // REMOVE_USER
+    "DELETE FROM users WHERE id=?",
+
+    // HOST_ID
+    "SELECT * FROM hosts WHERE key=?",
+
+    // ADD_HOST
+    "INSERT INTO hosts ('id', 'key') VALUES (NULL, ?)"
+};
+
+// Resets a cached statement and clears its bindings when leaving the scope, so that the statement
+// can be executed again.
+class ScopedStatementReset
+{
+public:
+    explicit ScopedStatementReset(sqlite3_stmt* statement)
+        : statement_(statement)
+    {
+        // Nothing
+    }
+
+    ~ScopedStatementReset()
+    {
+        sqlite3_reset(statement_);
+        sqlite3_clear_bindings(statement_);
+    }
+
+private:
+    sqlite3_stmt* statement_;
+    DISALLOW_COPY_AND_ASSIGN(ScopedStatementReset);
+};
+
 //--------------------------------------------------------------------------------------------------
 const char* columnTypeToString(int type)
 {
@@ -274,6 +320,9 @@ DatabaseSqlite::DatabaseSqlite(sqlite3* db)
 //--------------------------------------------------------------------------------------------------
 DatabaseSqlite::~DatabaseSqlite()
 {
+    for (sqlite3_stmt* statement : statements_)
+        sqlite3_finalize(statement);
+
     sqlite3_close(db_);
 }
 
@@ -281,7 +330,21 @@ DatabaseSqlite::~DatabaseSqlite()
 // static
 std::unique_ptr<DatabaseSqlite> DatabaseSqlite::create()
 {
-    std::filesystem::path dir_path = databaseDirectory();
+    std::filesystem::path file_path = filePath();
+    if (file_path.empty())
+    {
+        LOG(LS_ERROR) << "Invalid file path";
+        return nullptr;
+    }
+
+    return create(file_path);
+}
+
+//--------------------------------------------------------------------------------------------------
+// static
+std::unique_ptr<DatabaseSqlite> DatabaseSqlite::create(const std::filesystem::path& file_path)
+{
+    std::filesystem::path dir_path = file_path.parent_path();
     if (dir_path.empty())
     {
         LOG(LS_ERROR) << "Invalid directory path";
@@ -309,20 +372,13 @@ std::unique_ptr<DatabaseSqlite> DatabaseSqlite::create()
         }
     }
 
-    std::filesystem::path file_path = filePath();
-    if (file_path.empty())
-    {
-        LOG(LS_ERROR) << "Invalid file path";
-        return nullptr;
-    }
-
     if (std::filesystem::exists(file_path, error_code))
     {
         LOG(LS_ERROR) << "Database file already exists";
         return nullptr;
     }
 
-    std::unique_ptr<DatabaseSqlite> db = open();
+    std::unique_ptr<DatabaseSqlite> db = open(file_path);
     if (!db)
         return nullptr;
 
@@ -364,6 +420,13 @@ std::unique_ptr<DatabaseSqlite> DatabaseSqlite::open()
         return nullptr;
     }
 
+    return open(file_path);
+}
+
+//--------------------------------------------------------------------------------------------------
+// static
+std::unique_ptr<DatabaseSqlite> DatabaseSqlite::open(const std::filesystem::path& file_path)
+{
     std::string file_path_utf8 = base::utf8FromFilePath(file_path);
     LOG(LS_INFO) << "Opening database: " << file_path_utf8;
 
@@ -395,35 +458,7 @@ std::filesystem::path DatabaseSqlite::filePath()
 //--------------------------------------------------------------------------------------------------
 std::vector<base::User> DatabaseSqlite::userList() const
 {
-    const char kQuery[] = "SELECT * FROM users";
-
-    sqlite3_stmt* statement;
-    int error_code = sqlite3_prepare(db_,
-                                     kQuery,
-                                     static_cast<int>(std::size(kQuery)),
-                                     &statement,
-                                     nullptr);
-    if (error_code != SQLITE_OK)
-    {
-        LOG(LS_ERROR) << "sqlite3_prepare failed: " << sqlite3_errstr(error_code)
-                      << " (" << error_code << ")";
-        return {};
-    }
-
-    std::vector<base::User> users;
-    for (;;)
-    {
-        error_code = sqlite3_step(statement);
-        if (error_code != SQLITE_ROW)
-            break;
-
-        std::optional<base::User> user = readUser(statement);
-        if (user.has_value())
-            users.emplace_back(std::move(*user));
-    }
-
-    sqlite3_finalize(statement);
-    return users;
+    return readUsers().value_or(std::vector<base::User>());
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -435,22 +470,14 @@ bool DatabaseSqlite::addUser(const base::User& user)
         return false;
     }
 
-    static const char kQuery[] =
-        "INSERT INTO users ('id', 'name', 'group', 'salt', 'verifier', 'sessions', 'flags') "
-        "VALUES (NULL, ?, ?, ?, ?, ?, ?)";
-
-    sqlite3_stmt* statement = nullptr;
-    int error_code = sqlite3_prepare(db_,
-                                     kQuery,
-                                     static_cast<int>(std::size(kQuery)),
-                                     &statement,
-                                     nullptr);
-    if (error_code != SQLITE_OK)
-    {
-        LOG(LS_ERROR) << "sqlite3_prepare failed: " << sqlite3_errstr(error_code)
-                      << " (" << error_code << ")";
+    sqlite3_stmt* statement = preparedStatement(Query::ADD_USER);
+    if (!statement)
         return false;
-    }
+
+    ScopedStatementReset statement_reset(statement);
+
+    // The index is loaded again on the next search.
+    users_.reset();
 
     std::string username = base::utf8FromUtf16(user.name);
     bool result = false;
@@ -475,7 +502,7 @@ bool DatabaseSqlite::addUser(const base::User& user)
         if (!writeInt(statement, static_cast<int>(user.flags), 6))
             break;
 
-        error_code = sqlite3_step(statement);
+        int error_code = sqlite3_step(statement);
         if (error_code != SQLITE_DONE)
         {
             LOG(LS_ERROR) << "sqlite3_step failed: " << sqlite3_errstr(error_code)
@@ -487,7 +514,6 @@ bool DatabaseSqlite::addUser(const base::User& user)
     }
     while (false);
 
-    sqlite3_finalize(statement);
     return result;
 }
 
@@ -500,22 +526,14 @@ bool DatabaseSqlite::modifyUser(const base::User& user)
         return false;
     }
 
-    static const char kQuery[] =
-        "UPDATE users SET ('name', 'group', 'salt', 'verifier', 'sessions', 'flags') = "
-        "(?, ?, ?, ?, ?, ?) WHERE id=?";
-
-    sqlite3_stmt* statement = nullptr;
-    int error_code = sqlite3_prepare(db_,
-                                     kQuery,
-                                     static_cast<int>(std::size(kQuery)),
-                                     &statement,
-                                     nullptr);
-    if (error_code != SQLITE_OK)
-    {
-        LOG(LS_ERROR) << "sqlite3_prepare failed: " << sqlite3_errstr(error_code)
-                      << " (" << error_code << ")";
+    sqlite3_stmt* statement = preparedStatement(Query::MODIFY_USER);
+    if (!statement)
         return false;
-    }
+
+    ScopedStatementReset statement_reset(statement);
+
+    // The index is loaded again on the next search.
+    users_.reset();
 
     std::string username = base::utf8FromUtf16(user.name);
     bool result = false;
@@ -543,7 +561,7 @@ bool DatabaseSqlite::modifyUser(const base::User& user)
         if (!writeInt64(statement, user.entry_id, 7))
             break;
 
-        error_code = sqlite3_step(statement);
+        int error_code = sqlite3_step(statement);
         if (error_code != SQLITE_DONE)
         {
             LOG(LS_ERROR) << "sqlite3_step failed: " << sqlite3_errstr(error_code)
@@ -555,26 +573,20 @@ bool DatabaseSqlite::modifyUser(const base::User& user)
     }
     while (false);
 
-    sqlite3_finalize(statement);
     return result;
 }
 
 //--------------------------------------------------------------------------------------------------
 bool DatabaseSqlite::removeUser(int64_t entry_id)
 {
-    static const char kQuery[] = "DELETE FROM users WHERE id=?";
-
-    sqlite3_stmt* statement = nullptr;
-    int error_code = sqlite3_prepare(db_,
-                                     kQuery,
-                                     static_cast<int>(std::size(kQuery)),
-                                     &statement,
-                                     nullptr);
-    if (error_code != SQLITE_OK)
-    {
-        LOG(LS_ERROR) << "sqlite3_prepare failed: " << sqlite3_errstr(error_code);
+    sqlite3_stmt* statement = preparedStatement(Query::REMOVE_USER);
+    if (!statement)
         return false;
-    }
+
+    ScopedStatementReset statement_reset(statement);
+
+    // The index is loaded again on the next search.
+    users_.reset();
 
     bool result = false;
 
@@ -583,7 +595,7 @@ bool DatabaseSqlite::removeUser(int64_t entry_id)
         if (!writeInt64(statement, entry_id, 1))
             break;
 
-        error_code = sqlite3_step(statement);
+        int error_code = sqlite3_step(statement);
         if (error_code != SQLITE_DONE)
         {
             LOG(LS_ERROR) << "sqlite3_step failed: " << sqlite3_errstr(error_code)
@@ -595,45 +607,32 @@ bool DatabaseSqlite::removeUser(int64_t entry_id)
     }
     while (false);
 
-    sqlite3_finalize(statement);
     return result;
 }
 
 //--------------------------------------------------------------------------------------------------
 base::User DatabaseSqlite::findUser(std::u16string_view username)
 {
-    const char kQuery[] = "SELECT * FROM users WHERE name=?";
-
-    sqlite3_stmt* statement = nullptr;
-    int error_code = sqlite3_prepare(db_,
-                                     kQuery,
-                                     static_cast<int>(std::size(kQuery)),
-                                     &statement,
-                                     nullptr);
-    if (error_code != SQLITE_OK)
-    {
-        LOG(LS_ERROR) << "sqlite3_prepare failed: " << sqlite3_errstr(error_code)
-                      << " (" << error_code << ")";
-        return base::User::kInvalidUser;
-    }
-
-    std::string username_utf8 = base::utf8FromUtf16(username);
-    std::optional<base::User> user;
-
-    do
+    if (!users_.has_value())
     {
-        if (!writeText(statement, username_utf8, 1))
-            break;
+        std::optional<std::vector<base::User>> users = readUsers();
+        if (!users.has_value())
+            return base::User::kInvalidUser;
 
-        if (sqlite3_step(statement) != SQLITE_ROW)
-            break;
+        users_.emplace();
 
-        user = readUser(statement);
+        for (auto& user : *users)
+        {
+            std::u16string name = user.name;
+            users_->emplace(std::move(name), std::move(user));
+        }
     }
-    while (false);
 
-    sqlite3_finalize(statement);
-    return user.value_or(base::User::kInvalidUser);
+    auto result = users_->find(username);
+    if (result == users_->end())
+        return base::User::kInvalidUser;
+
+    return result->second;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -652,23 +651,20 @@ Database::ErrorCode DatabaseSqlite::hostId(
         return ErrorCode::UNKNOWN;
     }
 
-    *host_id = base::kInvalidHostId;
+    auto cached = hosts_.find(key_hash);
+    if (cached != hosts_.end())
+    {
+        *host_id = cached->second;
+        return ErrorCode::SUCCESS;
+    }
 
-    const char kQuery[] = "SELECT * FROM hosts WHERE key=?";
+    *host_id = base::kInvalidHostId;
 
-    sqlite3_stmt* statement;
-    int error_code = sqlite3_prepare(db_,
-                                     kQuery,
-                                     static_cast<int>(std::size(kQuery)),
-                                     &statement,
-                                     nullptr);
-    if (error_code != SQLITE_OK)
-    {
-        LOG(LS_ERROR) << "sqlite3_prepare failed: " << sqlite3_errstr(error_code)
-                      << " (" << error_code << ")";
+    sqlite3_stmt* statement = preparedStatement(Query::HOST_ID);
+    if (!statement)
         return ErrorCode::UNKNOWN;
-    }
 
+    ScopedStatementReset statement_reset(statement);
     ErrorCode result = ErrorCode::UNKNOWN;
 
     do
@@ -676,7 +672,7 @@ Database::ErrorCode DatabaseSqlite::hostId(
         if (!writeBlob(statement, key_hash, 1))
             break;
 
-        error_code = sqlite3_step(statement);
+        int error_code = sqlite3_step(statement);
         if (error_code != SQLITE_ROW)
         {
             LOG(LS_ERROR) << "sqlite3_step failed: " << sqlite3_errstr(error_code)
@@ -693,11 +689,11 @@ Database::ErrorCode DatabaseSqlite::hostId(
         }
 
         *host_id = static_cast<base::HostId>(*entry_id);
+        hosts_.emplace(key_hash, *host_id);
         result = ErrorCode::SUCCESS;
     }
     while (false);
 
-    sqlite3_finalize(statement);
     return result;
 }
 
@@ -710,21 +706,11 @@ bool DatabaseSqlite::addHost(const base::ByteArray& keyHash)
         return false;
     }
 
-    const char kQuery[] = "INSERT INTO hosts ('id', 'key') VALUES (NULL, ?)";
-
-    sqlite3_stmt* statement = nullptr;
-    int error_code = sqlite3_prepare(db_,
-                                     kQuery,
-                                     static_cast<int>(std::size(kQuery)),
-                                     &statement,
-                                     nullptr);
-    if (error_code != SQLITE_OK)
-    {
-        LOG(LS_ERROR) << "sqlite3_prepare failed: " << sqlite3_errstr(error_code)
-                      << " (" << error_code << ")";
+    sqlite3_stmt* statement = preparedStatement(Query::ADD_HOST);
+    if (!statement)
         return false;
-    }
 
+    ScopedStatementReset statement_reset(statement);
     bool result = false;
 
     do
@@ -732,7 +718,7 @@ bool DatabaseSqlite::addHost(const base::ByteArray& keyHash)
         if (!writeBlob(statement, keyHash, 1))
             break;
 
-        error_code = sqlite3_step(statement);
+        int error_code = sqlite3_step(statement);
         if (error_code != SQLITE_DONE)
         {
             LOG(LS_ERROR) << "sqlite3_step failed: " << sqlite3_errstr(error_code)
@@ -740,14 +726,71 @@ bool DatabaseSqlite::addHost(const base::ByteArray& keyHash)
             break;
         }
 
+        hosts_.emplace(keyHash, static_cast<base::HostId>(sqlite3_last_insert_rowid(db_)));
         result = true;
     }
     while (false);
 
-    sqlite3_finalize(statement);
     return result;
 }
 
+//--------------------------------------------------------------------------------------------------
+sqlite3_stmt* DatabaseSqlite::preparedStatement(Query query) const
+{
+    static_assert(std::size(kQueries) == static_cast<size_t>(Query::COUNT));
+
+    sqlite3_stmt*& statement = statements_[static_cast<size_t>(query)];
+    if (statement)
+        return statement;
+
+    int error_code = sqlite3_prepare_v3(db_,
+                                        kQueries[static_cast<size_t>(query)],
+                                        -1,
+                                        SQLITE_PREPARE_PERSISTENT,
+                                        &statement,
+                                        nullptr);
+    if (error_code != SQLITE_OK)
+    {
+        LOG(LS_ERROR) << "sqlite3_prepare_v3 failed: " << sqlite3_errstr(error_code)
+                      << " (" << error_code << ")";
+        statement = nullptr;
+        return nullptr;
+    }
+
+    return statement;
+}
+
+//--------------------------------------------------------------------------------------------------
+std::optional<std::vector<base::User>> DatabaseSqlite::readUsers() const
+{
+    sqlite3_stmt* statement = preparedStatement(Query::USER_LIST);
+    if (!statement)
+        return std::nullopt;
+
+    ScopedStatementReset statement_reset(statement);
+    std::vector<base::User> users;
+
+    for (;;)
+    {
+        int error_code = sqlite3_step(statement);
+        if (error_code == SQLITE_DONE)
+            break;
+
+        if (error_code != SQLITE_ROW)
+        {
+            LOG(LS_ERROR) << "sqlite3_step failed: " << sqlite3_errstr(error_code)
+                          << " (" << error_code << ")";
+            return std::nullopt;
+        }
+
+        std::optional<base::User> user = readUser(statement);
+        if (user.has_value())
+            users.emplace_back(std::move(*user));
+    }
+
+    return users;
+}
+
 //--------------------------------------------------------------------------------------------------
 // static
 std::filesystem::path DatabaseSqlite::databaseDirectory()
@@ -22,7 +22,10 @@
 #include "base/macros_magic.h"
 #include "router/database.h"
 
+#include <array>
 #include <filesystem>
+#include <map>
+#include <optional>
 
 #include <sqlite3.h>
 
@@ -35,6 +38,11 @@ public:
 
     static std::unique_ptr<DatabaseSqlite> create();
     static std::unique_ptr<DatabaseSqlite> open();
+
+    // Same as above, but for a database in |file_path| instead of the default location.
+    static std::unique_ptr<DatabaseSqlite> create(const std::filesystem::path& file_path);
+    static std::unique_ptr<DatabaseSqlite> open(const std::filesystem::path& file_path);
+
     static std::filesystem::path filePath();
 
     // Database implementation.
@@ -47,10 +55,35 @@ public:
     bool addHost(const base::ByteArray& key_hash) final;
 
 private:
+    enum class Query
+    {
+        USER_LIST,
+        ADD_USER,
+        MODIFY_USER,
+        REMOVE_USER,
+        HOST_ID,
+        ADD_HOST,
+        COUNT
+    };
+
     explicit DatabaseSqlite(sqlite3* db);
     static std::filesystem::path databaseDirectory();
 
+    // Returns the prepared statement for |query|. The statement is prepared on first use and
+    // kept until the connection is closed.
+    sqlite3_stmt* preparedStatement(Query query) const;
+
+    std::optional<std::vector<base::User>> readUsers() const;
+
     sqlite3* db_;
+    mutable std::array<sqlite3_stmt*, static_cast<size_t>(Query::COUNT)> statements_ {};
+
+    // Index of the users table by user name. It is loaded on the first search and cleared by any
+    // change of the table made through this connection.
+    std::optional<std::map<std::u16string, base::User, std::less<>>> users_;
+
+    // Host IDs by key hash. Hosts are never removed, so the entries remain valid.
+    mutable std::map<base::ByteArray, base::HostId> hosts_;
 
     DISALLOW_COPY_AND_ASSIGN(DatabaseSqlite);
 };
@@ -0,0 +1,242 @@
+//
+// Aspia Project
+// Copyright (C) 2016-2025 Dmitry Chapyshev <dmitry@aspia.ru>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "router/database_sqlite.h"
+
+#include "base/strings/string_number_conversions.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+
+namespace router {
+
+namespace {
+
+//--------------------------------------------------------------------------------------------------
+base::User testUser(std::u16string_view name, uint32_t sessions = 0)
+{
+    base::User user;
+    user.name = name;
+    user.group = "8192";
+    user.salt = { 1, 2, 3, 4 };
+    user.verifier = { 5, 6, 7, 8 };
+    user.sessions = sessions;
+    user.flags = base::User::ENABLED;
+    return user;
+}
+
+//--------------------------------------------------------------------------------------------------
+base::ByteArray testKeyHash(int number)
+{
+    base::ByteArray key_hash(32, 0);
+    for (size_t i = 0; i < sizeof(number); ++i)
+        key_hash[i] = static_cast<uint8_t>(number >> (i * 8));
+    return key_hash;
+}
+
+class DatabaseSqliteTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        dir_path_ = std::filesystem::temp_directory_path();
+        dir_path_.append("aspia_router_unittest_" +
+            std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+
+        file_path_ = dir_path_;
+        file_path_.append("router.db3");
+
+        db_ = DatabaseSqlite::create(file_path_);
+        ASSERT_NE(db_, nullptr);
+    }
+
+    void TearDown() override
+    {
+        db_.reset();
+
+        std::error_code ignored_code;
+        std::filesystem::remove_all(dir_path_, ignored_code);
+    }
+
+    // Returns the entry ID of the user with |name| from the user list.
+    int64_t entryId(std::u16string_view name)
+    {
+        for (const auto& user : db_->userList())
+        {
+            if (user.name == name)
+                return user.entry_id;
+        }
+
+        return 0;
+    }
+
+    std::filesystem::path dir_path_;
+    std::filesystem::path file_path_;
+    std::unique_ptr<DatabaseSqlite> db_;
+};
+
+} // namespace
+
+TEST_F(DatabaseSqliteTest, FindUserAfterAdd)
+{
+    // The first search loads the index of the empty table.
+    EXPECT_FALSE(db_->findUser(u"alice").isValid());
+
+    ASSERT_TRUE(db_->addUser(testUser(u"alice")));
+
+    base::User user = db_->findUser(u"alice");
+    ASSERT_TRUE(user.isValid());
+    EXPECT_EQ(user.name, u"alice");
+    EXPECT_NE(user.entry_id, 0);
+
+    EXPECT_FALSE(db_->findUser(u"bob").isValid());
+}
+
+TEST_F(DatabaseSqliteTest, FindUserAfterModify)
+{
+    ASSERT_TRUE(db_->addUser(testUser(u"alice", 1)));
+    ASSERT_EQ(db_->findUser(u"alice").sessions, 1u);
+
+    base::User user = testUser(u"alice2", 2);
+    user.entry_id = entryId(u"alice");
+    ASSERT_NE(user.entry_id, 0);
+    ASSERT_TRUE(db_->modifyUser(user));
+
+    // The old name is not found anymore and the new one has the new values.
+    EXPECT_FALSE(db_->findUser(u"alice").isValid());
+
+    base::User modified = db_->findUser(u"alice2");
+    ASSERT_TRUE(modified.isValid());
+    EXPECT_EQ(modified.entry_id, user.entry_id);
+    EXPECT_EQ(modified.sessions, 2u);
+}
+
+TEST_F(DatabaseSqliteTest, FindUserAfterRemove)
+{
+    ASSERT_TRUE(db_->addUser(testUser(u"alice")));
+    ASSERT_TRUE(db_->addUser(testUser(u"bob")));
+    ASSERT_TRUE(db_->findUser(u"alice").isValid());
+
+    ASSERT_TRUE(db_->removeUser(entryId(u"alice")));
+
+    EXPECT_FALSE(db_->findUser(u"alice").isValid());
+    EXPECT_TRUE(db_->findUser(u"bob").isValid());
+}
+
+TEST_F(DatabaseSqliteTest, FailedAddKeepsUsers)
+{
+    ASSERT_TRUE(db_->addUser(testUser(u"alice")));
+    ASSERT_TRUE(db_->findUser(u"alice").isValid());
+
+    // The name is unique.
+    EXPECT_FALSE(db_->addUser(testUser(u"alice")));
+
+    EXPECT_TRUE(db_->findUser(u"alice").isValid());
+    EXPECT_EQ(db_->userList().size(), 1u);
+}
+
+TEST_F(DatabaseSqliteTest, HostIdAfterAdd)
+{
+    base::ByteArray key_hash = testKeyHash(1);
+    base::HostId host_id = base::kInvalidHostId;
+
+    // A missing host is not remembered.
+    EXPECT_EQ(db_->hostId(key_hash, &host_id), Database::ErrorCode::NO_HOST_FOUND);
+    EXPECT_EQ(host_id, base::kInvalidHostId);
+
+    ASSERT_TRUE(db_->addHost(key_hash));
+
+    EXPECT_EQ(db_->hostId(key_hash, &host_id), Database::ErrorCode::SUCCESS);
+    EXPECT_NE(host_id, base::kInvalidHostId);
+
+    // A repeated lookup returns the same ID.
+    base::HostId cached_host_id = base::kInvalidHostId;
+    EXPECT_EQ(db_->hostId(key_hash, &cached_host_id), Database::ErrorCode::SUCCESS);
+    EXPECT_EQ(cached_host_id, host_id);
+
+    // The key is unique.
+    EXPECT_FALSE(db_->addHost(key_hash));
+    EXPECT_EQ(db_->hostId(key_hash, &cached_host_id), Database::ErrorCode::SUCCESS);
+    EXPECT_EQ(cached_host_id, host_id);
+}
+
+TEST_F(DatabaseSqliteTest, HostIdAddedByOtherConnection)
+{
+    base::ByteArray key_hash = testKeyHash(2);
+    base::HostId host_id = base::kInvalidHostId;
+
+    EXPECT_EQ(db_->hostId(key_hash, &host_id), Database::ErrorCode::NO_HOST_FOUND);
+
+    std::unique_ptr<DatabaseSqlite> other_db = DatabaseSqlite::open(file_path_);
+    ASSERT_NE(other_db, nullptr);
+    ASSERT_TRUE(other_db->addHost(key_hash));
+
+    base::HostId other_host_id = base::kInvalidHostId;
+    ASSERT_EQ(other_db->hostId(key_hash, &other_host_id), Database::ErrorCode::SUCCESS);
+
+    EXPECT_EQ(db_->hostId(key_hash, &host_id), Database::ErrorCode::SUCCESS);
+    EXPECT_EQ(host_id, other_host_id);
+}
+
+TEST_F(DatabaseSqliteTest, DISABLED_benchmark)
+{
+    static const int kUserCount = 1000;
+    static const int kHostCount = 1000;
+    static const int kLookupCount = 100000;
+
+    for (int i = 0; i < kUserCount; ++i)
+        ASSERT_TRUE(db_->addUser(testUser(u"user" + base::numberToString16(i))));
+
+    for (int i = 0; i < kHostCount; ++i)
+        ASSERT_TRUE(db_->addHost(testKeyHash(i)));
+
+    std::vector<std::u16string> names;
+    for (int i = 0; i < kUserCount; ++i)
+        names.emplace_back(u"user" + base::numberToString16(i));
+
+    auto start_time = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < kLookupCount; ++i)
+        ASSERT_TRUE(db_->findUser(names[i % kUserCount]).isValid());
+
+    auto user_time = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start_time);
+
+    std::vector<base::ByteArray> key_hashes;
+    for (int i = 0; i < kHostCount; ++i)
+        key_hashes.emplace_back(testKeyHash(i));
+
+    start_time = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < kLookupCount; ++i)
+    {
+        base::HostId host_id;
+        ASSERT_EQ(db_->hostId(key_hashes[i % kHostCount], &host_id),
+                  Database::ErrorCode::SUCCESS);
+    }
+
+    auto host_time = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start_time);
+
+    std::cout << kLookupCount << " user lookups: " << user_time.count() << " us" << std::endl;
+    std::cout << kLookupCount << " host lookups: " << host_time.count() << " us" << std::endl;
+}
+
+} // namespace router
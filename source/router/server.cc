@@ -21,6 +21,7 @@
 #include "base/logging.h"
 #include "base/stl_util.h"
 #include "base/task_runner.h"
+#include "base/crypto/crypto_worker_pool.h"
 #include "base/crypto/key_pair.h"
 #include "base/crypto/random.h"
 #include "base/files/base_paths.h"
@@ -35,10 +36,16 @@
 #include "router/settings.h"
 #include "router/user_list_db.h"
 
+#include <algorithm>
+
 namespace router {
 
 namespace {
 
+// Connections above this limit are closed until the running authentications are completed. This
+// keeps the router responsive when a large number of hosts reconnect at the same time.
+constexpr size_t kMaxPendingAuthentications = 256;
+
 //--------------------------------------------------------------------------------------------------
 const char* sessionTypeToString(proto::RouterSession session_type)
 {
@@ -187,6 +194,8 @@ bool Server::start()
     authenticator_manager_->setAnonymousAccess(
         base::ServerAuthenticator::AnonymousAccess::ENABLE,
         proto::ROUTER_SESSION_HOST | proto::ROUTER_SESSION_RELAY);
+    authenticator_manager_->setWorkerPool(std::make_shared<base::CryptoWorkerPool>());
+    authenticator_manager_->setMaxPendingChannels(kMaxPendingAuthentications);
 
     relay_key_pool_ = std::make_unique<SharedKeyPool>(this);
 
@@ -202,7 +211,20 @@ std::unique_ptr<proto::SessionList> Server::sessionList() const
 {
     std::unique_ptr<proto::SessionList> result = std::make_unique<proto::SessionList>();
 
-    for (const auto& session : sessions_)
+    // The map is unordered. Sessions are listed in the order of their IDs (that is, in the order
+    // they were started) so that the list does not change its order between calls.
+    std::vector<const Session*> sessions;
+    sessions.reserve(sessions_.size());
+
+    for (const auto& [session_id, session] : sessions_)
+        sessions.emplace_back(session.get());
+
+    std::sort(sessions.begin(), sessions.end(), [](const Session* first, const Session* second)
+    {
+        return first->sessionId() < second->sessionId();
+    });
+
+    for (const Session* session : sessions)
     {
         proto::Session* item = result->add_session();
 
@@ -221,7 +243,7 @@ std::unique_ptr<proto::SessionList> Server::sessionList() const
             {
                 proto::HostSessionData session_data;
 
-                for (const auto& host_id : static_cast<SessionHost*>(session.get())->hostIdList())
+                for (const auto& host_id : static_cast<const SessionHost*>(session)->hostIdList())
                     session_data.add_host_id(host_id);
 
                 item->set_session_data(session_data.SerializeAsString());
@@ -234,7 +256,7 @@ std::unique_ptr<proto::SessionList> Server::sessionList() const
                 session_data.set_pool_size(relay_key_pool_->countForRelay(session->sessionId()));
 
                 const std::optional<proto::RelayStat>& in_relay_stat =
-                    static_cast<SessionRelay*>(session.get())->relayStat();
+                    static_cast<const SessionRelay*>(session)->relayStat();
                 if (in_relay_stat.has_value())
                 {
                     proto::RelaySessionData::RelayStat* out_relay_stat =
@@ -261,20 +283,16 @@ std::unique_ptr<proto::SessionList> Server::sessionList() const
 //--------------------------------------------------------------------------------------------------
 bool Server::stopSession(Session::SessionId session_id)
 {
-    for (auto it = sessions_.begin(); it != sessions_.end(); ++it)
-    {
-        if (it->get()->sessionId() == session_id)
-        {
-            sessions_.erase(it);
-            return true;
-        }
-    }
+    auto it = sessions_.find(session_id);
+    if (it == sessions_.end())
+        return false;
 
-    return false;
+    removeSession(it);
+    return true;
 }
 
 //--------------------------------------------------------------------------------------------------
-void Server::onHostSessionWithId(SessionHost* session)
+void Server::onHostSessionWithId(SessionHost* session, base::HostId host_id)
 {
     if (!session)
     {
@@ -282,70 +300,60 @@ void Server::onHostSessionWithId(SessionHost* session)
         return;
     }
 
-    for (auto it = sessions_.begin(); it != sessions_.end();)
-    {
-        Session* other_session_ptr = it->get();
-
-        if (!other_session_ptr || other_session_ptr->sessionType() != proto::ROUTER_SESSION_HOST)
-        {
-            ++it;
-            continue;
-        }
+    auto result = host_sessions_.try_emplace(host_id, session);
+    if (result.second)
+        return;
 
-        SessionHost* other_session = reinterpret_cast<SessionHost*>(other_session_ptr);
-        if (other_session == session)
-        {
-            ++it;
-            continue;
-        }
+    SessionHost* other_session = result.first->second;
+    if (other_session == session)
+        return;
 
-        bool is_found = false;
+    LOG(LS_INFO) << "Detected previous connection with ID " << host_id;
 
-        for (const auto& host_id : session->hostIdList())
-        {
-            if (other_session->hasHostId(host_id))
-            {
-                LOG(LS_INFO) << "Detected previous connection with ID " << host_id;
+    auto it = sessions_.find(other_session->sessionId());
+    if (it != sessions_.end())
+        removeSession(it);
 
-                is_found = true;
-                break;
-            }
-        }
+    // The previous session is removed along with its IDs.
+    host_sessions_[host_id] = session;
+}
 
-        if (is_found)
-            it = sessions_.erase(it);
-        else
-            ++it;
-    }
+//--------------------------------------------------------------------------------------------------
+void Server::onHostSessionIdRemoved(SessionHost* session, base::HostId host_id)
+{
+    auto it = host_sessions_.find(host_id);
+    if (it != host_sessions_.end() && it->second == session)
+        host_sessions_.erase(it);
 }
 
 //--------------------------------------------------------------------------------------------------
 SessionHost* Server::hostSessionById(base::HostId host_id)
 {
-    for (auto it = sessions_.begin(); it != sessions_.end(); ++it)
-    {
-        Session* entry = it->get();
+    auto it = host_sessions_.find(host_id);
+    if (it == host_sessions_.end())
+        return nullptr;
 
-        if (entry->sessionType() == proto::ROUTER_SESSION_HOST &&
-            static_cast<SessionHost*>(entry)->hasHostId(host_id))
-        {
-            return static_cast<SessionHost*>(entry);
-        }
-    }
+    return it->second;
+}
+
+//--------------------------------------------------------------------------------------------------
+SessionRelay* Server::relaySessionById(Session::SessionId session_id)
+{
+    Session* session = sessionById(session_id);
+    if (!session || session->sessionType() != proto::ROUTER_SESSION_RELAY)
+        return nullptr;
 
-    return nullptr;
+    return static_cast<SessionRelay*>(session);
 }
 
 //--------------------------------------------------------------------------------------------------
 Session* Server::sessionById(Session::SessionId session_id)
 {
-    for (auto& session : sessions_)
-    {
-        if (session->sessionId() == session_id)
-            return session.get();
-    }
+    auto it = sessions_.find(session_id);
+    if (it == sessions_.end())
+        return nullptr;
 
-    return nullptr;
+    return it->second.get();
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -365,12 +373,9 @@ void Server::onNewConnection(std::unique_ptr<base::TcpChannel> channel)
 //--------------------------------------------------------------------------------------------------
 void Server::onPoolKeyUsed(Session::SessionId session_id, uint32_t key_id)
 {
-    for (const auto& session : sessions_)
-    {
-        SessionRelay* relay_session = static_cast<SessionRelay*>(session.get());
-        if (relay_session->sessionId() == session_id)
-            relay_session->sendKeyUsed(key_id);
-    }
+    SessionRelay* relay_session = relaySessionById(session_id);
+    if (relay_session)
+        relay_session->sendKeyUsed(key_id);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -452,25 +457,37 @@ void Server::onNewSession(base::ServerAuthenticatorManager::SessionInfo&& sessio
     session->setArchitecture(session_info.architecture);
     session->setUserName(session_info.user_name);
 
-    sessions_.emplace_back(std::move(session));
-    sessions_.back()->start(this);
+    Session* session_ptr = session.get();
+    sessions_.emplace(session_ptr->sessionId(), std::move(session));
+    session_ptr->start(this);
 }
 
 //--------------------------------------------------------------------------------------------------
 void Server::onSessionFinished(Session::SessionId session_id, proto::RouterSession /* session_type */)
 {
-    for (auto it = sessions_.begin(); it != sessions_.end(); ++it)
+    auto it = sessions_.find(session_id);
+    if (it == sessions_.end())
+        return;
+
+    // Session will be destroyed after completion of the current call.
+    task_runner_->deleteSoon(removeSession(it));
+}
+
+//--------------------------------------------------------------------------------------------------
+std::unique_ptr<Session> Server::removeSession(SessionMap::iterator it)
+{
+    std::unique_ptr<Session> session = std::move(it->second);
+    sessions_.erase(it);
+
+    if (session->sessionType() == proto::ROUTER_SESSION_HOST)
     {
-        if (it->get()->sessionId() == session_id)
-        {
-            // Session will be destroyed after completion of the current call.
-            task_runner_->deleteSoon(std::move(*it));
+        SessionHost* host_session = static_cast<SessionHost*>(session.get());
 
-            // Delete a session from the list.
-            sessions_.erase(it);
-            break;
-        }
+        for (const auto& host_id : host_session->hostIdList())
+            onHostSessionIdRemoved(host_session, host_id);
     }
+
+    return session;
 }
 
 } // namespace router
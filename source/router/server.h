@@ -27,6 +27,8 @@
 #include "router/session.h"
 #include "router/shared_key_pool.h"
 
+#include <unordered_map>
+
 namespace router {
 
 class DatabaseFactory;
@@ -47,9 +49,13 @@ public:
 
     std::unique_ptr<proto::SessionList> sessionList() const;
     bool stopSession(Session::SessionId session_id);
-    void onHostSessionWithId(SessionHost* session);
+
+    // Called by the host session when an ID is added to or removed from its list.
+    void onHostSessionWithId(SessionHost* session, base::HostId host_id);
+    void onHostSessionIdRemoved(SessionHost* session, base::HostId host_id);
 
     SessionHost* hostSessionById(base::HostId host_id);
+    SessionRelay* relaySessionById(Session::SessionId session_id);
     Session* sessionById(Session::SessionId session_id);
 
 protected:
@@ -67,12 +73,21 @@ protected:
                            proto::RouterSession session_type) final;
 
 private:
+    using SessionMap = std::unordered_map<Session::SessionId, std::unique_ptr<Session>>;
+
+    std::unique_ptr<Session> removeSession(SessionMap::iterator it);
+
     std::shared_ptr<base::TaskRunner> task_runner_;
     base::local_shared_ptr<DatabaseFactory> database_factory_;
     std::unique_ptr<base::TcpServer> server_;
     std::unique_ptr<base::ServerAuthenticatorManager> authenticator_manager_;
     std::unique_ptr<SharedKeyPool> relay_key_pool_;
-    std::vector<std::unique_ptr<Session>> sessions_;
+
+    // All sessions by session ID.
+    SessionMap sessions_;
+
+    // Host sessions by host ID. Each host ID belongs to only one session.
+    std::unordered_map<base::HostId, SessionHost*> host_sessions_;
 
     std::vector<std::u16string> client_white_list_;
     std::vector<std::u16string> host_white_list_;
@@ -183,8 +183,7 @@ void SessionAdmin::doSessionRequest(const proto::SessionRequest& request)
 //--------------------------------------------------------------------------------------------------
 void SessionAdmin::doPeerConnectionRequest(const proto::PeerConnectionRequest& request)
 {
-    SessionRelay* relay_session =
-        dynamic_cast<SessionRelay*>(server().sessionById(request.relay_session_id()));
+    SessionRelay* relay_session = server().relaySessionById(request.relay_session_id());
     if (!relay_session)
     {
         LOG(LS_ERROR) << "Relay with id " << request.relay_session_id() << " not found";
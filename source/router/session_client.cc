@@ -28,6 +28,13 @@
 
 namespace router {
 
+namespace {
+
+// Maximum number of hosts in one status request. Hosts above the limit are not checked.
+constexpr int kMaxHostStatusListSize = 1000;
+
+} // namespace
+
 //--------------------------------------------------------------------------------------------------
 SessionClient::SessionClient()
     : Session(proto::ROUTER_SESSION_CLIENT)
@@ -65,6 +72,10 @@ void SessionClient::onSessionMessageReceived(uint8_t /* channel_id */, const bas
     {
         readCheckHostStatus(message->check_host_status());
     }
+    else if (message->has_check_host_status_list())
+    {
+        readCheckHostStatusList(message->check_host_status_list());
+    }
     else
     {
         LOG(LS_ERROR) << "Unhandled message from client";
@@ -103,8 +114,7 @@ void SessionClient::readConnectionRequest(const proto::ConnectionRequest& reques
         }
         else
         {
-            SessionRelay* relay = static_cast<SessionRelay*>(
-                server().sessionById(credentials->session_id));
+            SessionRelay* relay = server().relaySessionById(credentials->session_id);
             if (!relay)
             {
                 LOG(LS_ERROR) << "No relay with session id " << credentials->session_id;
@@ -171,4 +181,38 @@ void SessionClient::readCheckHostStatus(const proto::CheckHostStatus& check_host
     sendMessage(proto::ROUTER_CHANNEL_ID_SESSION, *message);
 }
 
+//--------------------------------------------------------------------------------------------------
+void SessionClient::readCheckHostStatusList(
+    const proto::CheckHostStatusList& check_host_status_list)
+{
+    int count = check_host_status_list.host_id_size();
+    if (count > kMaxHostStatusListSize)
+    {
+        LOG(LS_ERROR) << "Too many hosts in status request: " << count
+                      << " (only the first " << kMaxHostStatusListSize << " are checked)";
+        count = kMaxHostStatusListSize;
+    }
+
+    std::unique_ptr<proto::RouterToPeer> message = std::make_unique<proto::RouterToPeer>();
+    proto::HostStatusList* host_status_list = message->mutable_host_status_list();
+    int online_count = 0;
+
+    for (int i = 0; i < count; ++i)
+    {
+        if (server().hostSessionById(check_host_status_list.host_id(i)))
+        {
+            host_status_list->add_status(proto::HostStatus::STATUS_ONLINE);
+            ++online_count;
+        }
+        else
+        {
+            host_status_list->add_status(proto::HostStatus::STATUS_OFFLINE);
+        }
+    }
+
+    LOG(LS_INFO) << "Sending host status list (hosts: " << count << " online: " << online_count
+                 << ")";
+    sendMessage(proto::ROUTER_CHANNEL_ID_SESSION, *message);
+}
+
 } // namespace router
@@ -78,6 +78,7 @@ void SessionRelay::onSessionMessageReceived(uint8_t /* channel_id */, const base
     }
     else if (incoming_message_->has_relay_stat())
     {
+        readRelayStat(incoming_message_->relay_stat());
         relay_stat_ = std::move(*incoming_message_->mutable_relay_stat());
     }
     else
@@ -104,6 +105,47 @@ void SessionRelay::readKeyPool(const proto::RelayKeyPool& key_pool)
 
     for (int i = 0; i < key_pool.key_size(); ++i)
         pool.addKey(sessionId(), key_pool.key(i));
+
+    pool.setRelayWeight(sessionId(), key_pool.weight());
+}
+
+//--------------------------------------------------------------------------------------------------
+void SessionRelay::readRelayStat(const proto::RelayStat& relay_stat)
+{
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    std::map<uint64_t, int64_t> session_bytes;
+    int64_t transferred = 0;
+
+    for (int i = 0; i < relay_stat.peer_connection_size(); ++i)
+    {
+        const proto::PeerConnection& connection = relay_stat.peer_connection(i);
+        int64_t bytes = connection.bytes_transferred();
+
+        // New sessions are counted from their start.
+        auto previous = session_bytes_.find(connection.session_id());
+        if (previous != session_bytes_.end())
+            transferred += std::max(bytes - previous->second, int64_t(0));
+        else
+            transferred += bytes;
+
+        session_bytes.emplace(connection.session_id(), bytes);
+    }
+
+    int64_t bytes_per_second = 0;
+
+    if (relay_stat_.has_value())
+    {
+        int64_t elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            now - relay_stat_time_).count();
+        if (elapsed_ms > 0)
+            bytes_per_second = transferred * 1000 / elapsed_ms;
+    }
+
+    relay_stat_time_ = now;
+    session_bytes_ = std::move(session_bytes);
+
+    relayKeyPool().setRelayLoad(
+        sessionId(), static_cast<size_t>(relay_stat.peer_connection_size()), bytes_per_second);
 }
 
 } // namespace router
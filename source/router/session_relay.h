@@ -23,6 +23,9 @@
 #include "router/session.h"
 #include "router/shared_key_pool.h"
 
+#include <chrono>
+#include <map>
+
 namespace router {
 
 class SessionRelay final : public Session
@@ -46,10 +49,15 @@ protected:
 
 private:
     void readKeyPool(const proto::RelayKeyPool& key_pool);
+    void readRelayStat(const proto::RelayStat& relay_stat);
 
     std::optional<PeerData> peer_data_;
     std::optional<proto::RelayStat> relay_stat_;
 
+    // Time of the last statistics and the number of bytes transferred by each session in it.
+    std::chrono::steady_clock::time_point relay_stat_time_;
+    std::map<uint64_t, int64_t> session_bytes_;
+
     std::unique_ptr<proto::RelayToRouter> incoming_message_;
     std::unique_ptr<proto::RouterToRelay> outgoing_message_;
 
@@ -20,10 +20,19 @@
 
 #include "base/logging.h"
 
+#include <algorithm>
 #include <map>
 
 namespace router {
 
+namespace {
+
+// Traffic that is considered equal to one session when the load of relays is compared (about
+// 2 Mbit/s, a typical desktop session).
+constexpr int64_t kBytesPerSecondPerSession = 256 * 1024;
+
+} // namespace
+
 class SharedKeyPool::Impl
 {
 public:
@@ -33,6 +42,9 @@ public:
     void dettach();
 
     void addKey(Session::SessionId session_id, const proto::RelayKey& key);
+    void setRelayLoad(Session::SessionId session_id, size_t active_sessions,
+                      int64_t bytes_per_second);
+    void setRelayWeight(Session::SessionId session_id, uint32_t weight);
     std::optional<Credentials> takeCredentials();
     void removeKeysForRelay(Session::SessionId session_id);
     void clear();
@@ -43,7 +55,27 @@ public:
 private:
     using Keys = std::vector<proto::RelayKey>;
 
-    std::map<Session::SessionId, Keys> pool_;
+    struct Relay
+    {
+        Keys keys;
+        uint32_t weight = 1;
+
+        // The relay creates one key for each session it can accept, so the largest number of
+        // unused keys is its capacity.
+        size_t capacity = 0;
+
+        // Load from the last statistics. Relays with disabled statistics never send it.
+        bool has_load = false;
+        size_t active_sessions = 0;
+        int64_t bytes_per_second = 0;
+
+        // Keys taken after the last statistics. These sessions are not counted in the statistics.
+        size_t taken_since_load = 0;
+    };
+
+    static double relayLoad(const Relay& relay);
+
+    std::map<Session::SessionId, Relay> relays_;
     Delegate* delegate_;
 
     DISALLOW_COPY_AND_ASSIGN(Impl);
@@ -65,66 +97,82 @@ void SharedKeyPool::Impl::dettach()
 //--------------------------------------------------------------------------------------------------
 void SharedKeyPool::Impl::addKey(Session::SessionId session_id, const proto::RelayKey& key)
 {
-    auto relay = pool_.find(session_id);
-    if (relay == pool_.end())
+    auto relay = relays_.find(session_id);
+    if (relay == relays_.end())
     {
         LOG(LS_INFO) << "Host not found in pool. It will be added";
-        relay = pool_.emplace(session_id, Keys()).first;
+        relay = relays_.emplace(session_id, Relay()).first;
     }
 
     LOG(LS_INFO) << "Added key with id " << key.key_id() << " for host '" << session_id << "'";
-    relay->second.emplace_back(key);
+    relay->second.keys.emplace_back(key);
+    relay->second.capacity = std::max(relay->second.capacity, relay->second.keys.size());
+}
+
+//--------------------------------------------------------------------------------------------------
+void SharedKeyPool::Impl::setRelayLoad(
+    Session::SessionId session_id, size_t active_sessions, int64_t bytes_per_second)
+{
+    Relay& relay = relays_[session_id];
+
+    relay.has_load = true;
+    relay.active_sessions = active_sessions;
+    relay.bytes_per_second = bytes_per_second;
+    relay.taken_since_load = 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+void SharedKeyPool::Impl::setRelayWeight(Session::SessionId session_id, uint32_t weight)
+{
+    relays_[session_id].weight = std::max(weight, 1U);
 }
 
 //--------------------------------------------------------------------------------------------------
 std::optional<SharedKeyPool::Credentials> SharedKeyPool::Impl::takeCredentials()
 {
-    if (pool_.empty())
+    auto preffered_relay = relays_.end();
+    double min_load = 0;
+
+    for (auto it = relays_.begin(); it != relays_.end(); ++it)
     {
-        LOG(LS_ERROR) << "Empty key pool";
-        return std::nullopt;
-    }
+        const Relay& relay = it->second;
+        if (relay.keys.empty())
+            continue;
 
-    auto preffered_relay = pool_.end();
-    size_t max_count = 0;
+        double load = relayLoad(relay);
 
-    for (auto it = pool_.begin(); it != pool_.end(); ++it)
-    {
-        size_t count = it->second.size();
-        if (count > max_count)
+        // With equal load, the relay with more unused keys is preferred.
+        if (preffered_relay == relays_.end() || load < min_load ||
+            (load == min_load && relay.keys.size() > preffered_relay->second.keys.size()))
         {
             preffered_relay = it;
-            max_count = count;
+            min_load = load;
         }
     }
 
-    if (preffered_relay == pool_.end())
+    if (preffered_relay == relays_.end())
     {
         LOG(LS_ERROR) << "Empty key pool";
         return std::nullopt;
     }
 
-    LOG(LS_INFO) << "Preffered relay: " << preffered_relay->first;
+    Relay& relay = preffered_relay->second;
 
-    std::vector<proto::RelayKey>& keys = preffered_relay->second;
-    if (keys.empty())
-    {
-        LOG(LS_ERROR) << "Empty key pool for relay";
-        return std::nullopt;
-    }
+    LOG(LS_INFO) << "Preffered relay: " << preffered_relay->first << " (load: " << min_load
+                 << " sessions: " << relay.active_sessions << "+" << relay.taken_since_load
+                 << " bytes/s: " << relay.bytes_per_second << " weight: " << relay.weight
+                 << " keys: " << relay.keys.size() << "/" << relay.capacity << ")";
 
     Credentials credentials;
     credentials.session_id = preffered_relay->first;
-    credentials.key = std::move(keys.back());
+    credentials.key = std::move(relay.keys.back());
 
     // Removing the key from the pool.
-    keys.pop_back();
+    relay.keys.pop_back();
+    ++relay.taken_since_load;
 
-    if (keys.empty())
-    {
-        LOG(LS_INFO) << "Last key in the pool for relay. The relay will be removed from the pool";
-        pool_.erase(preffered_relay->first);
-    }
+    if (relay.keys.empty())
+        LOG(LS_INFO) << "Last key in the pool for relay";
 
     if (delegate_)
         delegate_->onPoolKeyUsed(credentials.session_id, credentials.key.key_id());
@@ -136,24 +184,24 @@ std::optional<SharedKeyPool::Credentials> SharedKeyPool::Impl::takeCredentials()
 void SharedKeyPool::Impl::removeKeysForRelay(Session::SessionId session_id)
 {
     LOG(LS_INFO) << "All keys for relay '" << session_id << "' removed";
-    pool_.erase(session_id);
+    relays_.erase(session_id);
 }
 
 //--------------------------------------------------------------------------------------------------
 void SharedKeyPool::Impl::clear()
 {
     LOG(LS_INFO) << "Key pool cleared";
-    pool_.clear();
+    relays_.clear();
 }
 
 //--------------------------------------------------------------------------------------------------
 size_t SharedKeyPool::Impl::countForRelay(Session::SessionId session_id) const
 {
-    auto result = pool_.find(session_id);
-    if (result == pool_.end())
+    auto result = relays_.find(session_id);
+    if (result == relays_.end())
         return 0;
 
-    return result->second.size();
+    return result->second.keys.size();
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -161,8 +209,8 @@ size_t SharedKeyPool::Impl::count() const
 {
     size_t result = 0;
 
-    for (const auto& relay : pool_)
-        result += relay.second.size();
+    for (const auto& relay : relays_)
+        result += relay.second.keys.size();
 
     return result;
 }
@@ -170,7 +218,33 @@ size_t SharedKeyPool::Impl::count() const
 //--------------------------------------------------------------------------------------------------
 bool SharedKeyPool::Impl::isEmpty() const
 {
-    return pool_.empty();
+    for (const auto& relay : relays_)
+    {
+        if (!relay.second.keys.empty())
+            return false;
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+// static
+double SharedKeyPool::Impl::relayLoad(const Relay& relay)
+{
+    double sessions;
+
+    if (relay.has_load)
+    {
+        sessions = static_cast<double>(relay.active_sessions + relay.taken_since_load) +
+            static_cast<double>(relay.bytes_per_second) / kBytesPerSecondPerSession;
+    }
+    else
+    {
+        // Without statistics, every key missing from the pool is considered a running session.
+        sessions = static_cast<double>(relay.capacity - relay.keys.size());
+    }
+
+    return sessions / relay.weight;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -208,6 +282,19 @@ void SharedKeyPool::addKey(Session::SessionId session_id, const proto::RelayKey&
     impl_->addKey(session_id, key);
 }
 
+//--------------------------------------------------------------------------------------------------
+void SharedKeyPool::setRelayLoad(
+    Session::SessionId session_id, size_t active_sessions, int64_t bytes_per_second)
+{
+    impl_->setRelayLoad(session_id, active_sessions, bytes_per_second);
+}
+
+//--------------------------------------------------------------------------------------------------
+void SharedKeyPool::setRelayWeight(Session::SessionId session_id, uint32_t weight)
+{
+    impl_->setRelayWeight(session_id, weight);
+}
+
 //--------------------------------------------------------------------------------------------------
 std::optional<SharedKeyPool::Credentials> SharedKeyPool::takeCredentials()
 {
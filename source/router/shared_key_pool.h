@@ -53,6 +53,16 @@ public:
     };
 
     void addKey(Session::SessionId session_id, const proto::RelayKey& key);
+
+    // Updates the load of the relay from its statistics.
+    void setRelayLoad(Session::SessionId session_id, size_t active_sessions,
+                      int64_t bytes_per_second);
+
+    // Sets the relative capacity of the relay. A relay with weight 2 gets twice as many sessions
+    // as a relay with weight 1.
+    void setRelayWeight(Session::SessionId session_id, uint32_t weight);
+
+    // Takes a key of the relay with the smallest load per unit of weight.
     std::optional<Credentials> takeCredentials();
     void removeKeysForRelay(Session::SessionId session_id);
     void clear();